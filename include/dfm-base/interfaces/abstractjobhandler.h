@@ -140,6 +140,9 @@ public:
         kCompleteCustomInfosKey = 17,
         kJobHandlePointer = 18,
         kWorkerPointer = 19,
+        kCheckSumAlgorithmKey = 20,   // the checksum algorithm of integrity checking
+        kCheckSumSpeedKey = 21,   // the bytes per second of integrity checking
+        kJobQueuePositionKey = 22,   // the position in the queue of the devices, 0 if the job is running
     };
     Q_ENUM(NotifyInfoKey)
     enum class NotifyType : uint8_t {
@@ -65,6 +65,16 @@ public:
                       + "(" + fmt + ");");
     }
 
+    // Create index
+    template<typename T>
+    bool createIndex(const QString &indexName, const QStringList &fields)
+    {
+        static_assert(std::is_base_of<QObject, T>::value, "Template type T must be derived QObject");
+        Q_ASSERT(!indexName.isEmpty() && !fields.isEmpty());
+        return excute("CREATE INDEX IF NOT EXISTS " + indexName + " ON " + SqliteHelper::tableName<T>()
+                      + "(" + fields.join(",") + ");");
+    }
+
     // Drop table
     template<typename T>
     bool dropTable()
@@ -170,6 +180,11 @@ public:
         return SqliteHelper::excute(databaseName, sql, &lastExcutedSql, fn);
     }
 
+    inline bool excutePrepared(const QString &sql, const QVariantList &bindValues, std::function<void(QSqlQuery *)> fn = nullptr)
+    {
+        return SqliteHelper::excutePrepared(databaseName, sql, bindValues, &lastExcutedSql, fn);
+    }
+
     inline QString lastQuery() const
     {
         return lastExcutedSql;
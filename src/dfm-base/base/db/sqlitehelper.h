@@ -465,6 +465,34 @@ public:
 
         return ret;
     }
+
+    // same as excute, but the values are bound to the `?` placeholders of `sql` in order
+    static inline bool excutePrepared(const QString &databaseName, const QString &sql, const QVariantList &bindValues,
+                                      QString *lastQuery = nullptr, std::function<void(QSqlQuery *)> fn = nullptr)
+    {
+        QSqlDatabase db { SqliteConnectionPool::instance().openConnection(databaseName) };
+        QSqlQuery query { db };
+        bool ret { query.prepare(sql) };
+        if (ret) {
+            for (int i = 0; i != bindValues.size(); ++i)
+                query.bindValue(i, bindValues.at(i));
+            ret = query.exec();
+        }
+
+        if (lastQuery) {
+            *lastQuery = query.lastQuery();
+            qCInfo(logDFMBase).noquote() << "SQL Query:" << *lastQuery << bindValues;
+        }
+        if (!ret) {
+            qCWarning(logDFMBase).noquote() << "SQL Error: " << query.lastError().text().trimmed();
+            return false;
+        }
+
+        if (fn)
+            fn(&query);
+
+        return ret;
+    }
 };
 
 DFMBASE_END_NAMESPACE
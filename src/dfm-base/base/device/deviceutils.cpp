@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "deviceutils.h"
+#include "private/mounttablecache.h"
 
 #include <dfm-base/dfm_global_defines.h>
 #include <dfm-base/base/application/application.h>
@@ -24,7 +25,6 @@
 #include <QMutex>
 #include <QSettings>
 
-#include <libmount.h>
 #include <fstab.h>
 #include <sys/stat.h>
 
@@ -48,24 +48,11 @@ QString DeviceUtils::getBlockDeviceId(const QString &deviceDesc)
  */
 QString DeviceUtils::getMountInfo(const QString &in, bool lookForMpt)
 {
-    libmnt_table *tab { mnt_new_table() };
-    if (!tab)
-        return {};
-    FinallyUtil finally { [tab]() { if (tab) mnt_free_table(tab); } };
-    if (mnt_table_parse_mtab(tab, nullptr) != 0) {
-        qCWarning(logDFMBase) << "Invalid mnt_table_parse_mtab call";
-        return {};
-    }
-
-    auto query = lookForMpt ? mnt_table_find_source : mnt_table_find_target;
-    auto get = lookForMpt ? mnt_fs_get_target : mnt_fs_get_source;
-    std::string stdPath { in.toStdString() };
-    auto fs = query(tab, stdPath.c_str(), MNT_ITER_BACKWARD);
-    if (fs)
-        return { get(fs) };
-
-    qCWarning(logDFMBase) << "Invalid libmnt_fs*";
-    return {};
+    MountTableCache *table = MountTableCache::instance();
+    const QString &ret = lookForMpt ? table->targetOfSource(in) : table->sourceOfTarget(in);
+    if (ret.isEmpty())
+        qCWarning(logDFMBase) << "Invalid libmnt_fs*";
+    return ret;
 }
 
 QUrl DeviceUtils::getSambaFileUriFromNative(const QUrl &url)
@@ -259,10 +246,8 @@ bool DeviceUtils::isMtpFile(const QUrl &url)
         return false;
 
     const QString &path = url.toLocalFile();
-    static const QString gvfsMatch { R"(^/run/user/\d+/gvfs/mtp:host|^/root/.gvfs/mtp:host)" };
-    QRegularExpression re { gvfsMatch };
-    QRegularExpressionMatch match { re.match(path) };
-    return match.hasMatch();
+    static const QRegularExpression gvfsMatch { R"(^/run/user/\d+/gvfs/mtp:host|^/root/.gvfs/mtp:host)" };
+    return gvfsMatch.match(path).hasMatch();
 }
 
 bool DeviceUtils::supportDfmioCopyDevice(const QUrl &url)
@@ -571,11 +556,9 @@ bool DeviceUtils::isLowSpeedDevice(const QUrl &url)
         return false;
 
     const QString &path = url.toLocalFile();
-    static const QString lowSpeedMountpoint { "(^/run/user/\\d+/gvfs/|^/root/.gvfs/|^/media/[\\s\\S]*/smbmounts)" };
+    static const QRegularExpression lowSpeedMountpoint { "(^/run/user/\\d+/gvfs/|^/root/.gvfs/|^/media/[\\s\\S]*/smbmounts)" };
     // TODO(xust) /media/$USER/smbmounts might be changed in the future.
-    QRegularExpression re { lowSpeedMountpoint };
-    QRegularExpressionMatch match { re.match(path) };
-    return match.hasMatch();
+    return lowSpeedMountpoint.match(path).hasMatch();
 }
 
 /*!
@@ -586,36 +569,23 @@ bool DeviceUtils::isLowSpeedDevice(const QUrl &url)
  */
 QString DeviceUtils::getLongestMountRootPath(const QString &filePath)
 {
-    libmnt_table *tab { mnt_new_table() };
-    libmnt_iter *iter { mnt_new_iter(MNT_ITER_BACKWARD) };
-
-    FinallyUtil release([&] {
-        if (tab) mnt_free_table(tab);
-        if (iter) mnt_free_iter(iter);
-    });
-
-    int ret = mnt_table_parse_mtab(tab, nullptr);
-    if (ret != 0)
-        return "/";
-
-    QStringList mpts;
-    libmnt_fs *fs = nullptr;
-    while (mnt_table_next_fs(tab, iter, &fs) == 0) {
-        if (!fs)
-            continue;
-
-        const QString &target = mnt_fs_get_target(fs);
-        mpts.append(target == "/" ? "/" : target + "/");
-    }
-    std::sort(mpts.begin(), mpts.end(), [](const QString &a, const QString &b) { return a.length() > b.length(); });
+    return MountTableCache::instance()->longestMountRoot(filePath);
+}
 
-    QString path = filePath;
-    if (!path.endsWith("/"))
-        path.append("/");
+/*!
+ * \brief DeviceUtils::getMountSource: get the source of the mount which `url` is on
+ * return `/dev/sda1` for `/home/helloworld.txt`, eg.
+ * \param url
+ * \return
+ */
+QString DeviceUtils::getMountSource(const QUrl &url)
+{
+    if (!url.isLocalFile())
+        return DFMIO::DFMUtils::deviceNameFromUrl(url);
 
-    auto found = std::find_if(mpts.cbegin(), mpts.cend(), [path](const QString &mpt) { return path.startsWith(mpt); });
-    return found != mpts.cend() ? *found : "/";
+    return MountTableCache::instance()->mountSource(url.path());
 }
+
 QString DeviceUtils::fileSystemType(const QUrl &url)
 {
     return DFMIO::DFMUtils::fsTypeFromUrl(url);
@@ -695,34 +665,18 @@ bool DeviceUtils::isSystemDisk(const QVariantMap &devInfo)
 bool DeviceUtils::findDlnfsPath(const QString &target, Compare func)
 {
     Q_ASSERT(func);
-    libmnt_table *tab { mnt_new_table() };
-    libmnt_iter *iter = mnt_new_iter(MNT_ITER_BACKWARD);
-
-    FinallyUtil finally([=] {
-        if (tab) mnt_free_table(tab);
-        if (iter) mnt_free_iter(iter);
-    });
-    Q_UNUSED(finally);
-
     auto unifyPath = [](const QString &path) {
         return path.endsWith("/") ? path : path + "/";
     };
 
-    int ret = mnt_table_parse_mtab(tab, nullptr);
-    if (ret != 0) {
-        qCWarning(logDFMBase) << "device: cannot parse mtab" << ret;
+    const QStringList &mpts = MountTableCache::instance()->dlnfsMountRoots();
+    if (mpts.isEmpty())
         return false;
-    }
 
-    libmnt_fs *fs = nullptr;
-    while (mnt_table_next_fs(tab, iter, &fs) == 0) {
-        if (!fs)
-            continue;
-        if (strcmp("dlnfs", mnt_fs_get_source(fs)) == 0) {
-            QString mpt = unifyPath(mnt_fs_get_target(fs));
-            if (func(unifyPath(target), mpt))
-                return true;
-        }
+    const QString &path = unifyPath(target);
+    for (auto it = mpts.crbegin(); it != mpts.crend(); ++it) {
+        if (func(path, *it))
+            return true;
     }
 
     return false;
@@ -730,7 +684,18 @@ bool DeviceUtils::findDlnfsPath(const QString &target, Compare func)
 
 bool DeviceUtils::hasMatch(const QString &txt, const QString &rex)
 {
-    QRegularExpression re(rex);
-    QRegularExpressionMatch match = re.match(txt);
-    return match.hasMatch();
+    // keep the compiled expressions, the patterns are a few constants.
+    static QMutex mutex;
+    static QHash<QString, QRegularExpression> compiled;
+
+    QRegularExpression re;
+    {
+        QMutexLocker lk(&mutex);
+        auto itor = compiled.find(rex);
+        if (itor == compiled.end())
+            itor = compiled.insert(rex, QRegularExpression(rex));
+        re = itor.value();
+    }
+
+    return re.match(txt).hasMatch();
 }
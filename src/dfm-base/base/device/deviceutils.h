@@ -73,6 +73,7 @@ public:
     static bool isLowSpeedDevice(const QUrl &url);
 
     static QString getLongestMountRootPath(const QString &filePath);
+    static QString getMountSource(const QUrl &url);
 
     static QString fileSystemType(const QUrl &url);
     static qint64 deviceBytesFree(const QUrl &url);
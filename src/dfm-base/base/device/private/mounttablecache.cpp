@@ -0,0 +1,274 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mounttablecache.h"
+
+#include <dfm-base/utils/finallyutil.h>
+
+#include <QDebug>
+
+#include <algorithm>
+
+#include <stdlib.h>
+
+#include <fcntl.h>
+#include <libmount.h>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace dfmbase;
+
+Q_GLOBAL_STATIC(MountTableCache, globalMountTableCache)
+
+namespace {
+constexpr char kMountInfoPath[] { "/proc/self/mountinfo" };
+constexpr char kDlnfsSource[] { "dlnfs" };
+
+inline bool componentLess(const QPair<QString, int> &child, const QStringRef &name)
+{
+    return QStringRef::compare(name, child.first) > 0;
+}
+}
+
+MountTableCache *MountTableCache::instance()
+{
+    return globalMountTableCache;
+}
+
+MountTableCache::MountTableCache()
+{
+    mountInfoFd = ::open(kMountInfoPath, O_RDONLY | O_CLOEXEC);
+    if (mountInfoFd < 0)
+        qCWarning(logDFMBase) << "device: cannot watch" << kMountInfoPath << ", mount table is parsed on every query";
+}
+
+MountTableCache::~MountTableCache()
+{
+    if (mountInfoFd >= 0)
+        ::close(mountInfoFd);
+}
+
+/*!
+ * \brief return the mount root of \a path, it ends with '/', e.g. `/home/` for `/home/helloworld.txt`.
+ */
+QString MountTableCache::longestMountRoot(const QString &path)
+{
+    refreshIfChanged();
+
+    QReadLocker lk(&lock);
+    const int idx = findLongest(path);
+    return idx >= 0 ? entries.at(idx).root : QStringLiteral("/");
+}
+
+QString MountTableCache::mountSource(const QString &path)
+{
+    refreshIfChanged();
+
+    QReadLocker lk(&lock);
+    const int idx = findLongest(path);
+    return idx >= 0 ? entries.at(idx).source : QString();
+}
+
+QString MountTableCache::targetOfSource(const QString &source)
+{
+    refreshIfChanged();
+
+    // /dev/mapper/xxx and /dev/dm-N are the same device
+    const QString &canonical = canonicalSource(source);
+    // the latest mount wins, as libmount MNT_ITER_BACKWARD does.
+    QReadLocker lk(&lock);
+    for (int i = entries.size() - 1; i >= 0; --i) {
+        const MountEntry &entry = entries.at(i);
+        if (entry.source == source || entry.canonicalSource == canonical)
+            return entry.target;
+    }
+    return QString();
+}
+
+QString MountTableCache::sourceOfTarget(const QString &target)
+{
+    refreshIfChanged();
+
+    QReadLocker lk(&lock);
+    const int idx = findLongest(target);
+    if (idx < 0)
+        return QString();
+
+    const MountEntry &entry = entries.at(idx);
+    if (target == entry.target || target == entry.root)
+        return entry.source;
+    return QString();
+}
+
+QStringList MountTableCache::dlnfsMountRoots()
+{
+    refreshIfChanged();
+
+    QReadLocker lk(&lock);
+    return dlnfsRoots;
+}
+
+void MountTableCache::load(const QVector<MountEntry> &mounts)
+{
+    QWriteLocker lk(&lock);
+    rebuild(mounts);
+    loaded = true;
+    dirty = false;
+}
+
+void MountTableCache::refreshIfChanged()
+{
+    {
+        QReadLocker lk(&lock);
+        if (loaded && mountInfoFd >= 0 && !dirty && !tableChanged())
+            return;
+    }
+
+    // the change reported is consumed, so the table is parsed again at the next query if it fails
+    dirty = !reload();
+}
+
+bool MountTableCache::tableChanged()
+{
+    // the kernel reports POLLPRI once for each change of the mount namespace.
+    struct pollfd pfd;
+    pfd.fd = mountInfoFd;
+    pfd.events = POLLPRI;
+    pfd.revents = 0;
+    if (::poll(&pfd, 1, 0) <= 0)
+        return false;
+
+    return pfd.revents & (POLLPRI | POLLERR);
+}
+
+bool MountTableCache::reload()
+{
+    libmnt_table *tab { mnt_new_table() };
+    libmnt_iter *iter { mnt_new_iter(MNT_ITER_FORWARD) };
+    FinallyUtil release([&] {
+        if (tab) mnt_free_table(tab);
+        if (iter) mnt_free_iter(iter);
+    });
+
+    if (!tab || !iter)
+        return false;
+
+    int ret = mnt_table_parse_mtab(tab, nullptr);
+    if (ret != 0) {
+        qCWarning(logDFMBase) << "device: cannot parse mtab" << ret;
+        return false;
+    }
+
+    QVector<MountEntry> mounts;
+    libmnt_fs *fs = nullptr;
+    while (mnt_table_next_fs(tab, iter, &fs) == 0) {
+        if (!fs)
+            continue;
+
+        MountEntry entry;
+        entry.source = QString::fromLocal8Bit(mnt_fs_get_source(fs));
+        entry.target = QString::fromLocal8Bit(mnt_fs_get_target(fs));
+        entry.fsType = QString::fromLocal8Bit(mnt_fs_get_fstype(fs));
+        entry.canonicalSource = canonicalSource(entry.source);
+        mounts.append(entry);
+    }
+
+    QWriteLocker lk(&lock);
+    rebuild(mounts);
+    loaded = true;
+    return true;
+}
+
+void MountTableCache::rebuild(const QVector<MountEntry> &mounts)
+{
+    entries = mounts;
+    nodes.clear();
+    nodes.append(Node());
+    dlnfsRoots.clear();
+
+    for (int i = 0; i < entries.size(); ++i) {
+        MountEntry &entry = entries[i];
+        if (entry.target.isEmpty())
+            continue;
+
+        entry.root = entry.target.endsWith('/') ? entry.target : entry.target + '/';
+        if (entry.canonicalSource.isEmpty())
+            entry.canonicalSource = canonicalSource(entry.source);
+        // later mounts over the same target hide the earlier ones.
+        insertTarget(entry.target, i);
+
+        if (entry.source == kDlnfsSource)
+            dlnfsRoots.append(entry.root);
+    }
+}
+
+void MountTableCache::insertTarget(const QString &target, int entry)
+{
+    int node = 0;
+    for (const QStringRef &name : target.splitRef('/', QString::SkipEmptyParts)) {
+        auto &children = nodes[node].children;
+        auto itor = std::lower_bound(children.begin(), children.end(), name, componentLess);
+        if (itor != children.end() && itor->first == name) {
+            node = itor->second;
+            continue;
+        }
+
+        const int child = nodes.size();
+        children.insert(itor, qMakePair(name.toString(), child));
+        nodes.append(Node());
+        node = child;
+    }
+
+    nodes[node].entry = entry;
+}
+
+int MountTableCache::findLongest(const QString &path) const
+{
+    if (nodes.isEmpty())
+        return -1;
+
+    int node = 0;
+    int found = nodes.at(0).entry;
+    const int len = path.length();
+    int pos = 0;
+    while (pos < len) {
+        // skip separators
+        if (path.at(pos) == '/') {
+            ++pos;
+            continue;
+        }
+
+        int end = path.indexOf('/', pos);
+        if (end < 0)
+            end = len;
+
+        const QStringRef name = path.midRef(pos, end - pos);
+        const auto &children = nodes.at(node).children;
+        auto itor = std::lower_bound(children.cbegin(), children.cend(), name, componentLess);
+        if (itor == children.cend() || itor->first != name)
+            break;
+
+        node = itor->second;
+        if (nodes.at(node).entry >= 0)
+            found = nodes.at(node).entry;
+        pos = end;
+    }
+
+    return found;
+}
+
+QString MountTableCache::canonicalSource(const QString &source)
+{
+    // the sources such as tmpfs, dlnfs and server:/share are not paths
+    if (!source.startsWith('/'))
+        return source;
+
+    char *resolved = mnt_resolve_path(source.toLocal8Bit().constData(), nullptr);
+    if (!resolved)
+        return source;
+
+    const QString &path = QString::fromLocal8Bit(resolved);
+    ::free(resolved);
+    return path;
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MOUNTTABLECACHE_H
+#define MOUNTTABLECACHE_H
+
+#include <dfm-base/dfm_base_global.h>
+
+#include <QReadWriteLock>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+
+namespace dfmbase {
+
+/*!
+ * \brief The MountTableCache class keeps a snapshot of the mount table of this process.
+ * The table is parsed by libmount only when /proc/self/mountinfo reports a change (POLLPRI),
+ * and the mount points are kept in a trie of path components, so the per-file queries
+ * (longest mount root, mount source) only walk the path without allocating.
+ * If the table cannot be parsed after a change is reported, it is parsed again at the next query.
+ */
+class MountTableCache
+{
+    Q_DISABLE_COPY(MountTableCache)
+
+public:
+    struct MountEntry
+    {
+        QString source;
+        QString target;
+        QString root;   // target ends with '/'
+        QString fsType;
+        QString canonicalSource;   // the device with the symlinks resolved, e.g. /dev/dm-0 for /dev/mapper/xxx
+    };
+
+    static MountTableCache *instance();
+
+    MountTableCache();
+    ~MountTableCache();
+
+    QString longestMountRoot(const QString &path);
+    QString mountSource(const QString &path);
+    QString targetOfSource(const QString &source);
+    QString sourceOfTarget(const QString &target);
+    QStringList dlnfsMountRoots();
+
+    // for test
+    void load(const QVector<MountEntry> &mounts);
+
+private:
+    struct Node
+    {
+        QVector<QPair<QString, int>> children;   // sorted by component name
+        int entry { -1 };
+    };
+
+    void refreshIfChanged();
+    bool tableChanged();
+    bool reload();
+    void rebuild(const QVector<MountEntry> &mounts);
+    void insertTarget(const QString &target, int entry);
+    int findLongest(const QString &path) const;
+    static QString canonicalSource(const QString &source);
+
+private:
+    QReadWriteLock lock;
+    QVector<MountEntry> entries;
+    QVector<Node> nodes;
+    QStringList dlnfsRoots;
+    int mountInfoFd { -1 };
+    bool loaded { false };
+    std::atomic_bool dirty { false };   // the change is reported but the table is not parsed
+};
+
+}
+
+#endif   // MOUNTTABLECACHE_H
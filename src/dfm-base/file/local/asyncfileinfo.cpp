@@ -1062,14 +1062,11 @@ FileInfo::FileType AsyncFileInfoPrivate::fileType() const
 int AsyncFileInfoPrivate::cacheAllAttributes()
 {
     assert(qApp->thread() != QThread::currentThread());
-    QMap<FileInfo::FileInfoAttributeID, QVariant> tmp, cacheTmp;
+    PackedAttributes<FileInfo::FileInfoAttributeID> tmp;
+    bool firstCache = false;
     {
         QReadLocker lk(&lock);
-        cacheTmp = cacheAsyncAttributes;
-    }
-    {
-        QWriteLocker lk(&changesLock);
-        changesAttributes.clear();
+        firstCache = cacheAsyncAttributes.isEmpty();
     }
     if (needUpdateMediaInfo) {
         DFileInfo::MediaType mediaType { DFileInfo::MediaType::kGeneral };
@@ -1151,33 +1148,42 @@ int AsyncFileInfoPrivate::cacheAllAttributes()
         QWriteLocker rlk(&iconLock);
         fileIcon = QIcon();
     }
-    if (cacheTmp.isEmpty()) {
-        {
-            QWriteLocker lk(&lock);
+
+    // merge the new attributes under one lock
+    bool mimeChanged = false;
+    bool changed = false;
+    {
+        QWriteLocker lk(&lock);
+        if (firstCache) {
             QVariant hid = cacheAsyncAttributes.value(FileInfo::FileInfoAttributeID::kStandardIsHidden);
             cacheAsyncAttributes = tmp;
             if (notInit && hid.isValid())
                 cacheAsyncAttributes.insert(FileInfo::FileInfoAttributeID::kStandardIsHidden, hid);
+        } else {
+            for (const auto &key : tmp.keys()) {
+                if (!cacheAsyncAttributes.update(key, tmp.value(key)))
+                    continue;
+
+                changed = true;
+                if (key == FileInfo::FileInfoAttributeID::kStandardFileType
+                    || key == FileInfo::FileInfoAttributeID::kStandardFileExists
+                    || key == FileInfo::FileInfoAttributeID::kStandardContentType)
+                    mimeChanged = true;
+            }
         }
+    }
+
+    if (firstCache) {
         // kMimeTypeName
         fileMimeTypeAsync();
         return 2;
     }
 
-    {
-        QWriteLocker lk(&changesLock);
-        changesAttributes.clear();
-        for (const auto &key : tmp.keys()) {
-            if (inserAsyncAttribute(key, tmp.value(key)))
-                changesAttributes.append(key);
-        }
+    if (!changed)
+        return 1;
 
-        if (changesAttributes.isEmpty())
-            return 1;
-
-        if (changesAttributes.contains(FileInfo::FileInfoAttributeID::kStandardFileType) || changesAttributes.contains(FileInfo::FileInfoAttributeID::kStandardFileExists) || changesAttributes.contains(FileInfo::FileInfoAttributeID::kStandardContentType))
-            fileMimeTypeAsync();   // kMimeTypeName
-    }
+    if (mimeChanged)
+        fileMimeTypeAsync();   // kMimeTypeName
 
     return 2;
 }
@@ -1185,10 +1191,7 @@ int AsyncFileInfoPrivate::cacheAllAttributes()
 bool AsyncFileInfoPrivate::inserAsyncAttribute(const FileInfo::FileInfoAttributeID id, const QVariant &value)
 {
     QWriteLocker lk(&lock);
-    if (cacheAsyncAttributes.value(id) == value || !value.isValid())
-        return false;
-    cacheAsyncAttributes.insert(id, value);
-    return true;
+    return cacheAsyncAttributes.update(id, value);
 }
 
 void AsyncFileInfoPrivate::fileMimeTypeAsync(QMimeDatabase::MatchMode mode)
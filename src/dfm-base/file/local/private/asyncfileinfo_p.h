@@ -6,6 +6,7 @@
 #define ASYNCFILEINFO_P_H
 
 #include "infodatafuture.h"
+#include "packedattributes.h"
 
 #include <dfm-base/file/local/asyncfileinfo.h>
 #include <dfm-base/utils/fileutils.h>
@@ -48,13 +49,11 @@ public:
     QSharedPointer<InfoDataFuture> mediaFuture { nullptr };
     InfoHelperUeserDataPointer fileCountFuture { nullptr };
     InfoHelperUeserDataPointer updateFileCountFuture { nullptr };
-    QMap<FileInfo::FileInfoAttributeID, QVariant> cacheAsyncAttributes;
+    PackedAttributes<FileInfo::FileInfoAttributeID> cacheAsyncAttributes;
     QReadWriteLock notifyLock;
     QMultiMap<QUrl, QString> notifyUrls;
     quint64 tokenKey{0};
     AsyncFileInfo *const q;
-    QReadWriteLock changesLock;
-    QList<FileInfo::FileInfoAttributeID> changesAttributes;
 
 public:
     explicit AsyncFileInfoPrivate(AsyncFileInfo *qq);
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "packedattributes.h"
+
+#include <QtAlgorithms>
+
+namespace dfmbase {
+
+namespace {
+// the attributes cached by every refresh of a file info.
+constexpr int kHotIds[] {
+    0, 1, 3, 6, 7, 10, 12, 14, 16, 20, 21, 22,   // standard
+    100, 101, 102, 103, 104, 105, 106,   // access
+    200, 201, 202, 203, 204, 205, 206, 207,   // time
+    300, 302,   // owner
+    331, 332, 334, 335,   // unix
+    610, 611, 614, 615, 616, 619, 620   // custom
+};
+constexpr int kSlotTableSize { 1000 };
+static_assert(sizeof(kHotIds) / sizeof(kHotIds[0]) == PackedAttributesData::kHotCount, "hot id count mismatch");
+static_assert(PackedAttributesData::kHotCount <= 64, "presence mask is 64 bits");
+}
+
+int PackedAttributesData::slotOf(int id)
+{
+    static const std::array<qint8, kSlotTableSize> table = [] {
+        std::array<qint8, kSlotTableSize> ret;
+        ret.fill(-1);
+        for (int i = 0; i < kHotCount; ++i)
+            ret[static_cast<size_t>(kHotIds[i])] = static_cast<qint8>(i);
+        return ret;
+    }();
+
+    if (id < 0 || id >= kSlotTableSize)
+        return -1;
+    return table[static_cast<size_t>(id)];
+}
+
+bool PackedAttributesData::contains(int id) const
+{
+    const int slot = slotOf(id);
+    if (slot < 0)
+        return rare.contains(id);
+
+    return presence & (quint64(1) << slot);
+}
+
+QVariant PackedAttributesData::value(int id) const
+{
+    const int slot = slotOf(id);
+    if (slot < 0)
+        return rare.value(id);
+
+    return (presence & (quint64(1) << slot)) ? hot[static_cast<size_t>(slot)] : QVariant();
+}
+
+void PackedAttributesData::insert(int id, const QVariant &value)
+{
+    const int slot = slotOf(id);
+    if (slot < 0) {
+        rare.insert(id, value);
+        return;
+    }
+
+    hot[static_cast<size_t>(slot)] = value;
+    presence |= quint64(1) << slot;
+}
+
+bool PackedAttributesData::update(int id, const QVariant &value)
+{
+    if (!value.isValid() || this->value(id) == value)
+        return false;
+
+    insert(id, value);
+    return true;
+}
+
+void PackedAttributesData::remove(int id)
+{
+    const int slot = slotOf(id);
+    if (slot < 0) {
+        rare.remove(id);
+        return;
+    }
+
+    hot[static_cast<size_t>(slot)] = QVariant();
+    presence &= ~(quint64(1) << slot);
+}
+
+void PackedAttributesData::clear()
+{
+    if (presence) {
+        for (QVariant &var : hot)
+            var = QVariant();
+        presence = 0;
+    }
+    rare.clear();
+}
+
+bool PackedAttributesData::isEmpty() const
+{
+    return presence == 0 && rare.isEmpty();
+}
+
+int PackedAttributesData::count() const
+{
+    return qPopulationCount(presence) + rare.size();
+}
+
+QList<int> PackedAttributesData::keys() const
+{
+    QList<int> ret;
+    ret.reserve(count());
+    for (int i = 0; i < kHotCount; ++i) {
+        if (presence & (quint64(1) << i))
+            ret.append(kHotIds[i]);
+    }
+    ret.append(rare.keys());
+    return ret;
+}
+
+}
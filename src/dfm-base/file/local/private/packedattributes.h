@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PACKEDATTRIBUTES_H
+#define PACKEDATTRIBUTES_H
+
+#include <dfm-base/dfm_base_global.h>
+
+#include <QMap>
+#include <QVariant>
+
+#include <array>
+
+namespace dfmbase {
+
+/*!
+ * \brief The PackedAttributesData class stores the attributes of a file info.
+ * The attributes which are refreshed for every file (name, size, times, access...)
+ * are kept in a fixed array of slots with a presence mask, so caching them costs
+ * no node allocation. The others are kept in a map.
+ * The id is the value of FileInfo::FileInfoAttributeID or DFileInfo::AttributeID,
+ * they use the same numbering.
+ */
+class PackedAttributesData
+{
+public:
+    static constexpr int kHotCount { 40 };
+
+    bool contains(int id) const;
+    QVariant value(int id) const;
+    void insert(int id, const QVariant &value);
+    bool update(int id, const QVariant &value);
+    void remove(int id);
+    void clear();
+    bool isEmpty() const;
+    int count() const;
+    QList<int> keys() const;
+
+    // return the slot of the id, or -1 if it is stored in the map.
+    static int slotOf(int id);
+
+private:
+    quint64 presence { 0 };
+    std::array<QVariant, kHotCount> hot;
+    QMap<int, QVariant> rare;
+};
+
+template<typename Key>
+class PackedAttributes
+{
+public:
+    inline bool contains(Key key) const { return data.contains(static_cast<int>(key)); }
+    inline int count(Key key) const { return contains(key) ? 1 : 0; }
+    inline QVariant value(Key key) const { return data.value(static_cast<int>(key)); }
+    inline void insert(Key key, const QVariant &value) { data.insert(static_cast<int>(key), value); }
+    // insert \a value only if it is valid and different from the cached one, return true if inserted.
+    inline bool update(Key key, const QVariant &value) { return data.update(static_cast<int>(key), value); }
+    inline void remove(Key key) { data.remove(static_cast<int>(key)); }
+    inline void clear() { data.clear(); }
+    inline bool isEmpty() const { return data.isEmpty(); }
+    inline int size() const { return data.count(); }
+    inline QList<Key> keys() const
+    {
+        QList<Key> ret;
+        for (int id : data.keys())
+            ret.append(static_cast<Key>(id));
+        return ret;
+    }
+
+private:
+    PackedAttributesData data;
+};
+
+}
+
+#endif   // PACKEDATTRIBUTES_H
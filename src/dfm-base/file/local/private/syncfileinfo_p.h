@@ -6,6 +6,7 @@
 #define SYNCFILEINFO_P_H
 
 #include "infodatafuture.h"
+#include "packedattributes.h"
 
 #include <dfm-base/interfaces/private/fileinfo_p.h>
 #include <dfm-base/file/local/syncfileinfo.h>
@@ -47,7 +48,7 @@ public:
     QVariant isCdRomDevice;
     QSharedPointer<InfoDataFuture> mediaFuture { nullptr };
     InfoHelperUeserDataPointer fileMimeTypeFuture { nullptr };
-    QMap<DFMIO::DFileInfo::AttributeID, QVariant> cacheAttributes;
+    PackedAttributes<DFMIO::DFileInfo::AttributeID> cacheAttributes;
 
 public:
     explicit SyncFileInfoPrivate(SyncFileInfo *qq);
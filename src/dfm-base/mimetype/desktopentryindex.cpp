@@ -0,0 +1,311 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "desktopentryindex.h"
+#include "mimesappsmanager.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QLocale>
+#include <QSet>
+
+#include <algorithm>
+
+#include <sys/stat.h>
+
+using namespace dfmbase;
+
+static constexpr quint32 kCacheMagic { 0x44454958 };   // "DEIX"
+
+bool DesktopEntryIndex::FileKey::operator==(const FileKey &other) const
+{
+    return size == other.size && mtime == other.mtime && ctime == other.ctime && inode == other.inode;
+}
+
+DesktopEntryIndex::DesktopEntryIndex(const QStringList &folders, const QString &cacheFile)
+    : folders(folders), cacheFile(cacheFile)
+{
+}
+
+DesktopEntryIndex *DesktopEntryIndex::instance()
+{
+    static DesktopEntryIndex index(MimesAppsManager::getApplicationsFolders(),
+                                   MimesAppsManager::getDesktopEntryCacheFile());
+    return &index;
+}
+
+bool DesktopEntryIndex::makeKey(const QString &filePath, FileKey *key)
+{
+    struct stat st;
+    if (filePath.isEmpty() || ::stat(QFile::encodeName(filePath).constData(), &st) != 0 || !S_ISREG(st.st_mode))
+        return false;
+
+    key->size = st.st_size;
+    key->mtime = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    key->ctime = static_cast<qint64>(st.st_ctim.tv_sec) * 1000000000 + st.st_ctim.tv_nsec;
+    key->inode = st.st_ino;
+    return true;
+}
+
+bool DesktopEntryIndex::update(const QMap<QString, QStringList> &ddeTypes)
+{
+    // the updates are serialized, the readers only wait for the swap
+    QMutexLocker updateLk(&updateMutex);
+    if (!cacheLoaded) {
+        cacheLoaded = true;
+        loadCache();
+    }
+
+    // the entries are only changed by the update, so they are read without the lock here
+    QHash<QString, Entry> newEntries;
+    QStringList newPaths;
+    newEntries.reserve(entries.size());
+    newPaths.reserve(paths.size());
+    int parsed = 0;
+    for (const QString &folder : folders) {
+        QDirIterator it(folder, QStringList("*.desktop"), QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString &path = it.next();
+            FileKey key;
+            if (newEntries.contains(path) || !makeKey(path, &key))
+                continue;
+
+            auto old = entries.constFind(path);
+            if (old != entries.cend() && old->key == key) {
+                newEntries.insert(path, old.value());
+            } else {
+                Entry entry;
+                entry.key = key;
+                entry.created = QFileInfo(path).created().toMSecsSinceEpoch();
+                entry.desktop = DesktopFile(path);
+                newEntries.insert(path, entry);
+                ++parsed;
+            }
+            newPaths.append(path);
+        }
+    }
+
+    lastParsedCount = parsed;
+    // the files are the same if none is read again and none is removed
+    const bool changed = parsed > 0 || newPaths != paths || ddeTypes != ddeMimeTypes;
+    if (changed) {
+        {
+            QMutexLocker lk(&mutex);
+            entries.swap(newEntries);
+            paths.swap(newPaths);
+            ddeMimeTypes = ddeTypes;
+            updateMimeApps();
+        }
+        saveCache();
+        qCInfo(logDFMBase) << "desktop entries updated, parsed:" << parsed << "total:" << paths.count();
+    }
+
+    // the maps of caller are filled at the first update
+    const bool result = changed || !updated;
+    updated = true;
+    return result;
+}
+
+QStringList DesktopEntryIndex::desktopFiles() const
+{
+    QMutexLocker lk(&mutex);
+    QStringList files;
+    files.reserve(paths.size());
+    for (const QString &path : paths) {
+        if (!entries.value(path).desktop.isNoShow())
+            files.append(path);
+    }
+    return files;
+}
+
+QMap<QString, DesktopFile> DesktopEntryIndex::desktopObjs() const
+{
+    QMutexLocker lk(&mutex);
+    QMap<QString, DesktopFile> objs;
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        if (!it->desktop.isNoShow())
+            objs.insert(it.key(), it->desktop);
+    }
+    return objs;
+}
+
+QMap<QString, QStringList> DesktopEntryIndex::mimeApps() const
+{
+    QMutexLocker lk(&mutex);
+    return apps;
+}
+
+bool DesktopEntryIndex::contains(const QString &path) const
+{
+    QMutexLocker lk(&mutex);
+    return entries.contains(path);
+}
+
+DesktopFile DesktopEntryIndex::desktopFile(const QString &path) const
+{
+    QMutexLocker lk(&mutex);
+    return entries.value(path).desktop;
+}
+
+QString DesktopEntryIndex::pathOfId(const QString &desktopId) const
+{
+    QMutexLocker lk(&mutex);
+    return idPaths.value(desktopId);
+}
+
+bool DesktopEntryIndex::loadCache()
+{
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly) || file.size() <= 0)
+        return false;
+
+    uchar *data = file.map(0, file.size());
+    if (!data) {
+        qCWarning(logDFMBase) << "failed to map desktop entry cache:" << cacheFile << file.errorString();
+        return false;
+    }
+
+    // the records are read from the mapped file directly
+    const QByteArray &bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data), static_cast<int>(file.size()));
+    QDataStream in(bytes);
+    in.setVersion(QDataStream::Qt_5_11);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString locale;
+    QStringList cachedFolders;
+    in >> magic >> version;
+    if (magic != kCacheMagic || version != kCacheVersion) {
+        file.unmap(data);
+        return false;
+    }
+
+    // the names of desktop files are read in the language of system
+    in >> locale >> cachedFolders;
+    if (locale != QLocale::system().name() || cachedFolders != folders) {
+        file.unmap(data);
+        return false;
+    }
+
+    qint32 count = 0;
+    in >> count;
+    QHash<QString, Entry> cachedEntries;
+    QStringList cachedPaths;
+    cachedEntries.reserve(count);
+    cachedPaths.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        in >> path >> entry.key.size >> entry.key.mtime >> entry.key.ctime >> entry.key.inode
+           >> entry.created >> entry.desktop;
+        cachedEntries.insert(path, entry);
+        cachedPaths.append(path);
+    }
+
+    QMap<QString, QStringList> cachedDdeTypes;
+    QMap<QString, QStringList> cachedApps;
+    in >> cachedDdeTypes >> cachedApps;
+    const bool ok = in.status() == QDataStream::Ok;
+    file.unmap(data);
+    if (!ok) {
+        qCWarning(logDFMBase) << "desktop entry cache is broken:" << cacheFile;
+        return false;
+    }
+
+    QMutexLocker lk(&mutex);
+    entries.swap(cachedEntries);
+    paths.swap(cachedPaths);
+    ddeMimeTypes.swap(cachedDdeTypes);
+    apps.swap(cachedApps);
+    updateIds();
+    return true;
+}
+
+void DesktopEntryIndex::saveCache() const
+{
+    if (cacheFile.isEmpty())
+        return;
+
+    QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+    // the cache is replaced at once, the processes reading it see the old or the new one
+    QSaveFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(logDFMBase) << "failed to write desktop entry cache:" << cacheFile << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_11);
+    out << kCacheMagic << kCacheVersion << QLocale::system().name() << folders;
+    out << static_cast<qint32>(paths.size());
+    for (const QString &path : paths) {
+        const Entry &entry = entries.value(path);
+        out << path << entry.key.size << entry.key.mtime << entry.key.ctime << entry.key.inode
+            << entry.created << entry.desktop;
+    }
+    out << ddeMimeTypes << apps;
+
+    if (!file.commit())
+        qCWarning(logDFMBase) << "failed to write desktop entry cache:" << cacheFile << file.errorString();
+}
+
+void DesktopEntryIndex::updateMimeApps()
+{
+    QHash<QString, QSet<QString>> mimeAppsSet;
+    for (const QString &path : paths) {
+        const DesktopFile &desktop = entries.value(path).desktop;
+        if (desktop.isNoShow())
+            continue;
+
+        QStringList mimeTypes = desktop.desktopMimeType();
+        const QString &fileName = path.mid(path.lastIndexOf('/') + 1);
+        if (ddeMimeTypes.contains(fileName))
+            mimeTypes.append(ddeMimeTypes.value(fileName));
+
+        for (const QString &mimeType : mimeTypes) {
+            if (!mimeType.isEmpty())
+                mimeAppsSet[mimeType].insert(path);
+        }
+    }
+
+    // the apps installed earlier are recommended first
+    apps.clear();
+    for (auto it = mimeAppsSet.cbegin(); it != mimeAppsSet.cend(); ++it) {
+        QStringList orderApps = it->toList();
+        std::sort(orderApps.begin(), orderApps.end(), [this](const QString &left, const QString &right) {
+            return entries.value(left).created < entries.value(right).created;
+        });
+        apps.insert(it.key(), orderApps);
+    }
+
+    updateIds();
+}
+
+void DesktopEntryIndex::updateIds()
+{
+    // the desktop id is the path relative to the applications folder with '/' replaced by '-',
+    // the id in several folders is resolved by GIO with the precedence of XDG_DATA_DIRS
+    idPaths.clear();
+    for (const QString &path : paths) {
+        for (const QString &folder : folders) {
+            const QString &prefix = folder.endsWith('/') ? folder : folder + '/';
+            if (!path.startsWith(prefix))
+                continue;
+
+            QString id = path.mid(prefix.size());
+            id.replace('/', '-');
+            auto it = idPaths.find(id);
+            if (it == idPaths.end())
+                idPaths.insert(id, path);
+            else if (it.value() != path)
+                it.value().clear();
+            break;
+        }
+    }
+}
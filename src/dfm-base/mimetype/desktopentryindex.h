@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DESKTOPENTRYINDEX_H
+#define DESKTOPENTRYINDEX_H
+
+#include <dfm-base/dfm_base_global.h>
+#include <dfm-base/utils/desktopfile.h>
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QStringList>
+
+namespace dfmbase {
+
+/*!
+ * \brief The DesktopEntryIndex class keeps the parsed desktop files of the application folders.
+ * A desktop file is read again only if its size, modify time, change time or inode is changed,
+ * the others are taken from the last update. The entries and the apps of mime types are saved to
+ * a versioned binary cache file, which is mapped and loaded at the first update of the process,
+ * so the files are not parsed again after the file manager is started.
+ */
+class DesktopEntryIndex
+{
+    Q_DISABLE_COPY(DesktopEntryIndex)
+
+public:
+    struct FileKey
+    {
+        qint64 size { -1 };
+        qint64 mtime { -1 };   // in nanoseconds
+        qint64 ctime { -1 };   // in nanoseconds
+        quint64 inode { 0 };
+
+        bool operator==(const FileKey &other) const;
+        inline bool operator!=(const FileKey &other) const { return !(*this == other); }
+    };
+
+    struct Entry
+    {
+        FileKey key;
+        qint64 created { 0 };   // the created time in ms, the apps of a mime type are sorted by it
+        DesktopFile desktop;
+    };
+
+    static constexpr quint32 kCacheVersion { 1 };
+
+    DesktopEntryIndex(const QStringList &folders, const QString &cacheFile);
+    static DesktopEntryIndex *instance();
+
+    static bool makeKey(const QString &filePath, FileKey *key);
+
+    // read the desktop files changed, return false if nothing is changed since the last update
+    bool update(const QMap<QString, QStringList> &ddeMimeTypes);
+
+    // the desktop files shown in the order of folders
+    QStringList desktopFiles() const;
+    QMap<QString, DesktopFile> desktopObjs() const;
+    QMap<QString, QStringList> mimeApps() const;
+    bool contains(const QString &path) const;
+    DesktopFile desktopFile(const QString &path) const;
+    // the desktop file of the desktop id, such as "org.gnome.gedit.desktop",
+    // empty if it is not found or it is in several folders
+    QString pathOfId(const QString &desktopId) const;
+
+    // the desktop files parsed in the last update
+    inline int parsedCount() const { return lastParsedCount; }
+
+private:
+    bool loadCache();
+    void saveCache() const;
+    void updateMimeApps();
+    void updateIds();
+
+private:
+    mutable QMutex mutex;   // guards the entries for the readers
+    QMutex updateMutex;   // serializes the updates, the files are walked and parsed without the lock above
+    QStringList folders;
+    QString cacheFile;
+    bool cacheLoaded { false };
+    bool updated { false };
+    int lastParsedCount { 0 };
+
+    QHash<QString, Entry> entries;
+    QStringList paths;   // the desktop files in the order of folders
+    QHash<QString, QString> idPaths;   // the desktop id to desktop file
+    QMap<QString, QStringList> ddeMimeTypes;
+    QMap<QString, QStringList> apps;   // the apps of mime types
+};
+
+}
+
+#endif   // DESKTOPENTRYINDEX_H
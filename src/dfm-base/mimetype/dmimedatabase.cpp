@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "dmimedatabase.h"
+#include "mimetypecache.h"
 
 #include <dfm-base/utils/fileutils.h>
 #include <dfm-base/base/schemefactory.h>
@@ -65,7 +66,18 @@ QMimeType DMimeDatabase::mimeTypeForFile(const FileInfoPointer &fileInfo, QMimeD
         }
     }
 
-    if (isMatchExtension || DeviceUtils::isLowSpeedDevice(QUrl::fromLocalFile(path))) {
+    isMatchExtension = isMatchExtension || DeviceUtils::isLowSpeedDevice(QUrl::fromLocalFile(path));
+
+    // 按扩展名匹配时不读取文件，也不为缓存去 stat 低速设备和黑名单中的文件
+    MimeTypeCache::FileKey key;
+    const bool canCache = !isMatchExtension && MimeTypeCache::makeKey(fileInfo->pathOf(PathInfoType::kFilePath), mode, &key);
+    if (canCache) {
+        const QMimeType &cached = cachedMimeType(key);
+        if (cached.isValid())
+            return cached;
+    }
+
+    if (isMatchExtension) {
         result = QMimeDatabase::mimeTypeForFile(fileInfo->pathOf(PathInfoType::kFilePath), QMimeDatabase::MatchExtension);
     } else {
         result = QMimeDatabase::mimeTypeForFile(fileInfo->pathOf(PathInfoType::kFilePath), mode);
@@ -81,10 +93,12 @@ QMimeType DMimeDatabase::mimeTypeForFile(const FileInfoPointer &fileInfo, QMimeD
     if (officeSuffixList.contains(fileInfo->nameOf(NameInfoType::kSuffix))
         && wrongMimeTypeNames.contains(result.name())) {
         QList<QMimeType> results = QMimeDatabase::mimeTypesForFileName(fileInfo->nameOf(NameInfoType::kFileName));
-        if (!results.isEmpty()) {
-            return results.first();
-        }
+        if (!results.isEmpty())
+            result = results.first();
     }
+
+    if (canCache)
+        MimeTypeCache::instance()->insert(key, result.name());
     return result;
 }
 
@@ -107,6 +121,7 @@ QMimeType DMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, QMimeDatabas
     if (fileInfo.isDir()) {
         return QMimeDatabase::mimeTypeForFile(QFileInfo("/home"), mode);
     }
+
     QMimeType result;
     QString path = fileInfo.path();
 
@@ -135,7 +150,21 @@ QMimeType DMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, QMimeDatabas
             isMatchExtension = blackList.contains(filePath);
         }
     }
-    if (isMatchExtension || DeviceUtils::isLowSpeedDevice(QUrl::fromLocalFile(path))) {
+    isMatchExtension = isMatchExtension || DeviceUtils::isLowSpeedDevice(QUrl::fromLocalFile(path));
+
+    // 按扩展名匹配时不读取文件，也不为缓存去 stat 低速设备和黑名单中的文件
+    MimeTypeCache::FileKey key;
+    const bool canGlobalCache = !isMatchExtension && MimeTypeCache::makeKey(fileInfo.absoluteFilePath(), mode, &key);
+    if (canGlobalCache) {
+        const QMimeType &cached = cachedMimeType(key);
+        if (cached.isValid()) {
+            if (canCache)
+                const_cast<DMimeDatabase *>(this)->inodMimetypeCache.insert(inod, cached);
+            return cached;
+        }
+    }
+
+    if (isMatchExtension) {
         result = QMimeDatabase::mimeTypeForFile(fileInfo, QMimeDatabase::MatchExtension);
     } else {
         result = QMimeDatabase::mimeTypeForFile(fileInfo, mode);
@@ -150,19 +179,26 @@ QMimeType DMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, QMimeDatabas
 
     if (officeSuffixList.contains(fileInfo.suffix()) && wrongMimeTypeNames.contains(result.name())) {
         QList<QMimeType> results = QMimeDatabase::mimeTypesForFileName(fileInfo.fileName());
-        if (!results.isEmpty()) {
-            if (canCache) {
-                const_cast<DMimeDatabase *>(this)->inodMimetypeCache.insert(inod, results.first());
-            }
-            return results.first();
-        }
+        if (!results.isEmpty())
+            result = results.first();
     }
     if (canCache) {
         const_cast<DMimeDatabase *>(this)->inodMimetypeCache.insert(inod, result);
     }
+    if (canGlobalCache)
+        MimeTypeCache::instance()->insert(key, result.name());
     return result;
 }
 
+QMimeType DMimeDatabase::cachedMimeType(const MimeTypeCache::FileKey &key) const
+{
+    const QString &name = MimeTypeCache::instance()->value(key);
+    if (name.isEmpty())
+        return QMimeType();
+
+    return QMimeDatabase::mimeTypeForName(name);
+}
+
 QMimeType DMimeDatabase::mimeTypeForUrl(const QUrl &url) const
 {
     if (dfmbase::FileUtils::isLocalFile(url))
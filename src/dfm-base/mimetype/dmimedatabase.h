@@ -7,6 +7,7 @@
 
 #include <dfm-base/dfm_base_global.h>
 #include <dfm-base/interfaces/fileinfo.h>
+#include <dfm-base/mimetype/mimetypecache.h>
 
 #include <QMimeDatabase>
 
@@ -26,6 +27,7 @@ public:
 
 private:
     QMimeType mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mode, const QString &inod, const bool isGvfs = false) const;
+    QMimeType cachedMimeType(const MimeTypeCache::FileKey &key) const;
 
 private:
     QHash<QString, QMimeType> inodMimetypeCache;
@@ -5,6 +5,7 @@
 #include "mimesappsmanager.h"
 
 #include <dfm-base/mimetype/dmimedatabase.h>
+#include <dfm-base/mimetype/desktopentryindex.h>
 #include <dfm-base/mimetype/mimetypedisplaymanager.h>
 #include <dfm-base/base/standardpaths.h>
 
@@ -15,6 +16,7 @@
 #include <QDateTime>
 #include <QThread>
 #include <QStandardPaths>
+#include <QMutex>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -42,6 +44,13 @@ QMap<QString, DesktopFile> MimesAppsManager::TextMimeApps = {};
 QMap<QString, DesktopFile> MimesAppsManager::AudioMimeApps = {};
 QMap<QString, DesktopFile> MimesAppsManager::DesktopObjs = {};
 
+// the desktop file parsed in the index is not parsed again
+static DesktopFile desktopFileOf(const QString &path)
+{
+    DesktopEntryIndex *index = DesktopEntryIndex::instance();
+    return index->contains(path) ? index->desktopFile(path) : DesktopFile(path);
+}
+
 MimeAppsWorker::MimeAppsWorker(QObject *parent)
     : QObject(parent)
 {
@@ -283,13 +292,19 @@ QStringList MimesAppsManager::getRecommendedApps(const QUrl &url)
         recommendedApps.append(customApp);
     }
 
-    GDesktopAppInfo *desktopAppInfo = g_desktop_app_info_new(defaultApp.toLocal8Bit().constData());
+    // the desktop file of default app is found in the index, GIO is asked only if it is not there
+    QString defaultAppFile = DesktopEntryIndex::instance()->pathOfId(defaultApp);
+    if (defaultAppFile.isEmpty()) {
+        GDesktopAppInfo *desktopAppInfo = g_desktop_app_info_new(defaultApp.toLocal8Bit().constData());
+        if (desktopAppInfo) {
+            defaultAppFile = QString::fromLocal8Bit(g_desktop_app_info_get_filename(desktopAppInfo));
+            g_object_unref(desktopAppInfo);
+        }
+    }
 
-    if (desktopAppInfo) {
-        defaultApp = QString::fromLocal8Bit(g_desktop_app_info_get_filename(desktopAppInfo));
-        g_object_unref(desktopAppInfo);
-        MimesAppsManager::removeOneDupFromList(recommendedApps, defaultApp);
-        recommendedApps.prepend(defaultApp);
+    if (!defaultAppFile.isEmpty()) {
+        MimesAppsManager::removeOneDupFromList(recommendedApps, defaultAppFile);
+        recommendedApps.prepend(defaultAppFile);
     }
 
     return recommendedApps;
@@ -454,6 +469,11 @@ QString MimesAppsManager::getDesktopIconsCacheFile()
     return QString("%1/%2").arg(StandardPaths::location(StandardPaths::kCachePath), "DesktopIcons.json");
 }
 
+QString MimesAppsManager::getDesktopEntryCacheFile()
+{
+    return QString("%1/%2").arg(StandardPaths::location(StandardPaths::kCachePath), "DesktopEntries.cache");
+}
+
 QString MimesAppsManager::getDDEMimeTypeFile()
 {
     return QString("%1/%2/%3").arg(getMimeInfoCacheFileRootPath(), "deepin", "dde-mimetype.list");
@@ -471,64 +491,28 @@ QMap<QString, DesktopFile> MimesAppsManager::getDesktopObjs()
 void MimesAppsManager::initMimeTypeApps()
 {
     qCDebug(logDFMBase) << "getMimeTypeApps in" << QThread::currentThread() << qApp->thread();
-    DesktopFiles.clear();
-    DesktopObjs.clear();
-    DDE_MimeTypes.clear();
+    // called by the worker and the menus, the maps are built by one of them at a time
+    static QMutex mutex;
+    static DesktopEntryIndex::FileKey mimeInfoCacheKey;
+    QMutexLocker lk(&mutex);
 
-    QMap<QString, QSet<QString>> mimeAppsSet;
+    DDE_MimeTypes.clear();
     loadDDEMimeTypes();
-    for (const QString &desktopFolder : getApplicationsFolders()) {
-        QDirIterator it(desktopFolder, QStringList("*.desktop"), QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
-        while (it.hasNext()) {
-            it.next();
-            const QString &filePath = it.filePath();
-            DesktopFile desktopFile(filePath);
-            if (desktopFile.isNoShow())
-                continue;
 
-            DesktopFiles.append(filePath);
-            DesktopObjs.insert(filePath, desktopFile);
-            QStringList mimeTypes = desktopFile.desktopMimeType();
-            QString fileName = QFileInfo(filePath).fileName();
-            if (DDE_MimeTypes.contains(fileName)) {
-                mimeTypes.append(DDE_MimeTypes.value(fileName));
-            }
-
-            for (const QString &mimeType : mimeTypes) {
-                if (!mimeType.isEmpty()) {
-                    QSet<QString> apps;
-                    if (mimeAppsSet.contains(mimeType)) {
-                        apps = mimeAppsSet.value(mimeType);
-                        apps.insert(filePath);
-                    } else {
-                        apps.insert(filePath);
-                    }
-                    mimeAppsSet.insert(mimeType, apps);
-                }
-            }
-        }
+    // only the desktop files changed are read again, the maps are kept if nothing is changed
+    DesktopEntryIndex *index = DesktopEntryIndex::instance();
+    const bool changed = index->update(DDE_MimeTypes);
+    if (changed) {
+        DesktopFiles = index->desktopFiles();
+        DesktopObjs = index->desktopObjs();
+        MimeApps = index->mimeApps();
     }
 
-    for (const QString &key : mimeAppsSet.keys()) {
-        QSet<QString> apps = mimeAppsSet.value(key);
-        QStringList orderApps;
-        if (apps.count() > 1) {
-            QFileInfoList fileInfos;
-            for (const QString &app : apps) {
-                QFileInfo info(app);
-                fileInfos.append(info);
-            }
-
-            std::sort(fileInfos.begin(), fileInfos.end(), MimesAppsManager::lessByDateTime);
-
-            for (const QFileInfo &info : fileInfos) {
-                orderApps.append(info.absoluteFilePath());
-            }
-        } else {
-            orderApps.append(apps.toList());
-        }
-        MimeApps.insert(key, orderApps);
-    }
+    DesktopEntryIndex::FileKey cacheKey;
+    DesktopEntryIndex::makeKey(getMimeInfoCacheFilePath(), &cacheKey);
+    if (!changed && cacheKey == mimeInfoCacheKey)
+        return;
+    mimeInfoCacheKey = cacheKey;
 
     //check mime apps from cache
     QFile f(getMimeInfoCacheFilePath());
@@ -574,32 +558,28 @@ void MimesAppsManager::initMimeTypeApps()
         const QString path = QString("%1/%2").arg(mimeInfoCacheRootPath, desktop);
         if (!QFile::exists(path))
             continue;
-        DesktopFile df(path);
-        AudioMimeApps.insert(path, df);
+        AudioMimeApps.insert(path, desktopFileOf(path));
     }
 
     for (const QString &desktop : imageDeksopList) {
         const QString path = QString("%1/%2").arg(mimeInfoCacheRootPath, desktop);
         if (!QFile::exists(path))
             continue;
-        DesktopFile df(path);
-        ImageMimeApps.insert(path, df);
+        ImageMimeApps.insert(path, desktopFileOf(path));
     }
 
     for (const QString &desktop : textDekstopList) {
         const QString path = QString("%1/%2").arg(mimeInfoCacheRootPath, desktop);
         if (!QFile::exists(path))
             continue;
-        DesktopFile df(path);
-        TextMimeApps.insert(path, df);
+        TextMimeApps.insert(path, desktopFileOf(path));
     }
 
     for (const QString &desktop : videoDesktopList) {
         const QString path = QString("%1/%2").arg(mimeInfoCacheRootPath, desktop);
         if (!QFile::exists(path))
             continue;
-        DesktopFile df(path);
-        VideoMimeApps.insert(path, df);
+        VideoMimeApps.insert(path, desktopFileOf(path));
     }
 
     return;
@@ -661,11 +641,11 @@ bool MimesAppsManager::removeOneDupFromList(QStringList &list, const QString des
         return true;
     }
 
-    const DesktopFile target(desktopFilePath);
+    const DesktopFile &target = desktopFileOf(desktopFilePath);
 
     QMutableStringListIterator iter(list);
     while (iter.hasNext()) {
-        const DesktopFile source(iter.next());
+        const DesktopFile &source = desktopFileOf(iter.next());
 
         if (source.desktopExec() == target.desktopExec() && source.desktopLocalName() == target.desktopLocalName()) {
             iter.remove();
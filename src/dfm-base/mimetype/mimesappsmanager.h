@@ -85,6 +85,7 @@ public:
     static QString getMimeInfoCacheFileRootPath();
     static QString getDesktopFilesCacheFile();
     static QString getDesktopIconsCacheFile();
+    static QString getDesktopEntryCacheFile();
     static QString getDDEMimeTypeFile();
     static QMap<QString, DesktopFile> getDesktopObjs();
     static void initMimeTypeApps();
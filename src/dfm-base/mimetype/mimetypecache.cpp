@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "mimetypecache.h"
+
+#include <QFile>
+
+#include <sys/stat.h>
+
+using namespace dfmbase;
+
+Q_GLOBAL_STATIC(MimeTypeCache, globalMimeTypeCache)
+
+bool MimeTypeCache::FileKey::operator==(const FileKey &other) const
+{
+    return inode == other.inode && device == other.device
+            && mtimeSec == other.mtimeSec && mtimeNsec == other.mtimeNsec
+            && ctimeSec == other.ctimeSec && ctimeNsec == other.ctimeNsec
+            && size == other.size && mode == other.mode && fileName == other.fileName;
+}
+
+uint dfmbase::qHash(const MimeTypeCache::FileKey &key, uint seed)
+{
+    return ::qHash(key.inode, seed) ^ ::qHash(key.device, seed)
+            ^ ::qHash(key.mtimeSec ^ (key.mtimeNsec << 1), seed)
+            ^ ::qHash(key.ctimeSec ^ (key.ctimeNsec << 1), seed)
+            ^ ::qHash(key.size, seed) ^ ::qHash(key.fileName, seed) ^ static_cast<uint>(key.mode);
+}
+
+MimeTypeCache::MimeTypeCache()
+    : names(kDefaultCapacity)
+{
+}
+
+MimeTypeCache *MimeTypeCache::instance()
+{
+    return globalMimeTypeCache;
+}
+
+/*!
+ * \brief make the cache key of \a filePath, it follows symlinks as QMimeDatabase does.
+ * Directories and the lookups of MatchExtension are not cached, they are resolved without reading.
+ */
+bool MimeTypeCache::makeKey(const QString &filePath, QMimeDatabase::MatchMode mode, FileKey *key)
+{
+    if (!key || filePath.isEmpty() || mode == QMimeDatabase::MatchExtension)
+        return false;
+
+    struct stat statBuffer;
+    if (::stat(QFile::encodeName(filePath).constData(), &statBuffer) != 0)
+        return false;
+
+    if (S_ISDIR(statBuffer.st_mode))
+        return false;
+
+    key->device = static_cast<quint64>(statBuffer.st_dev);
+    key->inode = static_cast<quint64>(statBuffer.st_ino);
+    key->mtimeSec = static_cast<qint64>(statBuffer.st_mtim.tv_sec);
+    key->mtimeNsec = static_cast<qint64>(statBuffer.st_mtim.tv_nsec);
+    key->ctimeSec = static_cast<qint64>(statBuffer.st_ctim.tv_sec);
+    key->ctimeNsec = static_cast<qint64>(statBuffer.st_ctim.tv_nsec);
+    key->size = static_cast<qint64>(statBuffer.st_size);
+    // a rename keeps the inode, the name of link is matched rather than its target as QMimeDatabase does
+    key->fileName = filePath.mid(filePath.lastIndexOf('/') + 1);
+    key->mode = mode;
+    return true;
+}
+
+QString MimeTypeCache::value(const FileKey &key)
+{
+    QMutexLocker lk(&mutex);
+    if (QString *name = names.object(key)) {
+        ++hits;
+        return *name;
+    }
+
+    ++misses;
+    return QString();
+}
+
+void MimeTypeCache::insert(const FileKey &key, const QString &mimeName)
+{
+    if (mimeName.isEmpty())
+        return;
+
+    QMutexLocker lk(&mutex);
+    names.insert(key, new QString(mimeName));
+}
+
+void MimeTypeCache::clear()
+{
+    QMutexLocker lk(&mutex);
+    names.clear();
+}
+
+void MimeTypeCache::setCapacity(int capacity)
+{
+    QMutexLocker lk(&mutex);
+    names.setMaxCost(capacity);
+}
+
+quint64 MimeTypeCache::hitCount() const
+{
+    return hits;
+}
+
+quint64 MimeTypeCache::missCount() const
+{
+    return misses;
+}
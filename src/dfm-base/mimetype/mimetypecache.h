@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MIMETYPECACHE_H
+#define MIMETYPECACHE_H
+
+#include <dfm-base/dfm_base_global.h>
+
+#include <QCache>
+#include <QMimeDatabase>
+#include <QMutex>
+
+#include <atomic>
+
+namespace dfmbase {
+
+/*!
+ * \brief The MimeTypeCache class caches the mime type name of files for the whole process.
+ * A file is identified by its name, device, inode, modify time, change time and size, so a file
+ * changed, renamed or reached by another hard link misses the cache and is matched again by QMimeDatabase.
+ * The lookups matching the extension only are not cached, they never read the file.
+ */
+class MimeTypeCache
+{
+    Q_DISABLE_COPY(MimeTypeCache)
+
+public:
+    struct FileKey
+    {
+        quint64 device { 0 };
+        quint64 inode { 0 };
+        qint64 mtimeSec { 0 };
+        qint64 mtimeNsec { 0 };
+        qint64 ctimeSec { 0 };
+        qint64 ctimeNsec { 0 };
+        qint64 size { 0 };
+        QString fileName;   // the mime type is matched by the name first
+        int mode { QMimeDatabase::MatchDefault };
+
+        bool operator==(const FileKey &other) const;
+    };
+
+    static constexpr int kDefaultCapacity { 100000 };
+
+    MimeTypeCache();
+    static MimeTypeCache *instance();
+
+    static bool makeKey(const QString &filePath, QMimeDatabase::MatchMode mode, FileKey *key);
+
+    QString value(const FileKey &key);
+    void insert(const FileKey &key, const QString &mimeName);
+    void clear();
+    void setCapacity(int capacity);
+
+    quint64 hitCount() const;
+    quint64 missCount() const;
+
+private:
+    QMutex mutex;
+    QCache<FileKey, QString> names;
+    std::atomic<quint64> hits { 0 };
+    std::atomic<quint64> misses { 0 };
+};
+
+uint qHash(const MimeTypeCache::FileKey &key, uint seed = 0);
+
+}
+
+#endif   // MIMETYPECACHE_H
@@ -0,0 +1,108 @@
+# Generate the pinyin lookup table of chinese2pinyin.cpp from pinyin.dict at build time.
+#
+# In a project:  include this file and call dfm_generate_pinyin_table(<sources variable>),
+#                pinyintable.h is generated in the current binary dir and added to the sources.
+# As a script:   cmake -DDICT_FILE=<pinyin.dict> -DOUTPUT_FILE=<pinyintable.h> -P pinyintable.cmake
+
+if (CMAKE_SCRIPT_MODE_FILE)
+    # each line of dict is "<hex code>:<syllable>", the codes are ascending
+    file(STRINGS ${DICT_FILE} DICT_LINES REGEX "^0x[0-9a-fA-F]+:[a-z0-9]+$")
+
+    set(CODES "")
+    set(OFFSETS "")
+    set(POOL "")
+    set(POOL_SIZE 0)
+    set(COUNT 0)
+    set(LAST_KEY "")
+    foreach(LINE IN LISTS DICT_LINES)
+        string(FIND "${LINE}" ":" SEP)
+        string(SUBSTRING "${LINE}" 0 ${SEP} CODE)
+        math(EXPR START "${SEP} + 1")
+        string(SUBSTRING "${LINE}" ${START} -1 SYLLABLE)
+        string(TOLOWER "${CODE}" CODE)
+
+        # the table is searched by binary search, the codes are compared after padded to the same length
+        string(SUBSTRING "${CODE}" 2 -1 KEY)
+        string(LENGTH "${KEY}" KEY_LENGTH)
+        while(KEY_LENGTH LESS 8)
+            string(PREPEND KEY "0")
+            math(EXPR KEY_LENGTH "${KEY_LENGTH} + 1")
+        endwhile()
+        if (NOT LAST_KEY STREQUAL "" AND NOT LAST_KEY STRLESS KEY)
+            message(FATAL_ERROR "${DICT_FILE}: ${CODE} is not in ascending order")
+        endif()
+        set(LAST_KEY ${KEY})
+        # the characters are looked up by QChar, the codes out of BMP are never matched
+        if ("0000ffff" STRLESS KEY)
+            message(FATAL_ERROR "${DICT_FILE}: ${CODE} is out of 16 bits")
+        endif()
+
+        # the same syllables share one string in the pool
+        if (NOT DEFINED OFFSET_OF_${SYLLABLE})
+            set(OFFSET_OF_${SYLLABLE} ${POOL_SIZE})
+            string(APPEND POOL "\n    \"${SYLLABLE}\\0\"")
+            string(LENGTH "${SYLLABLE}" SYLLABLE_LENGTH)
+            math(EXPR POOL_SIZE "${POOL_SIZE} + ${SYLLABLE_LENGTH} + 1")
+        endif()
+
+        math(EXPR COLUMN "${COUNT} % 8")
+        if (COLUMN EQUAL 0)
+            string(APPEND CODES "\n   ")
+            string(APPEND OFFSETS "\n   ")
+        endif()
+        string(APPEND CODES " ${CODE},")
+        string(APPEND OFFSETS " ${OFFSET_OF_${SYLLABLE}},")
+        math(EXPR COUNT "${COUNT} + 1")
+    endforeach()
+
+    if (COUNT EQUAL 0)
+        message(FATAL_ERROR "${DICT_FILE}: no pinyin found")
+    endif()
+    if (NOT POOL_SIZE LESS 65536)
+        message(FATAL_ERROR "${DICT_FILE}: the syllables are too many for 16 bits offsets")
+    endif()
+
+    file(WRITE ${OUTPUT_FILE}
+"// Generated from pinyin.dict by pinyintable.cmake, do not edit.
+
+#ifndef PINYINTABLE_H
+#define PINYINTABLE_H
+
+#include <cstdint>
+
+namespace Pinyin {
+
+constexpr int kPinyinCount { ${COUNT} };
+
+// the codes of chinese characters, ascending
+constexpr uint16_t kPinyinCodes[kPinyinCount] {${CODES}
+};
+
+// the offsets of syllables of the codes in kPinyinPool
+constexpr uint16_t kPinyinOffsets[kPinyinCount] {${OFFSETS}
+};
+
+// the syllables ended with '\\0'
+constexpr char kPinyinPool[] {${POOL}
+};
+
+}
+
+#endif   // PINYINTABLE_H
+")
+    return()
+endif()
+
+set(DFM_PINYIN_TABLE_SCRIPT ${CMAKE_CURRENT_LIST_FILE})
+set(DFM_PINYIN_DICT_FILE ${CMAKE_CURRENT_LIST_DIR}/pinyin.dict)
+
+function(dfm_generate_pinyin_table SOURCES_VAR)
+    set(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/pinyintable.h)
+    add_custom_command(
+        OUTPUT ${OUTPUT}
+        COMMAND ${CMAKE_COMMAND} -DDICT_FILE=${DFM_PINYIN_DICT_FILE} -DOUTPUT_FILE=${OUTPUT} -P ${DFM_PINYIN_TABLE_SCRIPT}
+        DEPENDS ${DFM_PINYIN_DICT_FILE} ${DFM_PINYIN_TABLE_SCRIPT}
+        COMMENT "Generating pinyin table from ${DFM_PINYIN_DICT_FILE}"
+        VERBATIM)
+    set(${SOURCES_VAR} ${${SOURCES_VAR}} ${OUTPUT} PARENT_SCOPE)
+endfunction()
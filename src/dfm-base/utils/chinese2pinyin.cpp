@@ -3,62 +3,71 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "chinese2pinyin.h"
+#include "pinyintable.h"   // generated from qrc/chinese2pinyin/pinyin.dict
 
-#include <QHash>
-#include <QTextStream>
-#include <QFile>
+#include <algorithm>
 
 namespace Pinyin {
 
-static QHash<uint, QString> dict = {};
+static const char *findPinyin(ushort code) {
+    if (code < kPinyinCodes[0])
+        return nullptr;
 
-const char kDictFile[] = ":/misc/pinyin.dict";
+    const uint16_t *end = kPinyinCodes + kPinyinCount;
+    const uint16_t *it = std::lower_bound(kPinyinCodes, end, code);
+    if (it == end || *it != code)
+        return nullptr;
 
-void InitDict() {
-    if (!dict.isEmpty()) {
-        return;
-    }
-
-    dict.reserve(25333);
-
-    QFile file(kDictFile);
-
-    if (!file.open(QIODevice::ReadOnly))
-        return;
-
-    QByteArray content = file.readAll();
-
-    file.close();
-
-    QTextStream stream(&content, QIODevice::ReadOnly);
+    return kPinyinPool + kPinyinOffsets[it - kPinyinCodes];
+}
 
-    while (!stream.atEnd()) {
-        const QString line = stream.readLine();
-        const QStringList items = line.split(QChar(':'));
+static bool hasChinese(const QString& words) {
+    return std::any_of(words.cbegin(), words.cend(), [](const QChar& ch) {
+        return ch.unicode() >= kPinyinCodes[0];
+    });
+}
 
-        if (items.size() == 2) {
-            dict.insert(static_cast<uint>(items[0].toInt(nullptr, 16)), items[1]);
+static void appendPinyin(const QString& words, QString* result) {
+    for (const QChar& ch : words) {
+        const char *pinyin = findPinyin(ch.unicode());
+        if (pinyin) {
+            result->append(QLatin1String(pinyin));
+        } else {
+            result->append(ch);
         }
     }
 }
 
 QString Chinese2Pinyin(const QString& words) {
-    InitDict();
+    // nothing to translate, the words are shared
+    if (!hasChinese(words))
+        return words;
 
     QString result;
+    result.reserve(words.size() * 4);
+    appendPinyin(words, &result);
+
+    return result;
+}
 
-    for (int i = 0; i < words.length(); ++i) {
-        const uint key = words.at(i).unicode();
-        auto find_result = dict.find(key);
+QStringList toPinyinKeys(const QStringList& words) {
+    QStringList keys;
+    keys.reserve(words.size());
 
-        if (find_result != dict.end()) {
-            result.append(find_result.value());
-        } else {
-            result.append(words.at(i));
+    QString buffer;
+    for (const QString& word : words) {
+        if (!hasChinese(word)) {
+            keys.append(word);
+            continue;
         }
+
+        // the buffer is not shared by the keys, it keeps its capacity after resized
+        buffer.resize(0);
+        appendPinyin(word, &buffer);
+        keys.append(QString(buffer.constData(), buffer.size()));
     }
 
-    return result;
+    return keys;
 }
 
 }  // namespace Pinyin end
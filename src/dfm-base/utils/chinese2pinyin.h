@@ -6,9 +6,13 @@
 #define CHINESE_2_PINYIN_H
 
 #include <QString>
+#include <QStringList>
 
 namespace Pinyin {
+// the pinyin table is generated at build time, the functions are thread safe
 QString Chinese2Pinyin(const QString& words);
+// the pinyin of each words, the same as Chinese2Pinyin but the buffer is reused for the batch
+QStringList toPinyinKeys(const QStringList& words);
 };
 
 #endif  // CHINESE_2_PINYIN_H
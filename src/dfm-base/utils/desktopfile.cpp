@@ -7,6 +7,7 @@
 
 #include <QFile>
 #include <QSettings>
+#include <QDataStream>
 #include <QDebug>
 
 using namespace dfmbase;
@@ -157,3 +158,23 @@ QStringList DesktopFile::desktopMimeType() const
     return mimeType;
 }
 //---------------------------------------------------------------------------
+
+namespace dfmbase {
+
+QDataStream &operator<<(QDataStream &stream, const DesktopFile &desktop)
+{
+    stream << desktop.fileName << desktop.name << desktop.genericName << desktop.localName
+           << desktop.exec << desktop.icon << desktop.type << desktop.categories << desktop.mimeType
+           << desktop.deepinId << desktop.deepinVendor << desktop.noDisplay << desktop.hidden;
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, DesktopFile &desktop)
+{
+    stream >> desktop.fileName >> desktop.name >> desktop.genericName >> desktop.localName
+           >> desktop.exec >> desktop.icon >> desktop.type >> desktop.categories >> desktop.mimeType
+           >> desktop.deepinId >> desktop.deepinVendor >> desktop.noDisplay >> desktop.hidden;
+    return stream;
+}
+
+}
@@ -9,6 +9,10 @@
 
 #include <QStringList>
 
+QT_BEGIN_NAMESPACE
+class QDataStream;
+QT_END_NAMESPACE
+
 /**
  * @class DesktopFile
  * @brief Represents a linux desktop file
@@ -36,6 +40,10 @@ public:
     QStringList desktopCategories() const;
     QStringList desktopMimeType() const;
 
+    // the parsed desktop file is saved to and loaded from the cache
+    friend QDataStream &operator<<(QDataStream &stream, const DesktopFile &desktop);
+    friend QDataStream &operator>>(QDataStream &stream, DesktopFile &desktop);
+
 private:
     QString fileName;
     QString name;
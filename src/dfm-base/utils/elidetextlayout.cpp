@@ -11,11 +11,101 @@
 #include <QTextLayout>
 #include <QTextBlock>
 #include <QDebug>
+#include <QCache>
+#include <QMutex>
+#include <QGuiApplication>
 
 #include <dfm-base/dfm_base_global.h>
 
 using namespace dfmbase;
 
+struct ElideTextLayout::LaidOutText
+{
+    QSharedPointer<QTextDocument> document;   // its first block holds the laid out lines
+    QSharedPointer<QTextLayout> elided;   // the elided last line
+    int lineCount = 0;   // the lines drawn from the first block
+    QList<QRectF> rects;   // at (0, 0)
+    QStringList lines;
+};
+
+namespace {
+struct LayoutKey
+{
+    QString text;
+    QFont font;
+    int lineHeight = 0;
+    uint alignment = 0;
+    uint wrapMode = 0;
+    int direction = 0;
+    int elideMode = 0;
+    QSizeF size;
+    qreal dpr = 1.0;
+
+    bool operator==(const LayoutKey &other) const
+    {
+        return text == other.text && lineHeight == other.lineHeight
+                && alignment == other.alignment && wrapMode == other.wrapMode
+                && direction == other.direction && elideMode == other.elideMode
+                && size == other.size && qFuzzyCompare(dpr, other.dpr)
+                && font == other.font;
+    }
+};
+
+uint qHash(const LayoutKey &key, uint seed = 0)
+{
+    return ::qHash(key.text, seed) ^ ::qHash(key.font, seed)
+            ^ ::qHash(qRound(key.size.width() * 64), seed) ^ ::qHash(qRound(key.size.height() * 64), seed)
+            ^ (static_cast<uint>(key.elideMode) << 3) ^ (key.wrapMode << 7) ^ static_cast<uint>(key.lineHeight << 11);
+}
+
+// the laid out text shared by all delegates in this process.
+class LayoutCache
+{
+public:
+    static constexpr int kCapacity { 2048 };
+
+    LayoutCache()
+        : layouts(kCapacity)
+    {
+        // the font is a part of key, the old layouts are useless after the font changed.
+        if (qGuiApp) {
+            QObject::connect(qGuiApp, &QGuiApplication::fontChanged, qGuiApp, [this]() {
+                clear();
+            });
+        }
+    }
+
+    QSharedPointer<ElideTextLayout::LaidOutText> find(const LayoutKey &key)
+    {
+        QMutexLocker lk(&mutex);
+        auto laid = layouts.object(key);
+        return laid ? *laid : QSharedPointer<ElideTextLayout::LaidOutText>();
+    }
+
+    void insert(const LayoutKey &key, const QSharedPointer<ElideTextLayout::LaidOutText> &laid)
+    {
+        QMutexLocker lk(&mutex);
+        layouts.insert(key, new QSharedPointer<ElideTextLayout::LaidOutText>(laid));
+    }
+
+    void clear()
+    {
+        QMutexLocker lk(&mutex);
+        layouts.clear();
+    }
+
+private:
+    QMutex mutex;
+    QCache<LayoutKey, QSharedPointer<ElideTextLayout::LaidOutText>> layouts;
+};
+
+LayoutCache *layoutCache()
+{
+    static LayoutCache cache;
+    return &cache;
+}
+}
+
 ElideTextLayout::ElideTextLayout(const QString &text)
     : document(new QTextDocument)
 {
@@ -47,43 +137,72 @@ QString ElideTextLayout::text() const
 
 QList<QRectF> ElideTextLayout::layout(const QRectF &rect, Qt::TextElideMode elideMode, QPainter *painter, const QBrush &background, QStringList *textLines)
 {
-    QList<QRectF> ret;
-    QTextLayout *lay = document->firstBlock().layout();
+    const QString &plainText = text();
+
+    // the document may be decorated by others (e.g. tags), only plain text is cached.
+    if (document->blockCount() != 1 || plainText.contains(QChar::ObjectReplacementCharacter)) {
+        // not owned, the document is deleted by this.
+        QSharedPointer<QTextDocument> doc(document, [](QTextDocument *) {});
+        auto laid = layoutText(doc, rect.size(), elideMode);
+        return laid ? drawLaidOut(*laid, rect.topLeft(), painter, background, textLines) : QList<QRectF>();
+    }
+
+    LayoutKey key;
+    key.text = plainText;
+    key.font = attribute<QFont>(kFont);
+    key.lineHeight = attribute<int>(kLineHeight);
+    key.alignment = attribute<uint>(kAlignment);
+    key.wrapMode = attribute<uint>(kWrapMode);
+    key.direction = static_cast<int>(attribute<Qt::LayoutDirection>(kTextDirection));
+    key.elideMode = elideMode;
+    key.size = rect.size();
+    key.dpr = qGuiApp ? qGuiApp->devicePixelRatio() : 1.0;
+
+    LayoutCache *cache = layoutCache();
+    auto laid = cache->find(key);
+    if (!laid) {
+        laid = layoutText(QSharedPointer<QTextDocument>(document->clone()), rect.size(), elideMode);
+        if (!laid)
+            return {};
+        cache->insert(key, laid);
+    }
+
+    return drawLaidOut(*laid, rect.topLeft(), painter, background, textLines);
+}
+
+void ElideTextLayout::clearLayoutCache()
+{
+    layoutCache()->clear();
+}
+
+/*!
+ * \brief lay out the first block of \a doc in \a size at (0, 0), the last visible line is elided
+ * if there are more lines than the height.
+ */
+QSharedPointer<ElideTextLayout::LaidOutText> ElideTextLayout::layoutText(const QSharedPointer<QTextDocument> &doc, const QSizeF &size, Qt::TextElideMode elideMode)
+{
+    QTextLayout *lay = doc->firstBlock().layout();
     if (!lay) {
-        qCWarning(logDFMBase) << "invaild block" << document->firstBlock().text();
-        return ret;
+        qCWarning(logDFMBase) << "invaild block" << doc->firstBlock().text();
+        return nullptr;
     }
 
+    QSharedPointer<LaidOutText> laid(new LaidOutText);
+    laid->document = doc;
+
     initLayoutOption(lay);
     int textLineHeight = attribute<int>(kLineHeight);
-    QSizeF size = rect.size();
-    QPointF offset = rect.topLeft();
+    QPointF offset(0, 0);
     qreal curHeight = 0;
 
-    // for draw background.
-    QRectF lastLineRect;
     QString elideText;
-    QString curText = text();
-    auto processLine = [this, &ret, painter, &lastLineRect, background, textLineHeight, &curText, textLines](QTextLine &line) {
+    const QString curText = doc->toPlainText();
+    auto processLine = [&laid, textLineHeight](QTextLine &line, const QString &lineText) {
         QRectF lRect = line.naturalTextRect();
         lRect.setHeight(textLineHeight);
 
-        ret.append(lRect);
-        if (textLines) {
-            const auto &t = curText.mid(line.textStart(), line.textLength());
-            textLines->append(t);
-        }
-
-        // draw
-        if (painter) {
-            // draw background
-            if (background.style() != Qt::NoBrush) {
-                lastLineRect = drawLineBackground(painter, lRect, lastLineRect, background);
-            }
-
-            // draw text line
-            line.draw(painter, QPoint(0, 0));
-        }
+        laid->rects.append(lRect);
+        laid->lines.append(lineText.mid(line.textStart(), line.textLength()));
     };
 
     {
@@ -100,14 +219,14 @@ QList<QRectF> ElideTextLayout::layout(const QRectF &rect, Qt::TextElideMode elid
                 if (nextLine.isValid()) {
                     // elide current line.
                     QFontMetrics fm(lay->font());
-                    elideText = fm.elidedText(text().mid(line.textStart()), elideMode, qRound(size.width()));
-                    curText = elideText;
+                    elideText = fm.elidedText(curText.mid(line.textStart()), elideMode, qRound(size.width()));
                     break;
                 }
                 // next line is empty.
             }
 
-            processLine(line);
+            processLine(line, curText);
+            laid->lineCount++;
 
             // next line
             line = lay->createLine();
@@ -119,25 +238,57 @@ QList<QRectF> ElideTextLayout::layout(const QRectF &rect, Qt::TextElideMode elid
 
     // process last elided line.
     if (!elideText.isEmpty()) {
-        QTextLayout newlay;
-        newlay.setFont(lay->font());
+        laid->elided.reset(new QTextLayout);
+        QTextLayout *newlay = laid->elided.data();
+        newlay->setFont(lay->font());
         {
             auto oldWrap = static_cast<QTextOption::WrapMode>(attribute<uint>(kWrapMode));
             setAttribute(kWrapMode, static_cast<uint>(QTextOption::NoWrap));
-            initLayoutOption(&newlay);
+            initLayoutOption(newlay);
 
             // restore
             setAttribute(kWrapMode, oldWrap);
         }
 
-        newlay.setText(elideText);
-        newlay.beginLayout();
-        auto line = newlay.createLine();
+        newlay->setText(elideText);
+        newlay->beginLayout();
+        auto line = newlay->createLine();
         line.setLineWidth(size.width() - 1);
         line.setPosition(offset);
 
-        processLine(line);
-        newlay.endLayout();
+        processLine(line, elideText);
+        newlay->endLayout();
+    }
+
+    return laid;
+}
+
+QList<QRectF> ElideTextLayout::drawLaidOut(const LaidOutText &laid, const QPointF &offset, QPainter *painter, const QBrush &background, QStringList *textLines) const
+{
+    QList<QRectF> ret;
+    QTextLayout *lay = laid.document->firstBlock().layout();
+
+    // for draw background.
+    QRectF lastLineRect;
+    for (int i = 0; i < laid.rects.size(); ++i) {
+        const QRectF lRect = laid.rects.at(i).translated(offset);
+        ret.append(lRect);
+        if (textLines)
+            textLines->append(laid.lines.at(i));
+
+        // draw
+        if (painter) {
+            // draw background
+            if (background.style() != Qt::NoBrush) {
+                lastLineRect = drawLineBackground(painter, lRect, lastLineRect, background);
+            }
+
+            // draw text line
+            if (i < laid.lineCount)
+                lay->lineAt(i).draw(painter, offset);
+            else if (laid.elided)
+                laid.elided->lineAt(0).draw(painter, offset);
+        }
     }
 
     return ret;
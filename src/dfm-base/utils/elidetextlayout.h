@@ -8,6 +8,7 @@
 #include <QString>
 #include <QBrush>
 #include <QVariant>
+#include <QSharedPointer>
 
 class QPainter;
 class QTextDocument;
@@ -32,6 +33,9 @@ public:
     void setText(const QString &text);
     QString text() const;
     QList<QRectF> layout(const QRectF &rect, Qt::TextElideMode elideMode, QPainter *painter = nullptr, const QBrush &background = Qt::NoBrush, QStringList *textLines = nullptr);
+    static void clearLayoutCache();
+
+    struct LaidOutText;
 public:
     inline QTextDocument *documentHandle() {
         return document;
@@ -47,6 +51,8 @@ public:
     }
 
 protected:
+    QSharedPointer<LaidOutText> layoutText(const QSharedPointer<QTextDocument> &doc, const QSizeF &size, Qt::TextElideMode elideMode);
+    QList<QRectF> drawLaidOut(const LaidOutText &laid, const QPointF &offset, QPainter *painter, const QBrush &background, QStringList *textLines) const;
     QRectF drawLineBackground(QPainter *painter, const QRectF &curLineRect, QRectF lastLineRect, const QBrush &brush) const;
     virtual void initLayoutOption(QTextLayout *lay);
 protected:
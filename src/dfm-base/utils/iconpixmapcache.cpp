@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "iconpixmapcache.h"
+
+#include <QtMath>
+
+namespace dfmbase {
+
+bool IconPixmapCache::Key::operator==(const Key &other) const
+{
+    return cacheKey == other.cacheKey && size == other.size
+            && pixelRatio == other.pixelRatio && mode == other.mode
+            && state == other.state && name == other.name && theme == other.theme;
+}
+
+uint qHash(const IconPixmapCache::Key &key, uint seed)
+{
+    return ::qHash(key.name, seed) ^ ::qHash(key.cacheKey, seed)
+            ^ ::qHash(key.size.width() << 16 | key.size.height(), seed)
+            ^ static_cast<uint>(key.pixelRatio << 4 | key.mode << 2 | key.state);
+}
+
+IconPixmapCache &IconPixmapCache::instance()
+{
+    static IconPixmapCache ins;
+    return ins;
+}
+
+IconPixmapCache::IconPixmapCache()
+    : pixmaps(kDefaultBudgetKB)
+{
+}
+
+/*!
+ * \brief return the pixmap of \a icon in \a size, its device pixel ratio is \a pixelRatio.
+ */
+QPixmap IconPixmapCache::pixmap(const QIcon &icon, const QSize &size, qreal pixelRatio, QIcon::Mode mode, QIcon::State state)
+{
+    if (icon.isNull() || size.width() <= 0 || size.height() <= 0)
+        return QPixmap();
+
+    Key key;
+    key.name = icon.name();
+    if (key.name.isEmpty())
+        key.cacheKey = icon.cacheKey();
+    else
+        key.theme = QIcon::themeName();
+    key.size = size;
+    key.pixelRatio = qRound(pixelRatio * 100);
+    key.mode = mode;
+    key.state = state;
+
+    if (QPixmap *px = pixmaps.object(key))
+        return *px;
+
+    QPixmap px = icon.pixmap(size, mode, state);
+    px.setDevicePixelRatio(pixelRatio);
+
+    // the cost is in KB.
+    const int cost = qMax(1, px.width() * px.height() * qMax(px.depth(), 8) / 8 / 1024);
+    pixmaps.insert(key, new QPixmap(px), cost);
+    return px;
+}
+
+void IconPixmapCache::clear()
+{
+    pixmaps.clear();
+}
+
+void IconPixmapCache::setBudget(int kb)
+{
+    pixmaps.setMaxCost(kb);
+}
+
+}
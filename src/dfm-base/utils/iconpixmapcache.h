@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ICONPIXMAPCACHE_H
+#define ICONPIXMAPCACHE_H
+
+#include <dfm-base/dfm_base_global.h>
+
+#include <QCache>
+#include <QIcon>
+#include <QPixmap>
+
+namespace dfmbase {
+
+/*!
+ * \brief The IconPixmapCache class keeps the pixmaps rendered from icons for painting items.
+ * Theme icons are keyed by theme and icon name, others (e.g. thumbnails) by QIcon::cacheKey,
+ * together with size, device pixel ratio, mode and state. The pixmaps are limited by a memory budget.
+ * It is used in the gui thread.
+ */
+class IconPixmapCache
+{
+    Q_DISABLE_COPY(IconPixmapCache)
+
+public:
+    static constexpr int kDefaultBudgetKB { 64 * 1024 };
+
+    static IconPixmapCache &instance();
+
+    IconPixmapCache();
+    QPixmap pixmap(const QIcon &icon, const QSize &size, qreal pixelRatio,
+                   QIcon::Mode mode = QIcon::Normal, QIcon::State state = QIcon::Off);
+    void clear();
+    void setBudget(int kb);
+
+private:
+    struct Key
+    {
+        QString theme;
+        QString name;
+        qint64 cacheKey { 0 };
+        QSize size;
+        int pixelRatio { 100 };
+        int mode { 0 };
+        int state { 0 };
+
+        bool operator==(const Key &other) const;
+    };
+    friend uint qHash(const Key &key, uint seed);
+
+    QCache<Key, QPixmap> pixmaps;
+};
+
+}
+
+#endif   // ICONPIXMAPCACHE_H
@@ -5,6 +5,7 @@
 #include "fileoperations.h"
 #include "fileoperationsevent/fileoperationseventreceiver.h"
 #include "fileoperationsevent/trashfileeventreceiver.h"
+#include "fileoperations/fileoperationutils/copyjournal.h"
 
 #include <dfm-base/base/urlroute.h>
 #include <dfm-base/base/schemefactory.h>
@@ -34,6 +35,9 @@ bool FileOperations::start()
     if (!ret)
         fmWarning() << "create dconfig failed: " << err;
 
+    // the jobs of these journals are not resumed any more
+    CopyJournal::removeExpired(QDateTime::currentDateTime().addDays(-CopyJournal::kExpiredDays));
+
     return true;
 }
 
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "docopyfilesworker.h"
+#include "fileoperations/fileoperationutils/copyjournal.h"
 #include <dfm-base/base/schemefactory.h>
 #include <dfm-base/interfaces/abstractdiriterator.h>
 #include <dfm-base/utils/clipboard.h>
@@ -55,9 +56,20 @@ bool DoCopyFilesWorker::doWork()
         return false;
     }
 
+    // wait for the jobs on the same devices
+    QList<QUrl> deviceUrls { sourceUrls };
+    deviceUrls.append(targetOrgUrl);
+    if (!waitForDevices(deviceUrls)) {
+        endWork();
+        return false;
+    }
+
     // init copy file ways
     initCopyWay();
 
+    // journal the job to resume it after a crash
+    openJournal();
+
     // do main process
     if (!copyFiles()) {
         endWork();
@@ -144,9 +156,31 @@ void DoCopyFilesWorker::endWork()
     // set dirs permissions
     setAllDirPermisson();
 
+    // the job is ended by itself, it is not resumed
+    if (workData->journal) {
+        workData->journal->remove();
+        workData->journal.reset();
+    }
+
     FileOperateBaseWorker::endWork();
 }
 
+/*!
+ * \brief DoCopyFilesWorker::openJournal open the journal of the job, if the same job did not end
+ * in the last run, the files copied are skipped and the big file in progress is continued
+ */
+void DoCopyFilesWorker::openJournal()
+{
+    if (!targetOrgUrl.isLocalFile())
+        return;
+
+    QSharedPointer<CopyJournal> journal(new CopyJournal(sourceUrls, targetOrgUrl));
+    if (!journal->open())
+        return;
+
+    workData->journal = journal;
+}
+
 bool DoCopyFilesWorker::copyFiles()
 {
     for (const QUrl &url : sourceUrls) {
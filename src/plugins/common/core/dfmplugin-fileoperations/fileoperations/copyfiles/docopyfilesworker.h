@@ -46,6 +46,7 @@ protected:
 
 protected:
     bool copyFiles();
+    void openJournal();
 
 private slots:
     void onUpdateProgress() override;
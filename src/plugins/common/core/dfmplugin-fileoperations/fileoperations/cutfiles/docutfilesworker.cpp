@@ -4,9 +4,11 @@
 
 #include "docutfilesworker.h"
 #include "fileoperations/fileoperationutils/fileoperationsutils.h"
+#include "fileoperations/fileoperationutils/operationscheduler.h"
 
 #include <dfm-base/base/schemefactory.h>
 #include <dfm-base/utils/fileutils.h>
+#include <dfm-base/base/device/deviceutils.h>
 
 #include <dfm-io/dfmio_utils.h>
 
@@ -15,13 +17,22 @@
 #include <QMutex>
 #include <QStorageInfo>
 #include <QQueue>
+#include <QDir>
+#include <QSet>
 #include <QDebug>
 
+#include <cstring>
+
 #include <fcntl.h>
 #include <unistd.h>
+#include <dirent.h>
 #include <sys/stat.h>
 #include <syscall.h>
 
+#ifndef RENAME_NOREPLACE
+#    define RENAME_NOREPLACE (1 << 0)
+#endif
+
 DPFILEOPERATIONS_USE_NAMESPACE
 DoCutFilesWorker::DoCutFilesWorker(QObject *parent)
     : FileOperateBaseWorker(parent)
@@ -43,6 +54,20 @@ bool DoCutFilesWorker::doWork()
     // check progress notify type
     determineCountProcessType();
 
+    // only the files moved to another device are copied, renaming does not wait for the devices
+    const QString &targetDevice = OperationScheduler::deviceOf(targetOrgUrl);
+    const bool crossDevice = std::any_of(leftUrls.cbegin(), leftUrls.cend(), [&targetDevice](const QUrl &url) {
+        return OperationScheduler::deviceOf(url) != targetDevice;
+    });
+    if (crossDevice) {
+        QList<QUrl> deviceUrls { leftUrls };
+        deviceUrls.append(targetOrgUrl);
+        if (!waitForDevices(deviceUrls)) {
+            endWork();
+            return false;
+        }
+    }
+
     // 执行剪切
     if (!cutFiles()) {
         endWork();
@@ -99,9 +124,38 @@ bool DoCutFilesWorker::initArgs()
     return true;
 }
 
+/*!
+ * \brief DoCutFilesWorker::statisticsFilesSize move the files can be renamed into the target directly in batch,
+ * only the files left are walked for their size, so a move within one file system does not read the trees.
+ * \return false if the job is stopped
+ */
+bool DoCutFilesWorker::statisticsFilesSize()
+{
+    leftUrls.clear();
+    batchRenamedSize = 0;
+    if (!renameFilesInBatch(&leftUrls))
+        return false;
+
+    const qint64 renamedCount = sourceUrls.count() - leftUrls.count();
+    if (!leftUrls.isEmpty()) {
+        const QList<QUrl> urls { sourceUrls };
+        sourceUrls = leftUrls;
+        const bool ok = FileOperateBaseWorker::statisticsFilesSize();
+        sourceUrls = urls;
+        if (!ok)
+            return false;
+    }
+
+    // the renamed files are counted as written
+    sourceFilesTotalSize += batchRenamedSize;
+    sourceFilesCount += renamedCount;
+    return true;
+}
+
 bool DoCutFilesWorker::cutFiles()
 {
-    for (const auto &url : sourceUrls) {
+    // the files renamed in batch are done, the others need checking and user interaction one by one
+    for (const auto &url : leftUrls) {
         if (!stateCheck()) {
             return false;
         }
@@ -146,6 +200,142 @@ bool DoCutFilesWorker::cutFiles()
     return true;
 }
 
+/*!
+ * \brief DoCutFilesWorker::renameFilesInBatch move the files on the device of the target by renaming
+ * The target directory is listed once to find the conflicts, the files are renamed by renameat2 with
+ * the fds of their parent directories, no file info is created for them and the directories are not walked.
+ * The files in trash, the symlinks, the special files, the conflicts and the failures (including the file
+ * systems without RENAME_NOREPLACE) are left in \a others for the per-file way.
+ * \param others the urls to cut one by one
+ * \return false if the job is stopped
+ */
+bool DoCutFilesWorker::renameFilesInBatch(QList<QUrl> *others)
+{
+    if (!targetOrgUrl.isValid() || !targetOrgUrl.isLocalFile()) {
+        *others = sourceUrls;
+        return true;
+    }
+
+    const QByteArray &targetPath = QFile::encodeName(targetOrgUrl.path());
+    const int targetFd = ::open(targetPath.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    struct stat targetStat;
+    if (targetFd < 0 || ::fstat(targetFd, &targetStat) != 0) {
+        if (targetFd >= 0)
+            ::close(targetFd);
+        *others = sourceUrls;
+        return true;
+    }
+
+    // the names in the target, the conflicts are resolved against this listing
+    QSet<QByteArray> targetNames;
+    {
+        const int listFd = ::dup(targetFd);
+        DIR *dir = listFd >= 0 ? ::fdopendir(listFd) : nullptr;
+        if (!dir) {
+            if (listFd >= 0)
+                ::close(listFd);
+            ::close(targetFd);
+            *others = sourceUrls;
+            return true;
+        }
+        while (struct dirent *entry = ::readdir(dir))
+            targetNames.insert(QByteArray(entry->d_name));
+        ::closedir(dir);
+    }
+
+    // the sources are grouped by the parent directory, every parent is opened once
+    QList<QString> parents;
+    QHash<QString, QList<QUrl>> groups;
+    for (const QUrl &url : sourceUrls) {
+        if (!url.isValid() || !url.isLocalFile() || FileUtils::isTrashFile(url)) {
+            others->append(url);
+            continue;
+        }
+        const QString &parent = QFileInfo(url.path()).absolutePath();
+        if (!groups.contains(parent))
+            parents.append(parent);
+        groups[parent].append(url);
+    }
+
+    const QDir targetDir(targetOrgUrl.path());
+    qint64 renamedCount = 0;
+    bool stopped = false;
+    for (const QString &parent : parents) {
+        const QList<QUrl> &urls = groups.value(parent);
+        const int dirFd = stopped ? -1 : ::open(QFile::encodeName(parent).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        struct stat dirStat;
+        if (dirFd < 0 || ::fstat(dirFd, &dirStat) != 0 || dirStat.st_dev != targetStat.st_dev) {
+            if (dirFd >= 0)
+                ::close(dirFd);
+            others->append(urls);
+            continue;
+        }
+
+        // no inotify event is sent for samba and ftp mounts, their views are notified manually
+        const QUrl &parentUrl = QUrl::fromLocalFile(parent);
+        const bool notifyManually = DeviceUtils::isSamba(parentUrl) || DeviceUtils::isFtp(parentUrl)
+                || DeviceUtils::isSamba(targetOrgUrl) || DeviceUtils::isFtp(targetOrgUrl);
+
+        for (const QUrl &url : urls) {
+            if (stopped || !stateCheck()) {
+                stopped = true;
+                others->append(url);
+                continue;
+            }
+
+            const QByteArray &name = QFile::encodeName(url.fileName());
+            struct stat st;
+            if (name.isEmpty() || targetNames.contains(name)
+                || ::fstatat(dirFd, name.constData(), &st, AT_SYMLINK_NOFOLLOW) != 0
+                || st.st_dev != targetStat.st_dev
+                || (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode))
+                || (S_ISDIR(st.st_mode) && (FileUtils::isHigherHierarchy(url, targetOrgUrl) || url == targetOrgUrl))) {
+                others->append(url);
+                continue;
+            }
+
+            // the target may be created after the listing, so it is never renamed without RENAME_NOREPLACE
+            const long ret = ::syscall(SYS_renameat2, dirFd, name.constData(), targetFd, name.constData(), RENAME_NOREPLACE);
+            if (ret != 0) {
+                fmDebug() << "rename in batch failed, cut it alone, url: " << url << " error: " << strerror(errno);
+                others->append(url);
+                continue;
+            }
+
+            const QUrl &newUrl = QUrl::fromLocalFile(targetDir.absoluteFilePath(url.fileName()));
+            targetNames.insert(name);
+            ++renamedCount;
+            completeSourceFiles.append(url);
+            completeTargetFiles.append(newUrl);
+            if (notifyManually) {
+                FileUtils::notifyFileChangeManual(Global::FileNotifyType::kFileDeleted, url);
+                FileUtils::notifyFileChangeManual(Global::FileNotifyType::kFileAdded, newUrl);
+            }
+
+            if (S_ISREG(st.st_mode) && st.st_size > 0) {
+                workData->blockRenameWriteSize += st.st_size;
+                workData->currentWriteSize += st.st_size;
+                batchRenamedSize += st.st_size;
+            } else {
+                // the directory is not walked for its size, it is counted as one page like an empty file
+                workData->zeroOrlinkOrDirWriteSize += FileUtils::getMemoryPageSize();
+                batchRenamedSize += FileUtils::getMemoryPageSize();
+            }
+        }
+        ::close(dirFd);
+    }
+    ::close(targetFd);
+
+    if (renamedCount > 0) {
+        fmInfo() << "renamed in batch: " << renamedCount << " left: " << others->count();
+        // one notify for all the files renamed
+        emitCurrentTaskNotify(sourceUrls.first(), targetOrgUrl);
+        emitCompleteFilesUpdatedNotify(renamedCount);
+    }
+
+    return !stopped;
+}
+
 bool DoCutFilesWorker::doCutFile(const FileInfoPointer &fromInfo, const FileInfoPointer &targetPathInfo)
 {
     // try rename
@@ -277,7 +467,7 @@ bool DoCutFilesWorker::doRenameFile(const FileInfoPointer &sourceInfo, const Fil
     const QUrl &sourceUrl = sourceInfo->urlOf(UrlInfoType::kUrl);
 
     toInfo.reset();
-    if (DFMIO::DFMUtils::deviceNameFromUrl(sourceInfo->urlOf(UrlInfoType::kUrl)) == DFMIO::DFMUtils::deviceNameFromUrl(targetOrgUrl)) {
+    if (OperationScheduler::deviceOf(sourceUrl) == OperationScheduler::deviceOf(targetOrgUrl)) {
         if (!doCheckFile(sourceInfo, targetPathInfo, fileName, toInfo, ok))
             return ok ? *ok : false;
 
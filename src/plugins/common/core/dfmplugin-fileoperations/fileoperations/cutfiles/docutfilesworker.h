@@ -32,10 +32,12 @@ protected:
     bool doWork() override;
     void stop() override;
     bool initArgs() override;
+    bool statisticsFilesSize() override;
     void onUpdateProgress() override;
     void endWork() override;
 
     bool cutFiles();
+    bool renameFilesInBatch(QList<QUrl> *others);
     bool doCutFile(const FileInfoPointer &fromInfo, const FileInfoPointer &targetPathInfo);
     bool doRenameFile(const FileInfoPointer &sourceInfo, const FileInfoPointer &targetPathInfo, FileInfoPointer &toInfo, const QString fileName, bool *ok);
     bool renameFileByHandler(const FileInfoPointer &sourceInfo, const FileInfoPointer &targetInfo);
@@ -45,6 +47,10 @@ protected:
 private:
     bool checkSymLink(const FileInfoPointer &fromInfo);
     bool checkSelf(const FileInfoPointer &fromInfo);
+
+private:
+    QList<QUrl> leftUrls;   // the sources not renamed in batch
+    qint64 batchRenamedSize { 0 };
 };
 DPFILEOPERATIONS_END_NAMESPACE
 
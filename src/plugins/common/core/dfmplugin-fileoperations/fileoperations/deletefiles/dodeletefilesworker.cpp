@@ -4,11 +4,31 @@
 
 #include "dodeletefilesworker.h"
 #include <dfm-base/base/schemefactory.h>
+#include <dfm-base/utils/fileutils.h>
 
 #include <QUrl>
 #include <QDebug>
+#include <QFile>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 DPFILEOPERATIONS_USE_NAMESPACE
+
+// a directory being deleted, it is removed after itself is scanned and all its sub directories are removed.
+struct DoDeleteFilesWorker::LocalDirNode
+{
+    QByteArray path;
+    QSharedPointer<LocalDirNode> parent;
+    QAtomicInt pending { 1 };   // the scanning of itself and the sub directories not removed
+    std::atomic_bool skipped { false };   // some children are skipped, so it can not be removed
+};
+
 DoDeleteFilesWorker::DoDeleteFilesWorker(QObject *parent)
     : AbstractWorker(parent)
 {
@@ -58,38 +78,210 @@ bool DoDeleteFilesWorker::deleteAllFiles()
     return deleteFilesOnOtherDevice();
 }
 /*!
- * \brief DoDeleteFilesWorker::deleteFilesOnCanNotRemoveDevice Delete files on non removable devices
+ * \brief DoDeleteFilesWorker::deleteFilesOnCanNotRemoveDevice Delete files on non removable devices.
+ * The directories are walked with directory fds and the entries are removed by unlinkat,
+ * sub directories are handled by the thread pool in parallel and removed in post order.
  * \return delete file success
  */
 bool DoDeleteFilesWorker::deleteFilesOnCanNotRemoveDevice()
 {
-    AbstractJobHandler::SupportAction action { AbstractJobHandler::SupportAction::kNoAction };
-    for (QList<QUrl>::iterator it = --allFilesList.end(); it != --allFilesList.begin(); --it) {
+    localAborted = false;
+    if (!threadPool) {
+        threadPool.reset(new QThreadPool);
+        threadPool->setMaxThreadCount(threadCount);
+    }
+
+    QSet<QUrl> handled;
+    handled.reserve(sourceUrls.count());
+    for (const QUrl &url : sourceUrls) {
         if (!stateCheck())
             return false;
-        const QUrl &url = *it;
+
+        if (handled.contains(url))
+            continue;
+        handled.insert(url);
+
         emitCurrentTaskNotify(url, QUrl());
-        do {
-            action = AbstractJobHandler::SupportAction::kNoAction;
-            if (!localFileHandler->deleteFile(url)) {
-                action = doHandleErrorAndWait(url, AbstractJobHandler::JobErrorType::kDeleteFileError,
-                                              localFileHandler->errorString());
-            }
-        } while (!isStopped() && action == AbstractJobHandler::SupportAction::kRetryAction);
-
-        if (sourceUrls.contains(url)) {
-            if (action == AbstractJobHandler::SupportAction::kNoAction)
-                completeSourceFiles.append(url);
+        bool skipped { false };
+        if (!deleteLocalSource(url, &skipped))
+            return false;
+
+        if (!skipped) {
+            completeSourceFiles.append(url);
+            FileUtils::notifyFileChangeManual(Global::FileNotifyType::kFileDeleted, url);
         }
+    }
+    return true;
+}
 
+bool DoDeleteFilesWorker::deleteLocalSource(const QUrl &url, bool *skipped)
+{
+    const QByteArray &path = QFile::encodeName(url.toLocalFile());
+    struct stat st;
+    if (::lstat(path.constData(), &st) != 0) {
+        // it has been deleted with another source.
+        if (errno == ENOENT)
+            return true;
+        st.st_mode = 0;
+    }
+
+    if (!S_ISDIR(st.st_mode)) {
+        bool ok = doLocalDelete(path, [&path]() { return ::unlinkat(AT_FDCWD, path.constData(), 0); }, skipped);
         deleteFilesCount++;
+        return ok;
+    }
 
-        if (action == AbstractJobHandler::SupportAction::kSkipAction)
+    QSharedPointer<LocalDirNode> root(new LocalDirNode);
+    root->path = path;
+    scanLocalDir(root);
+    threadPool->waitForDone();
+
+    if (localAborted)
+        return false;
+
+    *skipped = root->skipped;
+    return true;
+}
+
+void DoDeleteFilesWorker::scanLocalDir(const QSharedPointer<LocalDirNode> &node)
+{
+    if (!localStateCheck())
+        return;
+
+    int fd { -1 };
+    bool skipped { false };
+    bool ok = doLocalDelete(node->path, [&node, &fd]() {
+        fd = ::open(node->path.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        return fd < 0 ? -1 : 0;
+    }, &skipped);
+    if (!ok)
+        return;
+
+    DIR *dir = fd < 0 ? nullptr : ::fdopendir(fd);
+    if (!dir) {
+        if (fd >= 0)
+            ::close(fd);
+        // the directory is skipped by user, or it has been deleted.
+        if (skipped)
+            node->skipped = true;
+        finishLocalDir(node);
+        return;
+    }
+
+    emitCurrentTaskNotify(QUrl::fromLocalFile(QFile::decodeName(node->path)), QUrl());
+
+    while (struct dirent *entry = ::readdir(dir)) {
+        const char *name = entry->d_name;
+        if (qstrcmp(name, ".") == 0 || qstrcmp(name, "..") == 0)
             continue;
 
-        if (action != AbstractJobHandler::SupportAction::kNoAction)
+        if (!localStateCheck())
+            break;
+
+        bool isDir = entry->d_type == DT_DIR;
+        if (entry->d_type == DT_UNKNOWN) {
+            struct stat st;
+            isDir = ::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+        }
+
+        const QByteArray &childPath = node->path + '/' + name;
+        if (isDir) {
+            QSharedPointer<LocalDirNode> child(new LocalDirNode);
+            child->path = childPath;
+            child->parent = node;
+            node->pending.ref();
+            QtConcurrent::run(threadPool.data(), [this, child]() { scanLocalDir(child); });
+            continue;
+        }
+
+        bool childSkipped { false };
+        ok = doLocalDelete(childPath, [fd, name]() { return ::unlinkat(fd, name, 0); }, &childSkipped);
+        deleteFilesCount++;
+        if (!ok)
+            break;
+        if (childSkipped)
+            node->skipped = true;
+    }
+    ::closedir(dir);
+
+    if (localAborted)
+        return;
+
+    finishLocalDir(node);
+}
+
+void DoDeleteFilesWorker::finishLocalDir(QSharedPointer<LocalDirNode> node)
+{
+    // remove the directories whose children are all removed, from bottom to top.
+    while (node && !node->pending.deref()) {
+        bool skipped = node->skipped;
+        if (!skipped) {
+            const QByteArray path = node->path;
+            bool ok = doLocalDelete(path, [&path]() { return ::unlinkat(AT_FDCWD, path.constData(), AT_REMOVEDIR); }, &skipped);
+            deleteFilesCount++;
+            if (!ok)
+                return;
+        }
+
+        if (skipped) {
+            node->skipped = true;
+            if (node->parent)
+                node->parent->skipped = true;
+        }
+        node = node->parent;
+    }
+}
+
+bool DoDeleteFilesWorker::localStateCheck()
+{
+    if (localAborted)
+        return false;
+
+    if (currentState == AbstractJobHandler::JobState::kRunningState)
+        return true;
+
+    QMutexLocker lk(&localErrorMutex);
+    if (!stateCheck())
+        localAborted = true;
+
+    return !localAborted;
+}
+
+/*!
+ * \brief DoDeleteFilesWorker::doLocalDelete run \a operation until it succeeds or the user gives up.
+ * It can be called in delete threads, the errors are reported one by one.
+ * \param skipped set to true if the user skips the error
+ * \return false if the job is stopped or canceled
+ */
+bool DoDeleteFilesWorker::doLocalDelete(const QByteArray &path, const std::function<int()> &operation, bool *skipped)
+{
+    AbstractJobHandler::SupportAction action { AbstractJobHandler::SupportAction::kNoAction };
+    do {
+        action = AbstractJobHandler::SupportAction::kNoAction;
+        // ENOENT: it is deleted by others.
+        if (operation() == 0 || errno == ENOENT)
+            break;
+
+        const QString &errorMsg = QString::fromLocal8Bit(strerror(errno));
+        fmWarning() << "delete file failed:" << path << "error:" << errorMsg;
+
+        QMutexLocker lk(&localErrorMutex);
+        if (localAborted)
             return false;
+        action = doHandleErrorAndWait(QUrl::fromLocalFile(QFile::decodeName(path)),
+                                      AbstractJobHandler::JobErrorType::kDeleteFileError, errorMsg);
+    } while (!isStopped() && action == AbstractJobHandler::SupportAction::kRetryAction);
+
+    if (action == AbstractJobHandler::SupportAction::kSkipAction) {
+        *skipped = true;
+        return true;
     }
+
+    if (action != AbstractJobHandler::SupportAction::kNoAction) {
+        localAborted = true;
+        return false;
+    }
+
     return true;
 }
 /*!
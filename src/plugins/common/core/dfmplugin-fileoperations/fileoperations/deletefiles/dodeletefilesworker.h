@@ -12,6 +12,10 @@
 #include <dfm-base/interfaces/fileinfo.h>
 
 #include <QObject>
+#include <QMutex>
+
+#include <atomic>
+#include <functional>
 
 DPFILEOPERATIONS_BEGIN_NAMESPACE
 DFMBASE_USE_NAMESPACE
@@ -39,8 +43,18 @@ protected:
                                                            const AbstractJobHandler::JobErrorType &error,
                                                            const QString &errorMsg = QString());
 
+private:
+    struct LocalDirNode;
+    bool deleteLocalSource(const QUrl &url, bool *skipped);
+    void scanLocalDir(const QSharedPointer<LocalDirNode> &node);
+    void finishLocalDir(QSharedPointer<LocalDirNode> node);
+    bool localStateCheck();
+    bool doLocalDelete(const QByteArray &path, const std::function<int()> &operation, bool *skipped);
+
 private:
     QAtomicInteger<qint64> deleteFilesCount { 0 };
+    QMutex localErrorMutex;   // the errors of delete threads are handled one by one
+    std::atomic_bool localAborted { false };
 };
 DPFILEOPERATIONS_END_NAMESPACE
 
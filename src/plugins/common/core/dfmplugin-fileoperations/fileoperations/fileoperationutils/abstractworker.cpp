@@ -5,6 +5,7 @@
 #include "abstractworker.h"
 #include "workerdata.h"
 #include "errormessageandaction.h"
+#include "operationscheduler.h"
 
 #include <dfm-base/utils/fileutils.h>
 #include <dfm-base/base/schemefactory.h>
@@ -118,6 +119,8 @@ void AbstractWorker::pause()
     if (currentState == AbstractJobHandler::JobState::kPauseState)
         return;
     setStat(AbstractJobHandler::JobState::kPauseState);
+    // the devices are left to the other jobs while pausing
+    OperationScheduler::instance()->setPaused(quintptr(this), true);
 }
 /*!
  * \brief AbstractWorker::resume resume task
@@ -125,6 +128,7 @@ void AbstractWorker::pause()
 void AbstractWorker::resume()
 {
     setStat(AbstractJobHandler::JobState::kRunningState);
+    OperationScheduler::instance()->setPaused(quintptr(this), false);
 
     waitCondition.wakeAll();
 }
@@ -262,6 +266,7 @@ bool AbstractWorker::initArgs()
 void AbstractWorker::endWork()
 {
     setStat(AbstractJobHandler::JobState::kStopState);
+    OperationScheduler::instance()->release(quintptr(this));
 
     Q_EMIT removeTaskWidget();
 
@@ -583,6 +588,7 @@ void AbstractWorker::saveOperations()
 
 AbstractWorker::~AbstractWorker()
 {
+    OperationScheduler::instance()->release(quintptr(this));
     if (statisticsFilesSizeJob) {
         statisticsFilesSizeJob->stop();
         statisticsFilesSizeJob->wait();
@@ -38,7 +38,7 @@ class AbstractWorker : public QObject
 public:
     enum class CountWriteSizeType : quint8 {
         kTidType,   // Read thread IO write size 使用 /pric/[pid]/task/[tid]/io 文件中的的 writeBytes 字段的值作为判断已写入数据的依据
-        kWriteBlockType,   // Read write block device write block size
+        kWriteBlockType,   // the size of data written back to the block device, counted by WriteBackTracker
         kCustomizeType
     };
 
@@ -0,0 +1,363 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "copyjournal.h"
+
+#include <dfm-base/base/standardpaths.h>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+DFMBASE_USE_NAMESPACE
+DPFILEOPERATIONS_USE_NAMESPACE
+
+namespace {
+constexpr char kVersion[] { "1" };
+constexpr char kVersionTag { 'V' };
+constexpr char kTargetTag { 'T' };
+constexpr char kSourceTag { 'S' };
+constexpr char kDirTag { 'D' };
+constexpr char kCompletedTag { 'C' };
+constexpr char kOffsetTag { 'O' };
+}
+
+QString CopyJournal::journalDir()
+{
+    return StandardPaths::location(StandardPaths::kApplicationConfigPath) + "/deepin/dde-file-manager/copyjournal";
+}
+
+QString CopyJournal::journalPath(const QList<QUrl> &sources, const QUrl &target)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(target.toEncoded());
+    for (const QUrl &url : sources) {
+        hash.addData("\n", 1);
+        hash.addData(url.toEncoded());
+    }
+    return journalDir() + "/" + QString::fromLatin1(hash.result().toHex()) + ".journal";
+}
+
+qint64 CopyJournal::mtimeOf(const FileInfoPointer &info)
+{
+    return info->timeOf(TimeInfoType::kLastModifiedSecond).toLongLong();
+}
+
+void CopyJournal::removeExpired(const QDateTime &time)
+{
+    const QFileInfoList &journals = QDir(journalDir()).entryInfoList({ "*.journal" }, QDir::Files);
+    for (const QFileInfo &info : journals) {
+        if (info.lastModified() >= time)
+            continue;
+
+        const QByteArray &name = QFile::encodeName(info.absoluteFilePath());
+        int journalFd = ::open(name.constData(), O_RDONLY | O_CLOEXEC);
+        if (journalFd < 0)
+            continue;
+
+        // the journal of a running job is locked, it is kept
+        if (::flock(journalFd, LOCK_EX | LOCK_NB) == 0) {
+            fmInfo() << "remove expired copy journal: " << info.absoluteFilePath();
+            ::unlink(name.constData());
+        }
+        ::close(journalFd);
+    }
+}
+
+CopyJournal::CopyJournal(const QList<QUrl> &sources, const QUrl &target)
+    : sources(sources), target(target), path(journalPath(sources, target))
+{
+}
+
+CopyJournal::~CopyJournal()
+{
+    // the journal is kept if it is not removed, the job can be resumed
+    if (fd >= 0) {
+        checkpoint();
+        ::close(fd);
+    }
+}
+
+bool CopyJournal::open()
+{
+    QMutexLocker lk(&mutex);
+    if (fd >= 0)
+        return true;
+
+    QDir().mkpath(journalDir());
+    fd = ::open(QFile::encodeName(path).constData(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        fmWarning() << "failed to open copy journal: " << path << " error: " << strerror(errno);
+        return false;
+    }
+
+    // the same job is running in another process, it owns the journal
+    if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        fmInfo() << "copy journal is used by another job: " << path;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    checkpointTimer.start();
+    resuming = load();
+    if (resuming) {
+        fmInfo() << "resume copy job from journal: " << path << " records: " << records.count();
+        return true;
+    }
+
+    return writeHeader();
+}
+
+void CopyJournal::dirCreated(const QUrl &from, const QUrl &to)
+{
+    append(QByteArray(1, kDirTag) + '\t' + from.toEncoded() + '\t' + to.toEncoded() + '\n', false);
+}
+
+void CopyJournal::fileCompleted(const QUrl &from, const QUrl &to, const qint64 size, const qint64 mtime)
+{
+    const QByteArray &line = QByteArray(1, kCompletedTag) + '\t' + QByteArray::number(size) + '\t'
+            + QByteArray::number(mtime) + '\t' + from.toEncoded() + '\t' + to.toEncoded() + '\n';
+    {
+        QMutexLocker lk(&mutex);
+        if (fd < 0)
+            return;
+        pendingLines += line;
+        if (++pendingCount < kCheckpointCount && !checkpointTimer.hasExpired(kCheckpointInterval))
+            return;
+    }
+
+    checkpoint();
+}
+
+void CopyJournal::fileProgressed(const QUrl &from, const QUrl &to, const qint64 offset, const qint64 size, const qint64 mtime)
+{
+    const QByteArray &line = QByteArray(1, kOffsetTag) + '\t' + QByteArray::number(offset) + '\t'
+            + QByteArray::number(size) + '\t' + QByteArray::number(mtime) + '\t'
+            + from.toEncoded() + '\t' + to.toEncoded() + '\n';
+    // the offset is used after a power failure too, so it is synced as the data is
+    append(line, true);
+}
+
+QUrl CopyJournal::dirTarget(const QUrl &from) const
+{
+    const Record &record = records.value(from);
+    if (!record.isDir || !record.target.isLocalFile())
+        return QUrl();
+
+    struct stat st;
+    if (::stat(QFile::encodeName(record.target.toLocalFile()).constData(), &st) != 0 || !S_ISDIR(st.st_mode))
+        return QUrl();
+
+    return record.target;
+}
+
+CopyJournal::Record CopyJournal::record(const QUrl &from, const qint64 size, const qint64 mtime) const
+{
+    const Record &record = records.value(from);
+    if (record.isDir || !record.target.isValid() || record.size != size || record.mtime != mtime)
+        return Record();
+
+    // the target may be removed or changed after the last run
+    struct stat st;
+    if (!record.target.isLocalFile()
+        || ::stat(QFile::encodeName(record.target.toLocalFile()).constData(), &st) != 0
+        || !S_ISREG(st.st_mode))
+        return Record();
+
+    if (record.completed ? st.st_size != size : st.st_size < record.offset)
+        return Record();
+
+    return record;
+}
+
+void CopyJournal::checkpoint()
+{
+    // the copy threads go on if a checkpoint is running, the records pending are taken by the next one
+    if (!checkpointMutex.tryLock())
+        return;
+
+    QByteArray lines;
+    {
+        QMutexLocker lk(&mutex);
+        lines.swap(pendingLines);
+        pendingCount = 0;
+        checkpointTimer.restart();
+    }
+
+    // the data of the files completed is on the device before their records,
+    // the files are copied again after a power failure if it fails
+    if (!lines.isEmpty() && syncTarget())
+        append(lines, true);
+
+    checkpointMutex.unlock();
+}
+
+void CopyJournal::remove()
+{
+    QMutexLocker lk(&mutex);
+    if (fd < 0)
+        return;
+
+    // unlink before closing, the journal is not taken by others in between
+    ::unlink(QFile::encodeName(path).constData());
+    ::close(fd);
+    fd = -1;
+    records.clear();
+    resuming = false;
+    pendingLines.clear();
+    pendingCount = 0;
+}
+
+bool CopyJournal::load()
+{
+    records.clear();
+
+    QFile file;
+    if (!file.open(fd, QIODevice::ReadOnly, QFileDevice::DontCloseHandle))
+        return false;
+    file.seek(0);
+    const QByteArray &content = file.readAll();
+    file.close();
+    if (content.isEmpty())
+        return false;
+
+    QList<QUrl> plannedSources;
+    QUrl plannedTarget;
+    bool versionMatched = false;
+    int from = 0;
+    while (from < content.size()) {
+        const int end = content.indexOf('\n', from);
+        // the last line may be cut by the crash
+        if (end < 0)
+            break;
+        const QList<QByteArray> &fields = content.mid(from, end - from).split('\t');
+        from = end + 1;
+        if (fields.isEmpty() || fields.first().size() != 1)
+            continue;
+
+        switch (fields.first().at(0)) {
+        case kVersionTag:
+            versionMatched = fields.size() == 2 && fields.at(1) == kVersion;
+            break;
+        case kTargetTag:
+            if (fields.size() == 2)
+                plannedTarget = QUrl::fromEncoded(fields.at(1));
+            break;
+        case kSourceTag:
+            if (fields.size() == 2)
+                plannedSources.append(QUrl::fromEncoded(fields.at(1)));
+            break;
+        case kDirTag: {
+            if (fields.size() != 3)
+                break;
+            Record record;
+            record.target = QUrl::fromEncoded(fields.at(2));
+            record.isDir = true;
+            records.insert(QUrl::fromEncoded(fields.at(1)), record);
+            break;
+        }
+        case kCompletedTag: {
+            if (fields.size() != 5)
+                break;
+            Record record;
+            record.size = fields.at(1).toLongLong();
+            record.mtime = fields.at(2).toLongLong();
+            record.target = QUrl::fromEncoded(fields.at(4));
+            record.completed = true;
+            records.insert(QUrl::fromEncoded(fields.at(3)), record);
+            break;
+        }
+        case kOffsetTag: {
+            if (fields.size() != 6)
+                break;
+            Record record;
+            record.offset = fields.at(1).toLongLong();
+            record.size = fields.at(2).toLongLong();
+            record.mtime = fields.at(3).toLongLong();
+            record.target = QUrl::fromEncoded(fields.at(5));
+            records.insert(QUrl::fromEncoded(fields.at(4)), record);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // the name of journal is a hash, the plan is compared to make sure it is the same job
+    if (!versionMatched || plannedTarget != target || plannedSources != sources || records.isEmpty()) {
+        records.clear();
+        return false;
+    }
+
+    // end the line cut by the crash, the records appended are not mixed with it
+    if (!content.endsWith('\n') && ::write(fd, "\n", 1) != 1)
+        fmWarning() << "failed to write copy journal: " << path << " error: " << strerror(errno);
+
+    return true;
+}
+
+bool CopyJournal::writeHeader()
+{
+    if (::ftruncate(fd, 0) != 0) {
+        fmWarning() << "failed to reset copy journal: " << path << " error: " << strerror(errno);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    QByteArray header = QByteArray(1, kVersionTag) + '\t' + kVersion + '\n'
+            + QByteArray(1, kTargetTag) + '\t' + target.toEncoded() + '\n';
+    for (const QUrl &url : sources)
+        header += QByteArray(1, kSourceTag) + '\t' + url.toEncoded() + '\n';
+
+    if (::write(fd, header.constData(), static_cast<size_t>(header.size())) != header.size()) {
+        fmWarning() << "failed to write copy journal: " << path << " error: " << strerror(errno);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void CopyJournal::append(const QByteArray &line, const bool sync)
+{
+    QMutexLocker lk(&mutex);
+    if (fd < 0)
+        return;
+
+    // a record is written at once, a crash leaves a part of the last line only
+    if (::write(fd, line.constData(), static_cast<size_t>(line.size())) != line.size()) {
+        fmWarning() << "failed to write copy journal: " << path << " error: " << strerror(errno);
+        return;
+    }
+
+    if (sync)
+        ::fdatasync(fd);
+}
+
+bool CopyJournal::syncTarget() const
+{
+    const int targetFd = ::open(QFile::encodeName(target.path()).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (targetFd < 0) {
+        fmWarning() << "failed to open copy target: " << target << " error: " << strerror(errno);
+        return false;
+    }
+
+    const bool ok = ::syncfs(targetFd) == 0;
+    if (!ok)
+        fmWarning() << "failed to sync copy target: " << target << " error: " << strerror(errno);
+    ::close(targetFd);
+    return ok;
+}
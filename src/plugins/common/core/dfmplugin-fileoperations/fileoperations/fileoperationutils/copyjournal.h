@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COPYJOURNAL_H
+#define COPYJOURNAL_H
+
+#include "dfmplugin_fileoperations_global.h"
+
+#include <dfm-base/interfaces/fileinfo.h>
+
+#include <QHash>
+#include <QDateTime>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QUrl>
+
+DPFILEOPERATIONS_BEGIN_NAMESPACE
+
+/*!
+ * \brief The CopyJournal class keeps an append-only journal of a copy job on disk, so the job
+ * started again after a crash or logout copies only the remainder.
+ * The journal of a job is found by its sources and target, it records the planned sources,
+ * the completed files and the durable offset of the big files in progress. It is locked while
+ * the job runs and removed when the job ends, only the journal of a job which did not end is loaded.
+ * A record is used only if the size and modified time of the source are not changed.
+ * The completed files are recorded in batches: every kCheckpointCount files or kCheckpointInterval ms
+ * the file system of target is synced first, then the records are written and synced, so a record
+ * read after a power failure never points at the data not written back.
+ */
+class CopyJournal
+{
+public:
+    struct Record
+    {
+        QUrl target;
+        qint64 size { -1 };
+        qint64 mtime { -1 };
+        qint64 offset { 0 };   // the data before it is on the device
+        bool completed { false };
+        bool isDir { false };
+    };
+
+    // the offset of a file in progress is recorded once more than this is written
+    static constexpr qint64 kDurableStep { 64 * 1024 * 1024 };
+    // the journals not written for this long are removed at startup
+    static constexpr int kExpiredDays { 7 };
+    // the completed files are recorded once this many are pending or this long is passed
+    static constexpr int kCheckpointCount { 1000 };
+    static constexpr int kCheckpointInterval { 5000 };   // in ms
+
+    static QString journalDir();
+    static QString journalPath(const QList<QUrl> &sources, const QUrl &target);
+    static qint64 mtimeOf(const DFMBASE_NAMESPACE::FileInfoPointer &info);
+    // remove the journals modified before \a time, the ones locked by the running jobs are kept
+    static void removeExpired(const QDateTime &time);
+
+    CopyJournal(const QList<QUrl> &sources, const QUrl &target);
+    ~CopyJournal();
+
+    // open and lock the journal, the records of the last run are loaded if it did not end
+    bool open();
+    inline bool isResuming() const { return resuming; }
+    inline QString filePath() const { return path; }
+
+    void dirCreated(const QUrl &from, const QUrl &to);
+    void fileCompleted(const QUrl &from, const QUrl &to, const qint64 size, const qint64 mtime);
+    // the data of \a to before \a offset has been synced to the device
+    void fileProgressed(const QUrl &from, const QUrl &to, const qint64 offset, const qint64 size, const qint64 mtime);
+
+    // the target dir of \a from created in the last run, the files in it are merged
+    QUrl dirTarget(const QUrl &from) const;
+    // the record of \a from in the last run, the target is checked to be there yet
+    Record record(const QUrl &from, const qint64 size, const qint64 mtime) const;
+
+    // sync the target and write the completed files pending
+    void checkpoint();
+    // the job is ended, the journal is not needed any more
+    void remove();
+
+private:
+    bool load();
+    bool writeHeader();
+    void append(const QByteArray &line, const bool sync);
+    bool syncTarget() const;
+
+private:
+    QList<QUrl> sources;
+    QUrl target;
+    QString path;
+    int fd { -1 };
+    bool resuming { false };
+    QHash<QUrl, Record> records;   // the records of the last run
+    QMutex mutex;   // the files are copied by several threads
+    QMutex checkpointMutex;   // one checkpoint at a time, the others do not wait for it
+    QByteArray pendingLines;   // the completed files not recorded yet
+    int pendingCount { 0 };
+    QElapsedTimer checkpointTimer;
+};
+
+DPFILEOPERATIONS_END_NAMESPACE
+
+#endif   // COPYJOURNAL_H
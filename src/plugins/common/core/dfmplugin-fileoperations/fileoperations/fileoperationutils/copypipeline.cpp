@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "copypipeline.h"
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <unistd.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+namespace {
+constexpr qint64 kMiB { 1024 * 1024 };
+}
+
+void CopyBlockTuner::record(Stage stage, qint64 bytes, qint64 nsecs)
+{
+    if (bytes <= 0 || nsecs < 0)
+        return;
+
+    nsecsPerMiB[stage] = nsecs * kMiB / bytes;
+
+    // the slower stage decides the pace of the pipeline
+    const qint64 current = size;
+    const qint64 latency = std::max(nsecsPerMiB[kRead].load(), nsecsPerMiB[kWrite].load()) * current / kMiB;
+    if (latency < kGrowLatency && current < kMaxBlockSize)
+        size = current * 2;
+    else if (latency > kShrinkLatency && current > kMinBlockSize)
+        size = current / 2;
+}
+
+void CopyBlockTuner::reset()
+{
+    size = kInitBlockSize;
+    nsecsPerMiB[kRead] = 0;
+    nsecsPerMiB[kWrite] = 0;
+}
+
+CopyPipeline::CopyPipeline(int blockCount)
+    : blocks(std::max(blockCount, 1))
+{
+}
+
+CopyPipeline::~CopyPipeline()
+{
+    stop();
+    for (Block &block : blocks)
+        free(block.data);
+}
+
+char *CopyPipeline::buffer(qint64 size)
+{
+    return reserve(&blocks.first(), size) ? blocks.first().data : nullptr;
+}
+
+void CopyPipeline::start(const QSharedPointer<DFMIO::DFile> &source, qint64 totalSize, CopyBlockTuner *tuner)
+{
+    stop();
+
+    freeBlocks.clear();
+    filledBlocks.clear();
+    for (Block &block : blocks)
+        freeBlocks.enqueue(&block);
+    readerFinished = false;
+    canceled = false;
+    readError = false;
+    readErrorPos = 0;
+
+    reader = std::thread(&CopyPipeline::readLoop, this, source, totalSize, tuner);
+}
+
+CopyPipeline::Block *CopyPipeline::take()
+{
+    QMutexLocker lk(&mutex);
+    while (filledBlocks.isEmpty() && !readerFinished && !canceled)
+        filledCondition.wait(&mutex);
+
+    return filledBlocks.isEmpty() ? nullptr : filledBlocks.dequeue();
+}
+
+void CopyPipeline::giveBack(CopyPipeline::Block *block)
+{
+    QMutexLocker lk(&mutex);
+    freeBlocks.enqueue(block);
+    freeCondition.wakeOne();
+}
+
+void CopyPipeline::stop()
+{
+    {
+        QMutexLocker lk(&mutex);
+        canceled = true;
+        freeCondition.wakeAll();
+    }
+
+    if (reader.joinable())
+        reader.join();
+}
+
+void CopyPipeline::readLoop(QSharedPointer<DFMIO::DFile> source, qint64 totalSize, CopyBlockTuner *tuner)
+{
+    qint64 pos = source->pos();
+    QElapsedTimer timer;
+    while (pos < totalSize) {
+        Block *block { nullptr };
+        {
+            QMutexLocker lk(&mutex);
+            while (freeBlocks.isEmpty() && !canceled)
+                freeCondition.wait(&mutex);
+            if (canceled)
+                break;
+            block = freeBlocks.dequeue();
+        }
+
+        const qint64 want = std::min(tuner->blockSize(), totalSize - pos);
+        qint64 readSize = -1;
+        if (reserve(block, want)) {
+            timer.start();
+            readSize = source->read(block->data, want);
+        }
+
+        QMutexLocker lk(&mutex);
+        if (readSize <= 0) {
+            freeBlocks.enqueue(block);
+            readError = true;
+            readErrorPos = pos;
+            break;
+        }
+
+        tuner->record(CopyBlockTuner::kRead, readSize, timer.nsecsElapsed());
+        pos += readSize;
+        block->size = readSize;
+        filledBlocks.enqueue(block);
+        filledCondition.wakeOne();
+    }
+
+    QMutexLocker lk(&mutex);
+    readerFinished = true;
+    filledCondition.wakeAll();
+}
+
+bool CopyPipeline::reserve(CopyPipeline::Block *block, qint64 size)
+{
+    if (block->capacity >= size)
+        return true;
+
+    void *data { nullptr };
+    if (posix_memalign(&data, static_cast<size_t>(getpagesize()), static_cast<size_t>(size)) != 0)
+        return false;
+
+    free(block->data);
+    block->data = static_cast<char *>(data);
+    block->capacity = size;
+    return true;
+}
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COPYPIPELINE_H
+#define COPYPIPELINE_H
+
+#include "dfmplugin_fileoperations_global.h"
+
+#include <dfm-io/dfile.h>
+
+#include <QSharedPointer>
+#include <QQueue>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <thread>
+
+DPFILEOPERATIONS_BEGIN_NAMESPACE
+
+/*!
+ * \brief The CopyBlockTuner class adapts the size of copy blocks to the devices.
+ * The latency of the slower one of reading and writing a block is kept between
+ * kGrowLatency and kShrinkLatency: small blocks waste calls on fast devices,
+ * big blocks on slow devices make pausing and progress sluggish.
+ */
+class CopyBlockTuner
+{
+public:
+    enum Stage : quint8 {
+        kRead,
+        kWrite,
+    };
+
+    static constexpr qint64 kMinBlockSize { 128 * 1024 };
+    static constexpr qint64 kMaxBlockSize { 16 * 1024 * 1024 };
+    static constexpr qint64 kInitBlockSize { 1024 * 1024 };
+    static constexpr qint64 kGrowLatency { 20 * 1000 * 1000 };   // nsecs
+    static constexpr qint64 kShrinkLatency { 200 * 1000 * 1000 };   // nsecs
+
+    inline qint64 blockSize() const { return size; }
+    // \a stage spent \a nsecs on \a bytes, it can be called from the reader and the writer
+    void record(Stage stage, qint64 bytes, qint64 nsecs);
+    void reset();
+
+private:
+    std::atomic<qint64> size { kInitBlockSize };
+    std::atomic<qint64> nsecsPerMiB[2] { { 0 }, { 0 } };
+};
+
+/*!
+ * \brief The CopyPipeline class reads a file on its own thread into a few reused buffers,
+ * so the caller can write a block while the next one is being read.
+ * The buffers are page aligned and kept between files. Reading stops at the first error,
+ * the caller should handle it after taking the filled blocks.
+ */
+class CopyPipeline
+{
+public:
+    struct Block
+    {
+        char *data { nullptr };
+        qint64 capacity { 0 };
+        qint64 size { 0 };
+    };
+
+    explicit CopyPipeline(int blockCount = 2);
+    ~CopyPipeline();
+
+    // a buffer of \a size at least for copying without the reader thread
+    char *buffer(qint64 size);
+
+    void start(const QSharedPointer<DFMIO::DFile> &source, qint64 totalSize, CopyBlockTuner *tuner);
+    // the next filled block in order, nullptr at the end or after an error of reading
+    Block *take();
+    void giveBack(Block *block);
+    // cancel reading and wait for the reader thread
+    void stop();
+
+    inline bool hasReadError() const { return readError; }
+    // the position of the source where reading failed
+    inline qint64 errorPos() const { return readErrorPos; }
+
+private:
+    void readLoop(QSharedPointer<DFMIO::DFile> source, qint64 totalSize, CopyBlockTuner *tuner);
+    static bool reserve(Block *block, qint64 size);
+
+private:
+    QVector<Block> blocks;
+    QQueue<Block *> freeBlocks;
+    QQueue<Block *> filledBlocks;
+    QMutex mutex;
+    QWaitCondition freeCondition;
+    QWaitCondition filledCondition;
+    std::thread reader;
+    bool readerFinished { true };
+    bool canceled { false };
+    bool readError { false };
+    qint64 readErrorPos { 0 };
+};
+
+DPFILEOPERATIONS_END_NAMESPACE
+
+#endif   // COPYPIPELINE_H
@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "docopyfileworker.h"
+#include "filechecksum.h"
+#include "copyjournal.h"
 
 #include <dfm-base/utils/fileutils.h>
 #include <dfm-base/base/device/deviceutils.h>
@@ -10,13 +12,17 @@
 #include <dfm-io/dfmio_utils.h>
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QTime>
 #include <QWaitCondition>
 #include <QMutex>
 #include <QThread>
 
+#include <algorithm>
+
 #include <fcntl.h>
-#include <zlib.h>
+#include <unistd.h>
 #include <sys/mman.h>
 
 static const quint32 kMaxBufferLength { 1024 * 1024 * 1 };
@@ -172,6 +178,11 @@ bool DoCopyFileWorker::doDfmioFileCopy(FileInfoPointer fromInfo, FileInfoPointer
 
     workData->everyFileWriteSize.remove(fromUrl);
     delete data;
+    // the files are copied by the threads of pool, the tracker of job is shared by them
+    if (ret && workData->writeBack)
+        workData->writeBack->track(toUrl.path(), fromInfo->size());
+    if (ret)
+        journalCompleted(fromInfo, toInfo);
     if (toInfo->exists())
         FileUtils::notifyFileChangeManual(DFMBASE_NAMESPACE::Global::FileNotifyType::kFileAdded, toInfo->urlOf(UrlInfoType::kUrl));
 
@@ -215,8 +226,10 @@ bool DoCopyFileWorker::doCopyFilePractically(const FileInfoPointer fromInfo, con
     QSharedPointer<DFMIO::DFile> fromDevice { nullptr }, toDevice { nullptr };
     if (!createFileDevices(fromInfo, toInfo, fromDevice, toDevice, skip))
         return false;
+    // the file copied partly in the last run is continued
+    qint64 offset = journaledOffset(fromInfo, toInfo);
     // 打开文件并创建
-    if (!openFiles(fromInfo, toInfo, fromDevice, toDevice, skip))
+    if (!openFiles(fromInfo, toInfo, fromDevice, toDevice, skip, offset <= 0))
         return false;
     // 源文件大小如果为0
     if (fromInfo->size() <= 0) {
@@ -226,6 +239,7 @@ bool DoCopyFileWorker::doCopyFilePractically(const FileInfoPointer fromInfo, con
         FileUtils::notifyFileChangeManual(DFMBASE_NAMESPACE::Global::FileNotifyType::kFileAdded, toInfo->urlOf(UrlInfoType::kUrl));
         if (workData->exBlockSyncEveryWrite)
             sync();
+        journalCompleted(fromInfo, toInfo);
         return true;
     }
     // resize target file
@@ -235,38 +249,58 @@ bool DoCopyFileWorker::doCopyFilePractically(const FileInfoPointer fromInfo, con
     int toFd = -1;
     if (workData->exBlockSyncEveryWrite)
         toFd = open(toInfo->urlOf(UrlInfoType::kUrl).path().toUtf8().toStdString().data(), O_RDONLY);
-    qint64 blockSize = fromInfo->size() > kMaxBufferLength ? kMaxBufferLength : fromInfo->size();
-    char *data = new char[static_cast<uint>(blockSize + 1)];
-    uLong sourceCheckSum = adler32(0L, nullptr, 0);
+    // the checksum of source is computed while copying, so the source is read only once.
+    FileChecksum sourceCheckSum;
+    if (offset > 0 && !seekToOffset(fromDevice, toDevice, offset, &sourceCheckSum)) {
+        fmWarning() << "failed to continue the file from journal, copy it again: " << toInfo->urlOf(UrlInfoType::kUrl);
+        sourceCheckSum.reset();
+        offset = 0;
+        fromDevice->seek(0);
+        toDevice->seek(0);
+    }
+    // the data copied in the last run is counted as skipped
+    if (offset > 0)
+        workData->skipWriteSize += offset;
+    journaledPos = offset;
+    if (workData->writeBack)
+        workData->writeBack->begin(&writeBackStream, toInfo->urlOf(UrlInfoType::kUrl).path(), offset);
+    bool ok = true;
+    // read the next block while writing one if there are more than one blocks
+    if (fromInfo->size() > blockTuner.blockSize())
+        ok = doPipelineCopy(fromInfo, toInfo, fromDevice, toDevice, toFd, &sourceCheckSum, skip);
+
+    // the rest after an error of reading is copied block by block, the error is handled here
     qint64 sizeRead = 0;
+    while (ok && fromDevice->pos() != fromInfo->size()) {
+        const qint64 blockSize = blockTuner.blockSize();
+        char *data = copyPipeline.buffer(blockSize);
+        if (!data) {
+            fmCritical() << "failed to alloc copy buffer, size: " << blockSize;
+            ok = false;
+            break;
+        }
 
-    do {
         if (!doReadFile(fromInfo, toInfo, fromDevice, data, blockSize, sizeRead, skip)) {
-            delete[] data;
-            data = nullptr;
-            return false;
+            ok = false;
+            break;
         }
 
         if (!doWriteFile(fromInfo, toInfo, toDevice, data, sizeRead, skip)) {
-            delete[] data;
-            data = nullptr;
-            return false;
-        }
-
-        if (Q_LIKELY(workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyIntegrityChecking))) {
-            sourceCheckSum = adler32(sourceCheckSum, reinterpret_cast<Bytef *>(data), static_cast<uInt>(sizeRead));
+            ok = false;
+            break;
         }
 
-        // 执行同步策略
-        if (workData->exBlockSyncEveryWrite && toFd > 0)
-            syncfs(toFd);
-
-        toInfo->cacheAttribute(DFMIO::DFileInfo::AttributeID::kStandardSize, toDevice->size());
+        afterBlockWritten(fromInfo, toInfo, toDevice, toFd, data, sizeRead, &sourceCheckSum);
+    }
 
-    } while (fromDevice->pos() != fromInfo->size());
+    if (workData->writeBack)
+        workData->writeBack->end(&writeBackStream);
 
-    delete[] data;
-    data = nullptr;
+    if (!ok) {
+        if (toFd > 0)
+            close(toFd);
+        return false;
+    }
 
     // 执行同步策略
     if (workData->exBlockSyncEveryWrite && toFd > 0)
@@ -282,8 +316,9 @@ bool DoCopyFileWorker::doCopyFilePractically(const FileInfoPointer fromInfo, con
 
     // 校验文件完整性
     if (skip)
-        *skip = verifyFileIntegrity(blockSize, sourceCheckSum, fromInfo, toInfo, toDevice);
+        *skip = verifyFileIntegrity(blockTuner.blockSize(), sourceCheckSum.value(), fromInfo, toInfo, toDevice);
     toInfo->refresh();
+    journalCompleted(fromInfo, toInfo);
 
     if (skip && *skip)
         FileUtils::notifyFileChangeManual(DFMBASE_NAMESPACE::Global::FileNotifyType::kFileAdded, toInfo->urlOf(UrlInfoType::kUrl));
@@ -291,6 +326,140 @@ bool DoCopyFileWorker::doCopyFilePractically(const FileInfoPointer fromInfo, con
     return true;
 }
 
+/*!
+ * \brief DoCopyFileWorker::doPipelineCopy copy the file while the source is read on the reader thread
+ * of the pipeline. If reading fails, the source is set to the position of failure and true is returned,
+ * so the caller copies the rest and handles the error of reading.
+ */
+bool DoCopyFileWorker::doPipelineCopy(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
+                                      const QSharedPointer<DFMIO::DFile> &fromDevice,
+                                      const QSharedPointer<DFMIO::DFile> &toDevice,
+                                      const int toFd, FileChecksum *checkSum, bool *skip)
+{
+    copyPipeline.start(fromDevice, fromInfo->size(), &blockTuner);
+
+    bool ok = true;
+    QElapsedTimer timer;
+    while (CopyPipeline::Block *block = copyPipeline.take()) {
+        timer.start();
+        ok = doWriteFile(fromInfo, toInfo, toDevice, block->data, block->size, skip);
+        if (ok) {
+            blockTuner.record(CopyBlockTuner::kWrite, block->size, timer.nsecsElapsed());
+            afterBlockWritten(fromInfo, toInfo, toDevice, toFd, block->data, block->size, checkSum);
+        }
+        copyPipeline.giveBack(block);
+        if (!ok)
+            break;
+    }
+    copyPipeline.stop();
+
+    if (!ok || !copyPipeline.hasReadError())
+        return ok;
+
+    if (!fromDevice->seek(copyPipeline.errorPos())) {
+        AbstractJobHandler::SupportAction actionForReadSeek = doHandleErrorAndWait(fromInfo->urlOf(UrlInfoType::kUrl),
+                                                                                   toInfo->urlOf(UrlInfoType::kUrl),
+                                                                                   AbstractJobHandler::JobErrorType::kSeekError,
+                                                                                   false, fromDevice->lastError().errorMsg());
+        checkRetry();
+        actionOperating(actionForReadSeek, fromInfo->size() - copyPipeline.errorPos(), skip);
+        return false;
+    }
+
+    return true;
+}
+
+void DoCopyFileWorker::afterBlockWritten(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
+                                         const QSharedPointer<DFMIO::DFile> &toDevice,
+                                         const int toFd, const char *data, const qint64 size, FileChecksum *checkSum)
+{
+    if (Q_LIKELY(workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyIntegrityChecking)))
+        checkSum->update(data, size);
+
+    // 执行同步策略
+    if (workData->exBlockSyncEveryWrite && toFd > 0)
+        syncfs(toFd);
+
+    if (workData->writeBack)
+        workData->writeBack->written(&writeBackStream, size);
+
+    toInfo->cacheAttribute(DFMIO::DFileInfo::AttributeID::kStandardSize, toDevice->size());
+
+    journalProgress(fromInfo, toInfo, toDevice->pos());
+}
+
+/*!
+ * \brief DoCopyFileWorker::journaledOffset the durable offset of the file copied to \a toInfo in the last run
+ */
+qint64 DoCopyFileWorker::journaledOffset(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo)
+{
+    if (!workData->journal || !workData->journal->isResuming())
+        return 0;
+
+    const CopyJournal::Record &record = workData->journal->record(fromInfo->urlOf(UrlInfoType::kUrl), fromInfo->size(),
+                                                                  CopyJournal::mtimeOf(fromInfo));
+    if (record.completed || record.target != toInfo->urlOf(UrlInfoType::kUrl))
+        return 0;
+
+    return record.offset;
+}
+
+/*!
+ * \brief DoCopyFileWorker::seekToOffset set the files to the offset to continue copying
+ * The checksum covers the whole file, so the part of source before the offset is read again for it.
+ */
+bool DoCopyFileWorker::seekToOffset(const QSharedPointer<DFMIO::DFile> &fromDevice, const QSharedPointer<DFMIO::DFile> &toDevice,
+                                    const qint64 offset, FileChecksum *checkSum)
+{
+    if (workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyIntegrityChecking)) {
+        qint64 pos = 0;
+        while (pos < offset) {
+            const qint64 blockSize = std::min(blockTuner.blockSize(), offset - pos);
+            char *data = copyPipeline.buffer(blockSize);
+            const qint64 readSize = data ? fromDevice->read(data, blockSize) : -1;
+            if (readSize <= 0)
+                return false;
+            checkSum->update(data, readSize);
+            pos += readSize;
+        }
+    }
+
+    return fromDevice->seek(offset) && toDevice->seek(offset);
+}
+
+/*!
+ * \brief DoCopyFileWorker::journalProgress record the offset of the file in the journal every kDurableStep,
+ * the data before it is synced to the device first
+ */
+void DoCopyFileWorker::journalProgress(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo, const qint64 pos)
+{
+    if (!workData->journal || pos - journaledPos < CopyJournal::kDurableStep || pos >= fromInfo->size())
+        return;
+
+    const QUrl &toUrl = toInfo->urlOf(UrlInfoType::kUrl);
+    const int fd = ::open(QFile::encodeName(toUrl.path()).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    const bool synced = ::fdatasync(fd) == 0;
+    ::close(fd);
+    if (!synced)
+        return;
+
+    workData->journal->fileProgressed(fromInfo->urlOf(UrlInfoType::kUrl), toUrl, pos,
+                                      fromInfo->size(), CopyJournal::mtimeOf(fromInfo));
+    journaledPos = pos;
+}
+
+void DoCopyFileWorker::journalCompleted(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo)
+{
+    // the file is not known to be completed if the job is stopped
+    if (!workData->journal || isStopped())
+        return;
+
+    workData->journal->fileCompleted(fromInfo->urlOf(UrlInfoType::kUrl), toInfo->urlOf(UrlInfoType::kUrl),
+                                     fromInfo->size(), CopyJournal::mtimeOf(fromInfo));
+}
+
 bool DoCopyFileWorker::stateCheck()
 {
     if (state == kPasued)
@@ -436,13 +605,16 @@ bool DoCopyFileWorker::createFileDevices(const FileInfoPointer &fromInfo, const
  */
 bool DoCopyFileWorker::openFiles(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
                                  const QSharedPointer<DFMIO::DFile> &fromeFile, const QSharedPointer<DFMIO::DFile> &toFile,
-                                 bool *skip)
+                                 bool *skip, const bool truncate)
 {
     if (!openFile(fromInfo, toInfo, fromeFile, DFMIO::DFile::OpenFlag::kReadOnly, skip)) {
         return false;
     }
 
-    if (!openFile(fromInfo, toInfo, toFile, DFMIO::DFile::OpenFlag::kWriteOnly | DFMIO::DFile::OpenFlag::kTruncate, skip)) {
+    // the target is not truncated if it is continued
+    const DFMIO::DFile::OpenFlags toFlags = truncate ? DFMIO::DFile::OpenFlag::kWriteOnly | DFMIO::DFile::OpenFlag::kTruncate
+                                                     : DFMIO::DFile::OpenFlags(DFMIO::DFile::OpenFlag::kWriteOnly);
+    if (!openFile(fromInfo, toInfo, toFile, toFlags, skip)) {
         return false;
     }
 
@@ -653,52 +825,91 @@ bool DoCopyFileWorker::doWriteFile(const FileInfoPointer &fromInfo, const FileIn
     return true;
 }
 
-bool DoCopyFileWorker::verifyFileIntegrity(const qint64 &blockSize, const ulong &sourceCheckSum,
+/*!
+ * \brief DoCopyFileWorker::verifyFileIntegrity read back the target file and compare its checksum with the source.
+ * The data of target is written back and dropped from page cache before reading, so the data on device is checked.
+ */
+bool DoCopyFileWorker::verifyFileIntegrity(const qint64 &blockSize, const quint32 &sourceCheckSum,
                                            const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
                                            QSharedPointer<DFMIO::DFile> &toDevice)
 {
     if (!workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyIntegrityChecking))
         return true;
+
+    toDevice->flush();
+    const QUrl &toUrl = toInfo->urlOf(UrlInfoType::kUrl);
+    int fd = -1;
+    Q_FOREVER {
+        fd = open(toUrl.path().toUtf8().constData(), O_RDONLY | O_CLOEXEC);
+        if (Q_LIKELY(fd >= 0))
+            break;
+
+        AbstractJobHandler::SupportAction actionForOpen = doHandleErrorAndWait(fromInfo->urlOf(UrlInfoType::kUrl), toUrl,
+                                                                               AbstractJobHandler::JobErrorType::kIntegrityCheckingError,
+                                                                               true, QString::fromLocal8Bit(strerror(errno)));
+        if (!isStopped() && AbstractJobHandler::SupportAction::kRetryAction == actionForOpen)
+            continue;
+
+        checkRetry();
+        return actionForOpen == AbstractJobHandler::SupportAction::kSkipAction;
+    }
+
+    // only the clean pages can be dropped, so write back the target first.
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
     char *data = new char[static_cast<uint>(blockSize + 1)];
-    QTime t;
-    ulong targetCheckSum = adler32(0L, nullptr, 0);
+    QElapsedTimer t;
+    t.start();
+    FileChecksum targetCheckSum;
+    qint64 checkedSize = 0;
     Q_FOREVER {
-        qint64 size = toDevice->read(data, blockSize);
+        qint64 size = read(fd, data, static_cast<size_t>(blockSize));
 
         if (Q_UNLIKELY(size <= 0)) {
-            if (size == 0 && toInfo->size() == toDevice->pos()) {
+            if (size == 0)
                 break;
-            }
+            if (errno == EINTR)
+                continue;
 
-            AbstractJobHandler::SupportAction actionForCheckRead = doHandleErrorAndWait(fromInfo->urlOf(UrlInfoType::kUrl),
-                                                                                        toInfo->urlOf(UrlInfoType::kUrl),
+            AbstractJobHandler::SupportAction actionForCheckRead = doHandleErrorAndWait(fromInfo->urlOf(UrlInfoType::kUrl), toUrl,
                                                                                         AbstractJobHandler::JobErrorType::kIntegrityCheckingError,
-                                                                                        true,
-                                                                                        toDevice->lastError().errorMsg());
+                                                                                        true, QString::fromLocal8Bit(strerror(errno)));
             if (!isStopped() && AbstractJobHandler::SupportAction::kRetryAction == actionForCheckRead) {
+                // read again from the beginning.
+                lseek(fd, 0, SEEK_SET);
+                targetCheckSum.reset();
+                checkedSize = 0;
                 continue;
             } else {
+                delete[] data;
+                close(fd);
                 checkRetry();
                 return actionForCheckRead == AbstractJobHandler::SupportAction::kSkipAction;
             }
         }
 
-        targetCheckSum = adler32(targetCheckSum, reinterpret_cast<Bytef *>(data), static_cast<uInt>(size));
+        targetCheckSum.update(data, size);
+        checkedSize += size;
 
         if (Q_UNLIKELY(!stateCheck())) {
             delete[] data;
-            data = nullptr;
+            close(fd);
             return false;
         }
     }
     delete[] data;
+    close(fd);
 
-    fmDebug("Time spent of integrity check of the file: %d", t.elapsed());
+    workData->checkSumSize += checkedSize;
+    workData->checkSumTime += t.elapsed();
+    fmDebug("Time spent of integrity check of the file: %lld", t.elapsed());
 
-    if (sourceCheckSum != targetCheckSum) {
-        fmWarning("Failed on file integrity checking, source file: 0x%lx, target file: 0x%lx", sourceCheckSum, targetCheckSum);
+    if (sourceCheckSum != targetCheckSum.value()) {
+        fmWarning("Failed on file integrity checking, source file: 0x%x, target file: 0x%x", sourceCheckSum, targetCheckSum.value());
         AbstractJobHandler::SupportAction actionForCheck = doHandleErrorAndWait(fromInfo->urlOf(UrlInfoType::kUrl),
-                                                                                toInfo->urlOf(UrlInfoType::kUrl),
+                                                                                toUrl,
                                                                                 AbstractJobHandler::JobErrorType::kIntegrityCheckingError,
                                                                                 true);
         return actionForCheck == AbstractJobHandler::SupportAction::kSkipAction;
@@ -7,6 +7,8 @@
 
 #include "dfmplugin_fileoperations_global.h"
 #include "workerdata.h"
+#include "copypipeline.h"
+#include "writebacktracker.h"
 
 #include <dfm-base/interfaces/fileinfo.h>
 #include <dfm-base/interfaces/abstractjobhandler.h>
@@ -24,6 +26,7 @@ class QMutex;
 USING_IO_NAMESPACE
 DPFILEOPERATIONS_BEGIN_NAMESPACE
 DFMBASE_USE_NAMESPACE
+class FileChecksum;
 class DoCopyFileWorker : public QObject
 {
     Q_OBJECT
@@ -57,6 +60,7 @@ public:
     void doMemcpyLocalBigFile(const FileInfoPointer fromInfo, const FileInfoPointer toInfo, char *dest, char *source, size_t size);
     // copy file by dfmio
     bool doDfmioFileCopy(FileInfoPointer fromInfo, FileInfoPointer toInfo, bool *skip);
+    // wait for the data copied written back to the device
 signals:
     void ErrorFinished();
     void CompleteSize(const int size);
@@ -85,7 +89,7 @@ private:   // file copy
                           bool *skip);
     bool openFiles(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
                    const QSharedPointer<DFMIO::DFile> &fromeFile, const QSharedPointer<DFMIO::DFile> &toFile,
-                   bool *skip);
+                   bool *skip, const bool truncate = true);
     bool openFile(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
                   const QSharedPointer<DFMIO::DFile> &file, const DFMIO::DFile::OpenFlags &flags,
                   bool *skip);
@@ -97,8 +101,20 @@ private:   // file copy
     bool doWriteFile(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
                      const QSharedPointer<DFMIO::DFile> &toDevice,
                      const char *data, const qint64 readSize, bool *skip);
+    bool doPipelineCopy(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
+                        const QSharedPointer<DFMIO::DFile> &fromDevice,
+                        const QSharedPointer<DFMIO::DFile> &toDevice,
+                        const int toFd, FileChecksum *checkSum, bool *skip);
+    void afterBlockWritten(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
+                           const QSharedPointer<DFMIO::DFile> &toDevice,
+                           const int toFd, const char *data, const qint64 size, FileChecksum *checkSum);
+    qint64 journaledOffset(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo);
+    bool seekToOffset(const QSharedPointer<DFMIO::DFile> &fromDevice, const QSharedPointer<DFMIO::DFile> &toDevice,
+                      const qint64 offset, FileChecksum *checkSum);
+    void journalProgress(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo, const qint64 pos);
+    void journalCompleted(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo);
     void setTargetPermissions(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo);
-    bool verifyFileIntegrity(const qint64 &blockSize, const ulong &sourceCheckSum,
+    bool verifyFileIntegrity(const qint64 &blockSize, const quint32 &sourceCheckSum,
                              const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
                              QSharedPointer<DFMIO::DFile> &toFile);
     void checkRetry();
@@ -119,6 +135,11 @@ private:
     QList<QUrl> skipUrls;
     QUrl memcpySkipUrl;
     DThreadList<QSharedPointer<dfmio::DOperator>> fileOps;
+    CopyPipeline copyPipeline;   // the buffers are reused by every file
+    CopyBlockTuner blockTuner;
+    // the file written back by doCopyFilePractically, which copies one file at a time
+    WriteBackTracker::Stream writeBackStream;
+    qint64 journaledPos { 0 };   // the offset of current file in the journal
 };
 DPFILEOPERATIONS_END_NAMESPACE
 #endif   // DOCOPYFILEWORKER_H
@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "filechecksum.h"
+
+#include <QString>
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#    include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#    include <arm_acle.h>
+#endif
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+namespace {
+constexpr quint32 kPolynomial { 0x82F63B78 };   // reversed Castagnoli
+
+using SliceTable = std::array<std::array<quint32, 256>, 8>;
+
+SliceTable createTable()
+{
+    SliceTable table {};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i;
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (kPolynomial & (0u - (crc & 1)));
+        table[0][i] = crc;
+    }
+    for (quint32 i = 0; i < 256; ++i) {
+        for (int t = 1; t < 8; ++t)
+            table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+    }
+    return table;
+}
+
+quint32 crc32cSoftware(quint32 crc, const uchar *data, qint64 size)
+{
+    static const SliceTable table = createTable();
+
+    // the 8 bytes are read as a little endian word.
+    while (Q_BYTE_ORDER == Q_LITTLE_ENDIAN && size >= 8) {
+        quint64 word;
+        memcpy(&word, data, 8);
+        word ^= crc;
+        crc = table[7][word & 0xFF] ^ table[6][(word >> 8) & 0xFF]
+                ^ table[5][(word >> 16) & 0xFF] ^ table[4][(word >> 24) & 0xFF]
+                ^ table[3][(word >> 32) & 0xFF] ^ table[2][(word >> 40) & 0xFF]
+                ^ table[1][(word >> 48) & 0xFF] ^ table[0][word >> 56];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0)
+        crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xFF];
+
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) quint32 crc32cHardware(quint32 crc, const uchar *data, qint64 size)
+{
+    quint64 crc64 = crc;
+    while (size >= 8) {
+        quint64 word;
+        memcpy(&word, data, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        size -= 8;
+    }
+    crc = static_cast<quint32>(crc64);
+    while (size-- > 0)
+        crc = _mm_crc32_u8(crc, *data++);
+
+    return crc;
+}
+
+bool hasHardware()
+{
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+}
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+quint32 crc32cHardware(quint32 crc, const uchar *data, qint64 size)
+{
+    while (size >= 8) {
+        quint64 word;
+        memcpy(&word, data, 8);
+        crc = __crc32cd(crc, word);
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0)
+        crc = __crc32cb(crc, *data++);
+
+    return crc;
+}
+
+bool hasHardware()
+{
+    return true;
+}
+#else
+quint32 crc32cHardware(quint32 crc, const uchar *data, qint64 size)
+{
+    return crc32cSoftware(crc, data, size);
+}
+
+bool hasHardware()
+{
+    return false;
+}
+#endif
+}   // namespace
+
+QString FileChecksum::algorithm()
+{
+    if (!hasHardware())
+        return QStringLiteral("CRC32C");
+
+#if defined(__x86_64__)
+    return QStringLiteral("CRC32C (SSE4.2)");
+#else
+    return QStringLiteral("CRC32C (ARMv8 CRC)");
+#endif
+}
+
+/*!
+ * \brief FileChecksum::crc32c continue the CRC32C \a crc with \a data,
+ * the crc of empty data is 0.
+ */
+quint32 FileChecksum::crc32c(quint32 crc, const char *data, qint64 size)
+{
+    if (!data || size <= 0)
+        return crc;
+
+    const uchar *bytes = reinterpret_cast<const uchar *>(data);
+    crc = ~crc;
+    crc = hasHardware() ? crc32cHardware(crc, bytes, size) : crc32cSoftware(crc, bytes, size);
+    return ~crc;
+}
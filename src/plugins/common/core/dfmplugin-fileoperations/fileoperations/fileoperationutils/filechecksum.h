@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FILECHECKSUM_H
+#define FILECHECKSUM_H
+
+#include "dfmplugin_fileoperations_global.h"
+
+#include <QString>
+
+DPFILEOPERATIONS_BEGIN_NAMESPACE
+
+/*!
+ * \brief The FileChecksum class computes the CRC32C of a stream for copy integrity checking.
+ * The CRC instructions of the cpu are used if they are available, otherwise a slicing-by-8 table.
+ */
+class FileChecksum
+{
+public:
+    // the name of the kernel in use, e.g. "CRC32C (SSE4.2)"
+    static QString algorithm();
+    static quint32 crc32c(quint32 crc, const char *data, qint64 size);
+
+    inline void update(const char *data, qint64 size) { crc = crc32c(crc, data, size); }
+    inline quint32 value() const { return crc; }
+    inline void reset() { crc = 0; }
+
+private:
+    quint32 crc { 0 };
+};
+
+DPFILEOPERATIONS_END_NAMESPACE
+
+#endif   // FILECHECKSUM_H
@@ -5,6 +5,10 @@
 #include "fileoperatebaseworker.h"
 #include "fileoperations/fileoperationutils/fileoperationsutils.h"
 #include "workerdata.h"
+#include "filechecksum.h"
+#include "operationscheduler.h"
+#include "copyjournal.h"
+#include "writebacktracker.h"
 
 #include <dfm-base/interfaces/abstractdiriterator.h>
 #include <dfm-base/base/schemefactory.h>
@@ -71,14 +75,65 @@ AbstractJobHandler::SupportAction FileOperateBaseWorker::doHandleErrorAndWait(co
     return currentAction;
 }
 
+/*!
+ * \brief FileOperateBaseWorker::waitForDevices queue the job on the devices of \a urls
+ * and wait until the jobs before it on the same devices leave room for it
+ * \param urls the urls of sources and target
+ * \return false if the job is stopped while waiting
+ */
+bool FileOperateBaseWorker::waitForDevices(const QList<QUrl> &urls)
+{
+    // the small jobs are finished soon, they go first
+    const auto priority = sourceFilesTotalSize <= bigFileSize ? OperationScheduler::Priority::kHigh
+                                                              : OperationScheduler::Priority::kNormal;
+    const quint64 id = quintptr(this);
+    OperationScheduler *scheduler = OperationScheduler::instance();
+    scheduler->enqueue(id, urls, priority);
+    if (currentState == AbstractJobHandler::JobState::kPauseState)
+        scheduler->setPaused(id, true);
+
+    while (!scheduler->waitForStart(id, 200)) {
+        if (isStopped()) {
+            scheduler->release(id);
+            queuePosition = 0;
+            return false;
+        }
+        queuePosition = scheduler->queuePosition(id);
+    }
+
+    if (queuePosition > 0) {
+        fmInfo() << "job starts after waiting for devices: " << scheduler->devicesOf(id);
+        queuePosition = 0;
+        // the speed does not count the time of waiting
+        time.start();
+    }
+    return true;
+}
+
 void FileOperateBaseWorker::emitSpeedUpdatedNotify(const qint64 &writSize)
 {
     JobInfoPointer info(new QMap<quint8, QVariant>);
-    qint64 speed = writSize * 1000 / (time.elapsed() == 0 ? 1 : time.elapsed());
     info->insert(AbstractJobHandler::NotifyInfoKey::kJobtypeKey, QVariant::fromValue(jobType));
     info->insert(AbstractJobHandler::NotifyInfoKey::kJobStateKey, QVariant::fromValue(currentState));
+    info->insert(AbstractJobHandler::NotifyInfoKey::kJobQueuePositionKey, QVariant::fromValue(queuePosition.load()));
+    if (queuePosition > 0) {
+        info->insert(AbstractJobHandler::NotifyInfoKey::kSpeedKey, QVariant::fromValue(tr("Waiting")));
+        info->insert(AbstractJobHandler::NotifyInfoKey::kRemindTimeKey,
+                     QVariant::fromValue(tr("%1 task(s) ahead on the same device").arg(queuePosition)));
+        emit stateChangedNotify(info);
+        emit speedUpdatedNotify(info);
+        return;
+    }
+
+    qint64 speed = writSize * 1000 / (time.elapsed() == 0 ? 1 : time.elapsed());
     info->insert(AbstractJobHandler::NotifyInfoKey::kSpeedKey, QVariant::fromValue(speed));
     info->insert(AbstractJobHandler::NotifyInfoKey::kRemindTimeKey, QVariant::fromValue(speed == 0 ? 0 : (sourceFilesTotalSize - writSize) / speed));
+    if (workData && workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyIntegrityChecking)) {
+        const qint64 checkTime = workData->checkSumTime;
+        info->insert(AbstractJobHandler::NotifyInfoKey::kCheckSumAlgorithmKey, QVariant::fromValue(FileChecksum::algorithm()));
+        info->insert(AbstractJobHandler::NotifyInfoKey::kCheckSumSpeedKey,
+                     QVariant::fromValue(workData->checkSumSize * 1000 / (checkTime == 0 ? 1 : checkTime)));
+    }
 
     emit stateChangedNotify(info);
     emit speedUpdatedNotify(info);
@@ -892,6 +947,7 @@ bool FileOperateBaseWorker::doCopyLocalBigFile(const FileInfoPointer fromInfo, c
         return false;
     }
     // memcpy file in other thread
+    const qint64 skippedSize = workData->skipWriteSize;
     memcpyLocalBigFile(fromInfo, toInfo, fromPoint, toPoint);
     // wait copy
     waitThreadPoolOver();
@@ -899,6 +955,10 @@ bool FileOperateBaseWorker::doCopyLocalBigFile(const FileInfoPointer fromInfo, c
     doCopyLocalBigFileClear(static_cast<size_t>(fromInfo->size()), fromFd, toFd, fromPoint, toPoint);
     // set permissions
     setTargetPermissions(fromInfo, toInfo);
+    // a part of the file is skipped if the skipped size is changed
+    if (workData->journal && !isStopped() && workData->skipWriteSize == skippedSize)
+        workData->journal->fileCompleted(fromInfo->urlOf(UrlInfoType::kUrl), toInfo->urlOf(UrlInfoType::kUrl),
+                                         fromInfo->size(), CopyJournal::mtimeOf(fromInfo));
     return true;
 }
 
@@ -1148,10 +1208,17 @@ bool FileOperateBaseWorker::doCopyFile(const FileInfoPointer &fromInfo, const Fi
 {
     FileInfoPointer newTargetInfo(nullptr);
     bool result = false;
+    // the target of the last run is used without checking, or it is taken as a conflict
+    if (doCopyJournaledFile(fromInfo, toInfo, newTargetInfo, skip, &result))
+        return result;
+
     if (!doCheckFile(fromInfo, toInfo,
                      fromInfo->nameOf(NameInfoType::kFileCopyName), newTargetInfo, skip))
         return result;
 
+    if (workData->journal && fromInfo->isAttributes(OptInfoType::kIsDir) && !fromInfo->isAttributes(OptInfoType::kIsSymLink))
+        workData->journal->dirCreated(fromInfo->urlOf(UrlInfoType::kUrl), newTargetInfo->urlOf(UrlInfoType::kUrl));
+
     if (fromInfo->isAttributes(OptInfoType::kIsSymLink)) {
         result = createSystemLink(fromInfo, newTargetInfo, workData->jobFlags.testFlag(AbstractJobHandler::JobFlag::kCopyFollowSymlink), true, skip);
         if (result)
@@ -1172,6 +1239,57 @@ bool FileOperateBaseWorker::doCopyFile(const FileInfoPointer &fromInfo, const Fi
     return result;
 }
 
+/*!
+ * \brief FileOperateBaseWorker::doCopyJournaledFile copy the file recorded in the journal of the last run
+ * The file completed is skipped, the file in progress is continued from its durable offset and
+ * the files in the dir created are merged into it.
+ * \return false if the file is not in the journal, it is copied as usual
+ */
+bool FileOperateBaseWorker::doCopyJournaledFile(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
+                                                FileInfoPointer &newTargetInfo, bool *skip, bool *result)
+{
+    if (!workData->journal || !workData->journal->isResuming() || fromInfo->isAttributes(OptInfoType::kIsSymLink))
+        return false;
+
+    const QUrl &fromUrl = fromInfo->urlOf(UrlInfoType::kUrl);
+    QUrl journaledTarget;
+    CopyJournal::Record record;
+    if (fromInfo->isAttributes(OptInfoType::kIsDir)) {
+        journaledTarget = workData->journal->dirTarget(fromUrl);
+    } else if (fromInfo->isAttributes(OptInfoType::kIsFile)) {
+        record = workData->journal->record(fromUrl, fromInfo->size(), CopyJournal::mtimeOf(fromInfo));
+        journaledTarget = record.target;
+    }
+    if (!journaledTarget.isValid())
+        return false;
+
+    newTargetInfo = InfoFactory::create<FileInfo>(journaledTarget, Global::CreateFileInfoType::kCreateFileInfoSync);
+    if (!newTargetInfo)
+        return false;
+
+    if (record.completed) {
+        workData->skipWriteSize += fromInfo->size() > 0 ? fromInfo->size() : FileUtils::getMemoryPageSize();
+        *result = true;
+    } else if (record.offset > 0) {
+        // the offset is continued by the block copy only
+        initSignalCopyWorker();
+        FileUtils::cacheCopyingFileUrl(journaledTarget.toString());
+        *result = copyOtherFileWorker->doCopyFilePractically(fromInfo, newTargetInfo, skip);
+        FileUtils::removeCopyingFileUrl(journaledTarget.toString());
+    } else {
+        *result = checkAndCopyDir(fromInfo, newTargetInfo, skip);
+        if (*result || skip)
+            workData->zeroOrlinkOrDirWriteSize += workData->dirSize <= 0 ? FileUtils::getMemoryPageSize() : workData->dirSize;
+    }
+
+    if (targetInfo == toInfo) {
+        completeSourceFiles.append(fromUrl);
+        precompleteTargetFileInfo.append(newTargetInfo);
+    }
+
+    return true;
+}
+
 bool FileOperateBaseWorker::canWriteFile(const QUrl &url) const
 {
     // root user return true direct
@@ -1230,9 +1348,8 @@ qint64 FileOperateBaseWorker::getWriteDataSize()
     } else if (CountWriteSizeType::kCustomizeType == countWriteType) {
         writeSize = workData->currentWriteSize;
     } else if (CountWriteSizeType::kWriteBlockType == countWriteType) {
-        qint64 currentSectorsWritten = getSectorsWritten() + workData->blockRenameWriteSize;
-        if (currentSectorsWritten > targetDeviceStartSectorsWritten)
-            writeSize = (currentSectorsWritten - targetDeviceStartSectorsWritten) * targetLogSecionSize;
+        // only the data on the device is counted, the data in page cache is not
+        writeSize = workData->syncedWriteSize + workData->blockRenameWriteSize;
     }
 
     writeSize += (workData->skipWriteSize + workData->zeroOrlinkOrDirWriteSize);
@@ -1278,20 +1395,6 @@ qint64 FileOperateBaseWorker::getTidWriteSize()
     return 0;
 }
 
-qint64 FileOperateBaseWorker::getSectorsWritten()
-{
-    QByteArray data;
-    QFile file(targetSysDevPath + "/stat");
-
-    if (file.open(QIODevice::ReadOnly)) {
-        data = file.readAll();
-        file.close();
-        return data.simplified().split(' ').value(6).toLongLong();
-    } else {
-        return 0;
-    }
-}
-
 void FileOperateBaseWorker::determineCountProcessType()
 {
     // 检查目标文件的有效性
@@ -1331,9 +1434,11 @@ void FileOperateBaseWorker::determineCountProcessType()
 
                         if (targetIsRemovable) {
                             workData->exBlockSyncEveryWrite = FileOperationsUtils::blockSync();
+                            // every write is synced already, or the data is written back in windows while copying
+                            if (!workData->exBlockSyncEveryWrite)
+                                workData->writeBack.reset(new WriteBackTracker(&workData->syncedWriteSize));
                             countWriteType = workData->exBlockSyncEveryWrite ? CountWriteSizeType::kCustomizeType
-                                                                             : CountWriteSizeType::kCustomizeType;
-                            targetDeviceStartSectorsWritten = workData->exBlockSyncEveryWrite ? 0 : getSectorsWritten();
+                                                                             : CountWriteSizeType::kWriteBlockType;
 
                             workData->isBlockDevice = true;
                         }
@@ -1359,18 +1464,23 @@ void FileOperateBaseWorker::syncFilesToDevice()
         return;
 
     fmInfo() << "start sync all file to extend block device!!!!! target : " << targetUrl;
-    sync();
+    // the progress is counted by the windows written back, wait for the rest of them after all the copy threads end
+    if (workData->writeBack) {
+        waitThreadPoolOver();
+        if (isStopped())
+            workData->writeBack->abandon();
+        else
+            workData->writeBack->finish();
+    }
+
+    // only the file system of target is synced, the others are not blocked
+    int fd = open(targetOrgUrl.path().toUtf8().constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        if (syncfs(fd) != 0)
+            fmWarning() << "syncfs failed, target: " << targetOrgUrl << " error: " << strerror(errno);
+        close(fd);
+    } else {
+        sync();
+    }
     fmInfo() << "end sync all file to extend block device!!!!! target : " << targetUrl;
-    // 这里本来是拷贝到了手动分区的盘，不需要后面去等待同步计算进度结果
-    if (CountWriteSizeType::kWriteBlockType != countWriteType)
-        return;
-    fmDebug() << "syncFilesToDevice begin";
-    sync();
-    qint64 writeSize = getWriteDataSize();
-    // 上面本来就自己阻塞调用了同步，这里不用计算写入是否是100%（这里统计的写入不一定准确）
-    while (!isStopped() && sourceFilesTotalSize > 0 && (static_cast<double>(writeSize) / sourceFilesTotalSize) < 0.98) {
-        QThread::msleep(100);
-        writeSize = getWriteDataSize();
-    }
-    fmDebug() << "syncFilesToDevice end";
 }
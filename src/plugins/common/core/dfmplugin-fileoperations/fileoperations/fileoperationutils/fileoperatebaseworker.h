@@ -53,7 +53,6 @@ public:
     void determineCountProcessType();
     qint64 getWriteDataSize();
     qint64 getTidWriteSize();
-    qint64 getSectorsWritten();
     void readAheadSourceFile(const FileInfoPointer &fileInfo);
     void syncFilesToDevice();
     AbstractJobHandler::SupportAction doHandleErrorAndWait(const QUrl &from, const QUrl &to,
@@ -61,6 +60,7 @@ public:
                                                            const bool isTo = false,
                                                            const QString &errorMsg = QString(),
                                                            const bool errorMsgAll = false);
+    bool waitForDevices(const QList<QUrl> &urls);
     // notify
     void emitSpeedUpdatedNotify(const qint64 &writSize);
 
@@ -76,6 +76,8 @@ public:
     bool canWriteFile(const QUrl &url) const;
 
     bool doCopyFile(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo, bool *skip);
+    bool doCopyJournaledFile(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo,
+                             FileInfoPointer &newTargetInfo, bool *skip, bool *result);
     bool checkAndCopyFile(const FileInfoPointer fromInfo, const FileInfoPointer toInfo, bool *skip);
     bool checkAndCopyDir(const FileInfoPointer &fromInfo, const FileInfoPointer &toInfo, bool *skip);
 
@@ -126,7 +128,6 @@ protected:
     FileInfoPointer targetInfo { nullptr };   // target file infor pointer
     CountWriteSizeType countWriteType { CountWriteSizeType::kCustomizeType };   // get write size type
     long copyTid = { -1 };   // 使用 /pric/[pid]/task/[tid]/io 文件中的的 writeBytes 字段的值作为判断已写入数据的依据
-    qint64 targetDeviceStartSectorsWritten { 0 };   // 记录任务开始时目标磁盘设备已写入扇区数
     QString targetSysDevPath;   // /sys/dev/block/x:x
     qint16 targetLogSecionSize { 512 };   // 目标设备逻辑扇区大小
     qint8 targetIsRemovable { 1 };   // 目标磁盘设备是不是可移除或者热插拔设备
@@ -135,6 +136,7 @@ protected:
     QString blocakTargetRootPath;
 
     std::atomic_int threadCopyFileCount { 0 };
+    std::atomic_int queuePosition { 0 };   // the position in the queue of devices, 0 if running
     QList<FileInfoPointer> cutAndDeleteFiles;
 };
 DPFILEOPERATIONS_END_NAMESPACE
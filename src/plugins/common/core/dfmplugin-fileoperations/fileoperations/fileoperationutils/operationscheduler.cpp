@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "operationscheduler.h"
+
+#include <dfm-base/base/device/deviceutils.h>
+
+#include <QDebug>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+DFMBASE_USE_NAMESPACE
+DPFILEOPERATIONS_USE_NAMESPACE
+
+namespace {
+// the jobs on a local disk can overlap a bit, the slow devices are used one by one
+constexpr int kDiskLimit { 2 };
+constexpr int kSlowDeviceLimit { 1 };
+}
+
+OperationScheduler *OperationScheduler::instance()
+{
+    static OperationScheduler ins;
+    return &ins;
+}
+
+QString OperationScheduler::deviceOf(const QUrl &url)
+{
+    // all the gvfs mounts have the source "gvfsd-fuse", the mount dir tells the scheme, host and share of them
+    static const QRegularExpression gvfsMount(R"(^/run/user/\d+/gvfs/[^/]+)");
+    if (url.isLocalFile()) {
+        const QRegularExpressionMatch &match = gvfsMount.match(url.path());
+        if (match.hasMatch())
+            return match.captured(0);
+    }
+
+    const QString &device = DeviceUtils::getMountSource(url);
+    if (!device.isEmpty())
+        return device;
+
+    // the device is unknown, the host of the url is the best guess
+    return url.scheme() + "://" + url.host();
+}
+
+int OperationScheduler::limitOf(const QUrl &url)
+{
+    if (DeviceUtils::isExternalBlock(url) || DeviceUtils::isLowSpeedDevice(url)
+        || DeviceUtils::isSamba(url) || DeviceUtils::isFtp(url) || DeviceUtils::isSftp(url)
+        || DeviceUtils::isMtpFile(url))
+        return kSlowDeviceLimit;
+
+    return kDiskLimit;
+}
+
+void OperationScheduler::enqueue(const quint64 id, const QList<QUrl> &urls, const Priority priority)
+{
+    Entry entry;
+    entry.id = id;
+    entry.priority = priority;
+    QHash<QString, int> entryLimits;
+    for (const QUrl &url : urls) {
+        const QString &device = deviceOf(url);
+        if (entry.devices.contains(device))
+            continue;
+        entry.devices.append(device);
+        entryLimits.insert(device, limitOf(url));
+    }
+
+    QMutexLocker lk(&mutex);
+    if (entries.contains(id)) {
+        fmWarning() << "the job has been queued, id: " << id;
+        return;
+    }
+
+    entry.seq = nextSeq++;
+    for (auto it = entryLimits.cbegin(); it != entryLimits.cend(); ++it) {
+        // the strictest limit wins if the urls differ in the same device
+        if (!limits.contains(it.key()) || limits.value(it.key()) > it.value())
+            limits.insert(it.key(), it.value());
+    }
+    entries.insert(id, entry);
+    schedule();
+}
+
+bool OperationScheduler::waitForStart(const quint64 id, const unsigned long msecs)
+{
+    QMutexLocker lk(&mutex);
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return false;
+    if (it->running)
+        return true;
+
+    startCondition.wait(&mutex, msecs);
+    it = entries.find(id);
+    return it != entries.end() && it->running;
+}
+
+void OperationScheduler::release(const quint64 id)
+{
+    QMutexLocker lk(&mutex);
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return;
+
+    if (it->running && !it->paused) {
+        for (const QString &device : it->devices)
+            running[device]--;
+    }
+    entries.erase(it);
+    schedule();
+}
+
+void OperationScheduler::setPaused(const quint64 id, const bool paused)
+{
+    QMutexLocker lk(&mutex);
+    auto it = entries.find(id);
+    if (it == entries.end() || it->paused == paused)
+        return;
+
+    it->paused = paused;
+    if (it->running) {
+        // the resumed job goes on at once, the others have to wait for it again
+        for (const QString &device : it->devices)
+            running[device] += paused ? -1 : 1;
+    }
+    schedule();
+}
+
+void OperationScheduler::setPriority(const quint64 id, const Priority priority)
+{
+    QMutexLocker lk(&mutex);
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return;
+
+    it->priority = priority;
+    schedule();
+}
+
+int OperationScheduler::queuePosition(const quint64 id) const
+{
+    QMutexLocker lk(&mutex);
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return -1;
+    if (it->running)
+        return 0;
+
+    int position = 1;
+    for (const Entry &other : entries) {
+        if (other.id != id && !other.running && shareDevice(other, *it) && rankBefore(other, *it))
+            ++position;
+    }
+    return position;
+}
+
+int OperationScheduler::runningCount(const QString &device) const
+{
+    QMutexLocker lk(&mutex);
+    return running.value(device);
+}
+
+QStringList OperationScheduler::devicesOf(const quint64 id) const
+{
+    QMutexLocker lk(&mutex);
+    return entries.value(id).devices;
+}
+
+bool OperationScheduler::rankBefore(const OperationScheduler::Entry &a, const OperationScheduler::Entry &b)
+{
+    if (a.priority != b.priority)
+        return a.priority > b.priority;
+    return a.seq < b.seq;
+}
+
+bool OperationScheduler::shareDevice(const OperationScheduler::Entry &a, const OperationScheduler::Entry &b)
+{
+    for (const QString &device : a.devices) {
+        if (b.devices.contains(device))
+            return true;
+    }
+    return false;
+}
+
+QStringList OperationScheduler::fullDevicesOf(const OperationScheduler::Entry &entry, const QHash<QString, int> &reserved) const
+{
+    QStringList full;
+    for (const QString &device : entry.devices) {
+        if (running.value(device) + reserved.value(device) >= limits.value(device, kDiskLimit))
+            full.append(device);
+    }
+    return full;
+}
+
+void OperationScheduler::schedule()
+{
+    QList<Entry *> waiting;
+    for (Entry &entry : entries) {
+        // the job paused in queue starts after resuming
+        if (!entry.running && !entry.paused)
+            waiting.append(&entry);
+    }
+    std::sort(waiting.begin(), waiting.end(), [](const Entry *a, const Entry *b) { return rankBefore(*a, *b); });
+
+    bool started = false;
+    QHash<QString, int> reserved;
+    for (Entry *entry : waiting) {
+        const QStringList &full = fullDevicesOf(*entry, reserved);
+        if (!full.isEmpty()) {
+            // keep the next slot of the device for the job only waiting for it, so the jobs of many devices
+            // are not starved; the job waiting for several devices keeps nothing, it would block the others long
+            if (full.size() == 1)
+                reserved[full.first()]++;
+            continue;
+        }
+
+        entry->running = true;
+        for (const QString &device : entry->devices)
+            running[device]++;
+        started = true;
+    }
+
+    if (started)
+        startCondition.wakeAll();
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef OPERATIONSCHEDULER_H
+#define OPERATIONSCHEDULER_H
+
+#include "dfmplugin_fileoperations_global.h"
+
+#include <QMap>
+#include <QHash>
+#include <QUrl>
+#include <QStringList>
+#include <QMutex>
+#include <QWaitCondition>
+
+DPFILEOPERATIONS_BEGIN_NAMESPACE
+
+/*!
+ * \brief The OperationScheduler class limits the jobs running on the same device in the process.
+ * Every job is queued with the devices of its sources and target, a job starts when all of its
+ * devices have a free slot which is not kept for the waiting jobs ranked before it.
+ * Jobs on different devices run in parallel, a paused job does not take its slots.
+ */
+class OperationScheduler
+{
+public:
+    enum class Priority : quint8 {
+        kLow,
+        kNormal,
+        kHigh,
+    };
+
+    static OperationScheduler *instance();
+
+    // the device of the url, the source of the mount it is on, or the mount dir for the gvfs mounts
+    static QString deviceOf(const QUrl &url);
+    // how many jobs can run on the device of the url at the same time
+    static int limitOf(const QUrl &url);
+
+    void enqueue(const quint64 id, const QList<QUrl> &urls, const Priority priority = Priority::kNormal);
+    // wait for the job to start for \a msecs at most, return true if it is running
+    bool waitForStart(const quint64 id, const unsigned long msecs);
+    void release(const quint64 id);
+    void setPaused(const quint64 id, const bool paused);
+    void setPriority(const quint64 id, const Priority priority);
+
+    // 0 if the job is running, the position in the waiting queue of its devices from 1,
+    // -1 if the job is not queued
+    int queuePosition(const quint64 id) const;
+    int runningCount(const QString &device) const;
+    QStringList devicesOf(const quint64 id) const;
+
+protected:
+    OperationScheduler() = default;
+
+private:
+    struct Entry
+    {
+        quint64 id { 0 };
+        quint64 seq { 0 };
+        Priority priority { Priority::kNormal };
+        QStringList devices;
+        bool running { false };
+        bool paused { false };
+    };
+
+    static bool rankBefore(const Entry &a, const Entry &b);
+    static bool shareDevice(const Entry &a, const Entry &b);
+    // the devices of the job with no slot left, the slots kept for the jobs ranked before are \a reserved
+    QStringList fullDevicesOf(const Entry &entry, const QHash<QString, int> &reserved) const;
+    void schedule();
+
+private:
+    mutable QMutex mutex;
+    QWaitCondition startCondition;
+    QMap<quint64, Entry> entries;
+    QHash<QString, int> limits;
+    QHash<QString, int> running;   // the running jobs not paused of every device
+    quint64 nextSeq { 0 };
+};
+
+DPFILEOPERATIONS_END_NAMESPACE
+
+#endif   // OPERATIONSCHEDULER_H
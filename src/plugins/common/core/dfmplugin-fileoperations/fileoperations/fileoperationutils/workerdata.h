@@ -16,6 +16,8 @@
 
 DPFILEOPERATIONS_BEGIN_NAMESPACE
 DFMBASE_USE_NAMESPACE
+class CopyJournal;
+class WriteBackTracker;
 class WorkerData
 {
 public:
@@ -60,7 +62,13 @@ public:
     QAtomicInteger<qint64> blockRenameWriteSize { 0 };   // The copy size is 0. The write statistics size of the linked file and directory
     QAtomicInteger<qint64> skipWriteSize { 0 };   // 跳过的文件大
     QAtomicInteger<qint64> completeFileCount { 0 };   // copy complete file count
+    QAtomicInteger<qint64> checkSumSize { 0 };   // the bytes read back for integrity checking
+    QAtomicInteger<qint64> checkSumTime { 0 };   // the msecs of reading back for integrity checking
+    // wait for the data written back to the device while copying, shared by all the copy threads of the job
+    QSharedPointer<WriteBackTracker> writeBack { nullptr };
+    QAtomicInteger<qint64> syncedWriteSize { 0 };   // the size of data written back to the device
     std::atomic_bool signalThread { true };
+    QSharedPointer<CopyJournal> journal { nullptr };   // the journal to resume the copy job
     DThreadMap<QUrl, qint64> everyFileWriteSize;
     DThreadList<QSharedPointer<DPFILEOPERATIONS_NAMESPACE::WorkerData::BlockFileCopyInfo>> blockCopyInfoQueue;
 };
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "writebacktracker.h"
+
+#include <QFile>
+#include <QDebug>
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+WriteBackTracker::WriteBackTracker(QAtomicInteger<qint64> *synced)
+    : synced(synced)
+{
+}
+
+WriteBackTracker::~WriteBackTracker()
+{
+    abandon();
+}
+
+bool WriteBackTracker::begin(Stream *stream, const QString &path, const qint64 offset)
+{
+    if (stream->fd >= 0)
+        end(stream);
+
+    // the dirty pages are shared by all fds of the file, a readonly fd is enough
+    stream->fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+    if (stream->fd < 0) {
+        fmWarning() << "failed to open file for write back, path: " << path << " error: " << strerror(errno);
+        return false;
+    }
+
+    stream->writtenSize = offset;
+    stream->submittedSize = offset;
+    return true;
+}
+
+void WriteBackTracker::written(Stream *stream, const qint64 size)
+{
+    if (stream->fd < 0 || size <= 0)
+        return;
+
+    stream->writtenSize += size;
+    while (stream->writtenSize - stream->submittedSize >= kWindowSize)
+        submit(stream, kWindowSize);
+}
+
+void WriteBackTracker::end(Stream *stream)
+{
+    if (stream->fd < 0)
+        return;
+
+    if (stream->writtenSize > stream->submittedSize)
+        submit(stream, stream->writtenSize - stream->submittedSize);
+    ::close(stream->fd);
+    stream->fd = -1;
+}
+
+void WriteBackTracker::track(const QString &path, const qint64 size)
+{
+    Stream stream;
+    if (!begin(&stream, path))
+        return;
+    written(&stream, size);
+    end(&stream);
+}
+
+void WriteBackTracker::finish()
+{
+    while (waitOldest()) {
+    }
+}
+
+void WriteBackTracker::abandon()
+{
+    QMutexLocker lk(&mutex);
+    while (!windows.isEmpty())
+        ::close(windows.dequeue().fd);
+    inFlightSize = 0;
+}
+
+void WriteBackTracker::submit(Stream *stream, const qint64 size)
+{
+    Window window;
+    window.fd = ::dup(stream->fd);
+    window.offset = stream->submittedSize;
+    window.size = size;
+    stream->submittedSize += size;
+    if (window.fd < 0) {
+        fmWarning() << "failed to track write back, error: " << strerror(errno);
+        return;
+    }
+
+    // start writing back without waiting
+    if (::sync_file_range(window.fd, window.offset, window.size, SYNC_FILE_RANGE_WRITE) != 0)
+        fmWarning() << "failed to start write back, error: " << strerror(errno);
+
+    {
+        QMutexLocker lk(&mutex);
+        windows.enqueue(window);
+        inFlightSize += window.size;
+    }
+
+    while (isFull() && waitOldest()) {
+    }
+}
+
+bool WriteBackTracker::isFull()
+{
+    QMutexLocker lk(&mutex);
+    return inFlightSize > kMaxWindows * kWindowSize || windows.size() > kMaxFiles;
+}
+
+bool WriteBackTracker::waitOldest()
+{
+    Window window;
+    {
+        QMutexLocker lk(&mutex);
+        if (windows.isEmpty())
+            return false;
+        window = windows.dequeue();
+        inFlightSize -= window.size;
+    }
+
+    // the window is taken by this thread only, the others go on while it is waited
+    // the pages written again after submitting are written back too
+    if (::sync_file_range(window.fd, window.offset, window.size,
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER)
+        != 0)
+        fmWarning() << "failed to wait write back, error: " << strerror(errno);
+    ::close(window.fd);
+
+    if (synced)
+        *synced += window.size;
+    return true;
+}
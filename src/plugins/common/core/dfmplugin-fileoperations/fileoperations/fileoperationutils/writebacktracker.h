@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WRITEBACKTRACKER_H
+#define WRITEBACKTRACKER_H
+
+#include "dfmplugin_fileoperations_global.h"
+
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+
+DPFILEOPERATIONS_BEGIN_NAMESPACE
+
+/*!
+ * \brief The WriteBackTracker class writes the copied data back to the device in windows behind the writers.
+ * Every full window of a file is submitted by sync_file_range(SYNC_FILE_RANGE_WRITE) at once,
+ * and the oldest ones are waited when too many are in flight, so the dirty data of the job is bounded
+ * and other file systems are not synced. The bytes of the completed windows are added to the counter,
+ * they have reached the device.
+ * One tracker is shared by all the copy threads of a job, the file being written by a thread is kept
+ * in its own Stream, and a window holds its own fd, so the windows are waited by any thread.
+ */
+class WriteBackTracker
+{
+public:
+    static constexpr qint64 kWindowSize { 8 * 1024 * 1024 };
+    static constexpr int kMaxWindows { 4 };   // the full windows in flight
+    static constexpr int kMaxFiles { 64 };   // the windows in flight, most of them are the small files
+
+    // the file being written by a thread
+    struct Stream
+    {
+        int fd { -1 };
+        qint64 writtenSize { 0 };
+        qint64 submittedSize { 0 };
+
+        inline bool isTracking() const { return fd >= 0; }
+    };
+
+    explicit WriteBackTracker(QAtomicInteger<qint64> *synced);
+    ~WriteBackTracker();
+
+    // track the file of \a path which is being written from \a offset, the data before it is on the device
+    bool begin(Stream *stream, const QString &path, const qint64 offset = 0);
+    // \a size bytes are appended to the file of \a stream
+    void written(Stream *stream, const qint64 size);
+    // the file is written, its last window is submitted
+    void end(Stream *stream);
+    // track the file of \a path which has been written by others
+    void track(const QString &path, const qint64 size);
+    // wait for all the windows submitted, the writers are ended
+    void finish();
+    // give up the windows in flight without waiting, they are still written back by the kernel
+    void abandon();
+
+private:
+    struct Window
+    {
+        int fd { -1 };   // dup of the fd of stream, closed after the window is done
+        qint64 offset { 0 };
+        qint64 size { 0 };
+    };
+
+    void submit(Stream *stream, const qint64 size);
+    bool isFull();
+    bool waitOldest();
+
+private:
+    QAtomicInteger<qint64> *synced { nullptr };
+    QMutex mutex;   // guards the windows
+    QQueue<Window> windows;
+    qint64 inFlightSize { 0 };
+};
+
+DPFILEOPERATIONS_END_NAMESPACE
+
+#endif   // WRITEBACKTRACKER_H
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "domovetotrashfilesworker.h"
+#include "hometrashwriter.h"
 
 #include <dfm-base/base/schemefactory.h>
 #include <dfm-base/base/standardpaths.h>
@@ -16,6 +17,8 @@
 #include <QtGlobal>
 #include <QCryptographicHash>
 #include <QStorageInfo>
+#include <QFile>
+#include <QDir>
 
 #include <unistd.h>
 #include <sys/stat.h>
@@ -70,9 +73,8 @@ void DoMoveToTrashFilesWorker::onUpdateProgress()
  */
 bool DoMoveToTrashFilesWorker::doMoveToTrash()
 {
-    bool result = false;
-    DFMBASE_NAMESPACE::LocalFileHandler fileHandler;
-    static QString homeTrashFileDir = dfmbase::StandardPaths::location(StandardPaths::StandardLocation::kTrashLocalFilesPath);
+    // <url, url after fstab binding>
+    QList<QPair<QUrl, QUrl>> sources;
     // 总大小使用源文件个数
     for (const auto &url : sourceUrls) {
         QUrl urlSource = url;
@@ -94,65 +96,163 @@ bool DoMoveToTrashFilesWorker::doMoveToTrash()
             continue;
         }
 
-        // url是否可以删除 canrename
-        if (!isCanMoveToTrash(urlSource, &result)) {
-            if (result) {
-                completeFilesCount++;
-                completeSourceFiles.append(urlSource);
-                continue;
-            }
+        sources.append(qMakePair(url, urlSource));
+    }
+
+    QList<QPair<QUrl, QUrl>> others;
+    if (!trashFilesByRename(sources, &others))
+        return false;
+
+    for (const auto &source : others) {
+        if (!trashFileOneByOne(source.first, source.second))
+            return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief DoMoveToTrashFilesWorker::trashFilesByRename move the files on the same device as home trash
+ * into it by renaming. The files are grouped by their parent dirs, the permission of a dir is checked once.
+ * \param others the files can not be renamed, they should be trashed one by one, which reports the errors.
+ * \return false if the job is stopped
+ */
+bool DoMoveToTrashFilesWorker::trashFilesByRename(const QList<QPair<QUrl, QUrl>> &sources, QList<QPair<QUrl, QUrl>> *others)
+{
+    HomeTrashWriter writer(StandardPaths::location(StandardPaths::kTrashLocalPath));
+    if (!writer.isValid()) {
+        fmWarning() << "can not open home trash, trash files one by one.";
+        *others = sources;
+        return true;
+    }
+
+    QMap<QString, QList<QPair<QUrl, QUrl>>> groups;
+    for (const auto &source : sources) {
+        const QString &path = QDir::cleanPath(source.second.toLocalFile());
+        if (!source.second.isLocalFile() || path == "/") {
+            others->append(source);
+            continue;
+        }
+        groups[path.left(qMax(1, path.lastIndexOf('/')))].append(source);
+    }
+
+    const uid_t uid = ::getuid();
+    for (auto group = groups.begin(); group != groups.end(); ++group) {
+        if (!stateCheck())
             return false;
+
+        const QByteArray &dirPath = QFile::encodeName(group.key());
+        int dirFd = ::open(dirPath.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        struct stat dirStat;
+        bool usable = dirFd >= 0 && ::fstat(dirFd, &dirStat) == 0 && dirStat.st_dev == writer.device()
+                && (uid == 0 || ::access(dirPath.constData(), W_OK | X_OK) == 0);
+        if (!usable) {
+            if (dirFd >= 0)
+                ::close(dirFd);
+            others->append(group.value());
+            continue;
         }
+        // only the owner can remove the file in a dir with sticky bit.
+        const bool sticky = uid != 0 && (dirStat.st_mode & S_ISVTX) && dirStat.st_uid != uid;
 
-        const auto &fileInfo = InfoFactory::create<FileInfo>(urlSource, Global::CreateFileInfoType::kCreateFileInfoSync);
-        if (!fileInfo) {
-            // pause and emit error msg
-            if (AbstractJobHandler::SupportAction::kSkipAction != doHandleErrorAndWait(urlSource, targetUrl, AbstractJobHandler::JobErrorType::kProrogramError)) {
+        emitCurrentTaskNotify(group.value().first().second, targetUrl);
+        for (const auto &source : group.value()) {
+            if (!stateCheck()) {
+                ::close(dirFd);
                 return false;
-            } else {
-                completeFilesCount++;
+            }
+
+            const QByteArray &path = QFile::encodeName(QDir::cleanPath(source.second.toLocalFile()));
+            const QByteArray &name = path.mid(path.lastIndexOf('/') + 1);
+            struct stat st;
+            if (::fstatat(dirFd, name.constData(), &st, AT_SYMLINK_NOFOLLOW) != 0
+                || st.st_dev != writer.device() || (sticky && st.st_uid != uid)) {
+                others->append(source);
                 continue;
             }
+
+            QString trashTime;
+            if (!writer.trash(dirFd, name, path, &trashTime)) {
+                fmWarning() << "rename to trash failed:" << source.second << strerror(writer.lastError());
+                others->append(source);
+                continue;
+            }
+
+            QUrl trashUrl = source.second;
+            trashUrl.setUserInfo(trashTime);
+            completeTargetFiles.append(trashUrl);
+            completeSourceFiles.append(source.second);
+            completeFilesCount++;
         }
+        ::close(dirFd);
 
-        emitCurrentTaskNotify(urlSource, targetUrl);
+        emitProgressChangedNotify(completeFilesCount);
+    }
 
-        AbstractJobHandler::SupportAction action = AbstractJobHandler::SupportAction::kNoAction;
-        do {
-            action = AbstractJobHandler::SupportAction::kNoAction;
-            QString trashTime = fileHandler.trashFile(urlSource);
-            if (!trashTime.isEmpty()) {
-                QUrl trashUrl = urlSource;
-                trashUrl.setUserInfo(trashTime);
+    return true;
+}
 
-                completeTargetFiles.append(trashUrl);
-                emitProgressChangedNotify(completeFilesCount);
-                completeSourceFiles.append(urlSource);
-                continue;
-            } else {
-                // pause and emit error msg
-                auto errmsg = QString("Unknown error");
-                if (fileHandler.errorCode() == DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED) {
-                    errmsg = QString("The file can't be put into trash, you can use \"Shift+Del\" to delete the file completely.");
-                } else if (fileHandler.errorCode() != DFMIOErrorCode::DFM_IO_ERROR_NONE) {
-                    errmsg = fileHandler.errorString();
-                }
-                action = doHandleErrorAndWait(url, QUrl(),
-                                              AbstractJobHandler::JobErrorType::kFileMoveToTrashError, false,
-                                              fileHandler.errorCode() == DFMIOErrorCode::DFM_IO_ERROR_NONE ? "Unknown error"
-                                                                                                           : fileHandler.errorString());
-            }
-        } while (action == AbstractJobHandler::SupportAction::kRetryAction && !isStopped());
+bool DoMoveToTrashFilesWorker::trashFileOneByOne(const QUrl &url, const QUrl &urlSource)
+{
+    bool result = false;
+    DFMBASE_NAMESPACE::LocalFileHandler fileHandler;
+
+    // url是否可以删除 canrename
+    if (!isCanMoveToTrash(urlSource, &result)) {
+        if (result) {
+            completeFilesCount++;
+            completeSourceFiles.append(urlSource);
+            return true;
+        }
+        return false;
+    }
 
-        if (action == AbstractJobHandler::SupportAction::kNoAction
-            || action == AbstractJobHandler::SupportAction::kSkipAction) {
+    const auto &fileInfo = InfoFactory::create<FileInfo>(urlSource, Global::CreateFileInfoType::kCreateFileInfoSync);
+    if (!fileInfo) {
+        // pause and emit error msg
+        if (AbstractJobHandler::SupportAction::kSkipAction != doHandleErrorAndWait(urlSource, targetUrl, AbstractJobHandler::JobErrorType::kProrogramError)) {
+            return false;
+        } else {
             completeFilesCount++;
+            return true;
+        }
+    }
+
+    emitCurrentTaskNotify(urlSource, targetUrl);
+
+    AbstractJobHandler::SupportAction action = AbstractJobHandler::SupportAction::kNoAction;
+    do {
+        action = AbstractJobHandler::SupportAction::kNoAction;
+        QString trashTime = fileHandler.trashFile(urlSource);
+        if (!trashTime.isEmpty()) {
+            QUrl trashUrl = urlSource;
+            trashUrl.setUserInfo(trashTime);
+
+            completeTargetFiles.append(trashUrl);
+            emitProgressChangedNotify(completeFilesCount);
+            completeSourceFiles.append(urlSource);
             continue;
+        } else {
+            // pause and emit error msg
+            auto errmsg = QString("Unknown error");
+            if (fileHandler.errorCode() == DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED) {
+                errmsg = QString("The file can't be put into trash, you can use \"Shift+Del\" to delete the file completely.");
+            } else if (fileHandler.errorCode() != DFMIOErrorCode::DFM_IO_ERROR_NONE) {
+                errmsg = fileHandler.errorString();
+            }
+            action = doHandleErrorAndWait(url, QUrl(),
+                                          AbstractJobHandler::JobErrorType::kFileMoveToTrashError, false,
+                                          fileHandler.errorCode() == DFMIOErrorCode::DFM_IO_ERROR_NONE ? "Unknown error"
+                                                                                                       : fileHandler.errorString());
         }
+    } while (action == AbstractJobHandler::SupportAction::kRetryAction && !isStopped());
 
-        return false;
+    if (action == AbstractJobHandler::SupportAction::kNoAction
+        || action == AbstractJobHandler::SupportAction::kSkipAction) {
+        completeFilesCount++;
+        return true;
     }
-    return true;
+
+    return false;
 }
 
 /*!
@@ -35,6 +35,8 @@ protected:
 
 protected:
     bool doMoveToTrash();
+    bool trashFilesByRename(const QList<QPair<QUrl, QUrl>> &sources, QList<QPair<QUrl, QUrl>> *others);
+    bool trashFileOneByOne(const QUrl &url, const QUrl &urlSource);
     bool isCanMoveToTrash(const QUrl &url, bool *result);
 
 private:
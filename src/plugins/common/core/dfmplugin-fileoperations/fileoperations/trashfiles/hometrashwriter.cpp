@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "hometrashwriter.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <syscall.h>
+#include <sys/stat.h>
+
+#ifndef RENAME_NOREPLACE
+#    define RENAME_NOREPLACE (1 << 0)
+#endif
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+namespace {
+// the same limitation as gio
+constexpr int kMaxNameRetry { 10000 };
+}
+
+HomeTrashWriter::HomeTrashWriter(const QString &trashPath)
+{
+    // the trash dirs are private to the user.
+    for (const QString &sub : { QStringLiteral("/files"), QStringLiteral("/info") }) {
+        if (!QDir().mkpath(trashPath + sub))
+            return;
+        QFile::setPermissions(trashPath + sub, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+    }
+
+    filesFd = ::open(QFile::encodeName(trashPath + "/files").constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    infoFd = ::open(QFile::encodeName(trashPath + "/info").constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    struct stat st;
+    if (filesFd >= 0 && ::fstat(filesFd, &st) == 0) {
+        trashDevice = st.st_dev;
+    } else if (filesFd >= 0) {
+        ::close(filesFd);
+        filesFd = -1;
+    }
+
+    record.reserve(4096);
+}
+
+HomeTrashWriter::~HomeTrashWriter()
+{
+    if (filesFd >= 0)
+        ::close(filesFd);
+    if (infoFd >= 0)
+        ::close(infoFd);
+}
+
+bool HomeTrashWriter::trash(int dirFd, const QByteArray &name, const QByteArray &path, QString *trashTime)
+{
+    const qint64 start = QDateTime::currentSecsSinceEpoch();
+
+    QByteArray trashName;
+    if (!reserve(name, path, &trashName))
+        return false;
+
+    if (!renameToTrash(dirFd, name, trashName)) {
+        // give back the reserved name.
+        ::unlinkat(infoFd, (trashName + ".trashinfo").constData(), 0);
+        return false;
+    }
+
+    if (trashTime)
+        *trashTime = QString("%1-%2").arg(start).arg(QDateTime::currentSecsSinceEpoch());
+    return true;
+}
+
+/*!
+ * \brief HomeTrashWriter::reserve create the .trashinfo exclusively to hold the name in trash,
+ * as the trash specification requires, and write the record of \a path into it.
+ */
+bool HomeTrashWriter::reserve(const QByteArray &baseName, const QByteArray &path, QByteArray *trashName)
+{
+    const QByteArray &date = QDateTime::currentDateTime().toString("yyyy-MM-ddThh:mm:ss").toLatin1();
+    record.clear();
+    record.append("[Trash Info]\nPath=");
+    record.append(path.toPercentEncoding("/"));
+    record.append("\nDeletionDate=");
+    record.append(date);
+    record.append('\n');
+
+    for (int i = 1; i <= kMaxNameRetry; ++i) {
+        const QByteArray &candidate = i == 1 ? baseName : baseName + '.' + QByteArray::number(i);
+        // the orphan files in files/ also hold their names.
+        if (::faccessat(filesFd, candidate.constData(), F_OK, AT_SYMLINK_NOFOLLOW) == 0)
+            continue;
+
+        int fd = ::openat(infoFd, (candidate + ".trashinfo").constData(),
+                          O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            if (errno == EEXIST)
+                continue;
+            lastErrno = errno;
+            return false;
+        }
+
+        const char *data = record.constData();
+        qint64 left = record.size();
+        while (left > 0) {
+            ssize_t written = ::write(fd, data, static_cast<size_t>(left));
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0) {
+                lastErrno = errno;
+                ::close(fd);
+                ::unlinkat(infoFd, (candidate + ".trashinfo").constData(), 0);
+                return false;
+            }
+            data += written;
+            left -= written;
+        }
+        ::close(fd);
+
+        *trashName = candidate;
+        return true;
+    }
+
+    lastErrno = EEXIST;
+    return false;
+}
+
+bool HomeTrashWriter::renameToTrash(int dirFd, const QByteArray &name, const QByteArray &trashName)
+{
+    // no plain renameat if renameat2 is not supported, it may replace a file, the file is trashed one by one then.
+    long ret = ::syscall(SYS_renameat2, dirFd, name.constData(), filesFd, trashName.constData(), RENAME_NOREPLACE);
+    if (ret != 0) {
+        lastErrno = errno;
+        return false;
+    }
+
+    return true;
+}
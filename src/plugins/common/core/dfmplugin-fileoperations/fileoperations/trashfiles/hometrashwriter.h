@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HOMETRASHWRITER_H
+#define HOMETRASHWRITER_H
+
+#include "dfmplugin_fileoperations_global.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <sys/types.h>
+
+DPFILEOPERATIONS_BEGIN_NAMESPACE
+
+/*!
+ * \brief The HomeTrashWriter class moves files into the home trash by renaming.
+ * It keeps the files/ and info/ dirs of the trash opened and writes the .trashinfo
+ * records with one reused buffer. It only works for files on the same device as the trash,
+ * the others should be trashed by gio.
+ */
+class HomeTrashWriter
+{
+public:
+    explicit HomeTrashWriter(const QString &trashPath);
+    ~HomeTrashWriter();
+
+    inline bool isValid() const { return filesFd >= 0 && infoFd >= 0; }
+    inline dev_t device() const { return trashDevice; }
+    inline int lastError() const { return lastErrno; }
+
+    // move \a name in \a dirFd whose full path is \a path to trash,
+    // \a trashTime is set to the time range of deleting as LocalFileHandler::trashFile does.
+    bool trash(int dirFd, const QByteArray &name, const QByteArray &path, QString *trashTime);
+
+private:
+    bool reserve(const QByteArray &baseName, const QByteArray &path, QByteArray *trashName);
+    bool renameToTrash(int dirFd, const QByteArray &name, const QByteArray &trashName);
+
+private:
+    int filesFd { -1 };
+    int infoFd { -1 };
+    dev_t trashDevice { 0 };
+    int lastErrno { 0 };
+    QByteArray record;   // the content of .trashinfo, reused for every file
+};
+
+DPFILEOPERATIONS_END_NAMESPACE
+
+#endif   // HOMETRASHWRITER_H
@@ -174,115 +174,6 @@ DCustomActionDefines::ComboType DCustomActionBuilder::checkFileComboWithFocus(co
     return DCustomActionDefines::kBlankSpace;
 }
 
-/*!
-    筛选 \a rootActions 中支持 \a type 文件组合的菜单项
- */
-QList<DCustomActionEntry> DCustomActionBuilder::matchFileCombo(const QList<DCustomActionEntry> &rootActions,
-                                                               DCustomActionDefines::ComboTypes type)
-{
-    QList<DCustomActionEntry> ret;
-    //无自定义菜单项
-    if (0 == rootActions.size())
-        return ret;
-
-#ifdef MENU_CHECK_FOCUSONLY
-    // add kFileAndDir if type is kMultiDirs or kMultiFiles.
-    if (type == DCustomActionDefines::kMultiDirs
-        || type == DCustomActionDefines::kMultiFiles) {
-        type |= DCustomActionDefines::kFileAndDir;
-    }
-#endif
-
-    for (auto it = rootActions.begin(); it != rootActions.end(); ++it) {
-        if (it->fileCombo() & type)
-            ret << *it;
-    }
-    return ret;
-}
-
-QList<DCustomActionEntry> DCustomActionBuilder::matchActions(const QList<QUrl> &selects,
-                                                             QList<DCustomActionEntry> oriActions)
-{
-    // todo：细化功能颗粒度，一个函数尽量专职一件事
-    /*
-     *根据选中内容、配置项、选中项类型匹配合适的菜单项
-     *是否action支持的协议
-     *是否action支持的后缀
-     *action不支持类型过滤（不加上父类型过滤，todo: 为何不支持项不考虑?）
-     *action支持类型过滤(类型过滤要加上父类型一起过滤)
-     */
-
-    //具体配置过滤
-    for (auto &singleUrl : selects) {
-        //协议、后缀
-        QString errString;
-        const FileInfoPointer &fileInfo = DFMBASE_NAMESPACE::InfoFactory::create<FileInfo>(singleUrl, Global::CreateFileInfoType::kCreateFileInfoAuto, &errString);
-        if (fileInfo.isNull()) {
-            fmWarning() << "create selected FileInfo failed: " << singleUrl.toString() << errString;
-            continue;
-        }
-
-        /*
-         * 选中文件类型过滤：
-         * fileMimeTypes:包括所有父类型的全量类型集合
-         * fileMimeTypesNoParent:不包含父类mimetype的集合
-         * 目的是在一些应用对文件的识别支持上有差异：比如xlsx的 parentMimeTypes 是application/zip
-         * 归档管理器打开则会被作为解压
-         */
-
-        QStringList fileMimeTypes;
-        QStringList fileMimeTypesNoParent;
-        //        fileMimeTypes.append(fileInfo->mimeType().name());
-        //        fileMimeTypes.append(fileInfo->mimeType().aliases());
-        //        const QMimeType &mt = fileInfo->mimeType();
-        //        fileMimeTypesNoParent = fileMimeTypes;
-        //        appendParentMimeType(mt.parentMimeTypes(), fileMimeTypes);
-        //        fileMimeTypes.removeAll({});
-        //        fileMimeTypesNoParent.removeAll({});
-
-        appendAllMimeTypes(fileInfo, fileMimeTypesNoParent, fileMimeTypes);
-        for (auto it = oriActions.begin(); it != oriActions.end();) {
-            DCustomActionEntry &tempAction = *it;
-            //协议，后缀
-            if (!isSchemeSupport(tempAction, singleUrl) || !isSuffixSupport(tempAction, fileInfo)) {
-                it = oriActions.erase(it);   //不支持的action移除
-                continue;
-            }
-
-            //不支持的mimetypes,使用不包含父类型的mimetype集合过滤
-            if (isMimeTypeMatch(fileMimeTypesNoParent, tempAction.excludeMimeTypes())) {
-                it = oriActions.erase(it);
-                continue;
-            }
-
-            // MimeType在原有oem中，未指明或Mimetype=*都作为支持所有类型
-            if (tempAction.mimeTypes().isEmpty()) {
-                ++it;
-                continue;
-            }
-
-            //支持的mimetype,使用包含父类型的mimetype集合过滤
-            QStringList supportMimeTypes = tempAction.mimeTypes();
-            supportMimeTypes.removeAll({});
-            auto match = isMimeTypeMatch(fileMimeTypes, supportMimeTypes);
-
-//在自定义右键菜中有作用域限制，此类情况不显示自定义菜单，故可屏蔽，若后续有作用域的调整再考虑是否开放
-#if 0
-            //部分mtp挂载设备目录下文件属性不符合规范(普通目录mimetype被认为是octet-stream)，暂时做特殊处理-
-            if (singleUrl.path().contains("/mtp:host") && supportMimeTypes.contains("application/octet-stream") && fileMimeTypes.contains("application/octet-stream"))
-                match = false;
-#endif
-            if (!match) {
-                it = oriActions.erase(it);
-                continue;
-            }
-            ++it;
-        }
-    }
-
-    return oriActions;
-}
-
 /*!
     展开 \a cmd 中需要的参数。只处理找到的一个有效的 \a arg 参数，后面的不再替换。
     参数类型只支持：DirPath FilePath FilePaths UrlPath UrlPaths
@@ -419,95 +310,6 @@ QStringList DCustomActionBuilder::splitCommand(const QString &cmd)
     return args;
 }
 
-bool DCustomActionBuilder::isMimeTypeSupport(const QString &mt, const QStringList &fileMimeTypes)
-{
-    foreach (const QString &fmt, fileMimeTypes) {
-        if (fmt.contains(mt, Qt::CaseInsensitive)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-bool DCustomActionBuilder::isMimeTypeMatch(const QStringList &fileMimeTypes, const QStringList &supportMimeTypes)
-{
-    bool match = false;
-    for (const QString &mt : supportMimeTypes) {
-        if (fileMimeTypes.contains(mt, Qt::CaseInsensitive)) {
-            match = true;
-            break;
-        }
-
-        int starPos = mt.indexOf("*");
-        if (starPos >= 0 && isMimeTypeSupport(mt.left(starPos), fileMimeTypes)) {
-            match = true;
-            break;
-        }
-    }
-    return match;
-}
-
-bool DCustomActionBuilder::isSchemeSupport(const DCustomActionEntry &action, const QUrl &url)
-{
-    // X-DFM-SupportSchemes not exist
-    auto supportList = action.surpportSchemes();
-    if (supportList.contains("*") || supportList.isEmpty())
-        return true;   //支持所有协议: 未特殊指明X-DFM-SupportSchemes或者"X-DFM-SupportSchemes=*"
-    return supportList.contains(url.scheme(), Qt::CaseInsensitive);
-}
-
-bool DCustomActionBuilder::isSuffixSupport(const DCustomActionEntry &action, FileInfoPointer fileInfo)
-{
-    QString errString;
-    auto supportList = action.supportStuffix();
-    if (!fileInfo || fileInfo->isAttributes(OptInfoType::kIsDir) || supportList.isEmpty() || supportList.contains("*")) {
-        return true;   //未特殊指明支持项或者包含*为支持所有
-    }
-
-    //例如： 7z.001,7z.002, 7z.003 ... 7z.xxx
-    QString cs = fileInfo->nameOf(NameInfoType::kCompleteSuffix);
-    if (supportList.contains(cs, Qt::CaseInsensitive)) {
-        return true;
-    }
-
-    bool match = false;
-    for (const QString &suffix : supportList) {
-        auto tempSuffix = suffix;
-        int endPos = tempSuffix.lastIndexOf("*");   // 例如：7z.*
-        if (endPos >= 0 && cs.length() > endPos && tempSuffix.left(endPos) == cs.left(endPos)) {
-            match = true;
-            break;
-        }
-    }
-    return match;
-}
-
-void DCustomActionBuilder::appendAllMimeTypes(const FileInfoPointer &fileInfo, QStringList &noParentmimeTypes, QStringList &allMimeTypes)
-{
-    noParentmimeTypes.append(fileInfo->fileMimeType().name());
-    noParentmimeTypes.append(fileInfo->fileMimeType().aliases());
-    const QMimeType &mt = fileInfo->fileMimeType();
-    allMimeTypes = noParentmimeTypes;
-    appendParentMimeType(mt.parentMimeTypes(), allMimeTypes);
-    noParentmimeTypes.removeAll({});
-    allMimeTypes.removeAll({});
-}
-
-void DCustomActionBuilder::appendParentMimeType(const QStringList &parentmimeTypes, QStringList &mimeTypes)
-{
-    if (parentmimeTypes.size() == 0)
-        return;
-
-    for (const QString &mtName : parentmimeTypes) {
-        DFMBASE_NAMESPACE::DMimeDatabase db;
-        QMimeType mt = db.mimeTypeForName(mtName);
-        mimeTypes.append(mt.name());
-        mimeTypes.append(mt.aliases());
-        QStringList pmts = mt.parentMimeTypes();
-        appendParentMimeType(pmts, mimeTypes);
-    }
-}
-
 /*!
     创建菜单项，\a parentForSubmenu 用于指定菜单的父对象，用于自动释放
     通过获取 \a actionData 中的标题，图标等信息创建菜单项，并遍历创建子项和分割符号。
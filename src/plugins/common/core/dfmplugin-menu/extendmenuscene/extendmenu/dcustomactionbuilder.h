@@ -30,22 +30,10 @@ public:
     QString getCompleteSuffix(const QString &fileName, const QString &suf);
     static DCustomActionDefines::ComboType checkFileCombo(const QList<QUrl> &files);
     static DCustomActionDefines::ComboType checkFileComboWithFocus(const QUrl &focus, const QList<QUrl> &files);
-    static QList<DCustomActionEntry> matchFileCombo(const QList<DCustomActionEntry> &rootActions,
-                                                    DCustomActionDefines::ComboTypes type);
-    static QList<DCustomActionEntry> matchActions(const QList<QUrl> &selects,
-                                                  QList<DCustomActionEntry> oriActions);
     static QPair<QString, QStringList> makeCommand(const QString &cmd, DCustomActionDefines::ActionArg arg,
                                                    const QUrl &dir, const QUrl &foucs, const QList<QUrl> &files);
     static QStringList splitCommand(const QString &cmd);
 
-private:
-    static bool isMimeTypeSupport(const QString &mt, const QStringList &fileMimeTypes);
-    static bool isMimeTypeMatch(const QStringList &fileMimeTypes, const QStringList &supportMimeTypes);
-    static bool isSchemeSupport(const DCustomActionEntry &action, const QUrl &url);
-    static bool isSuffixSupport(const DCustomActionEntry &action, FileInfoPointer fileInfo);
-    static void appendAllMimeTypes(const FileInfoPointer &fileInfo, QStringList &noParentmimeTypes, QStringList &allMimeTypes);
-    static void appendParentMimeType(const QStringList &parentmimeTypes, QStringList &mimeTypes);
-
 protected:
     QAction *createMenu(const DCustomActionData &actionData, QWidget *parentForSubmenu) const;
     QAction *createAciton(const DCustomActionData &actionData) const;
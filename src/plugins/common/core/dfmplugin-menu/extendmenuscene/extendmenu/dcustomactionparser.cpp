@@ -128,6 +128,8 @@ bool DCustomActionParser::loadDir(const QStringList &dirPaths)
             parseFile(actionSetting);
         }
     }
+
+    initIndex();
     return true;
 }
 
@@ -147,6 +149,43 @@ QList<DCustomActionEntry> DCustomActionParser::getActionFiles(bool onDesktop)
     return ret;
 }
 
+/*!
+    返回值QList<DCustomActionEntry>，返回 \a selects 中的文件都支持的菜单项，
+    \a type 为选中项的文件组合，\a onDesktop 匹配是否不再桌面/文管显示
+*/
+QList<DCustomActionEntry> DCustomActionParser::matchActions(const QList<QUrl> &selects, DCustomActionDefines::ComboTypes type, bool onDesktop)
+{
+#ifdef MENU_CHECK_FOCUSONLY
+    // add kFileAndDir if type is kMultiDirs or kMultiFiles.
+    if (type == DCustomActionDefines::kMultiDirs
+        || type == DCustomActionDefines::kMultiFiles) {
+        type |= DCustomActionDefines::kFileAndDir;
+    }
+#endif
+
+    QBitArray actions = actionIndex.actionsOfCombo(static_cast<int>(type));
+    actions &= actionIndex.actionsShownOn(onDesktop);
+
+    //协议、后缀和类型，同类型的文件只匹配一次
+    for (const QUrl &singleUrl : selects) {
+        if (MenuActionIndex::isEmpty(actions))
+            break;
+
+        QString errString;
+        const FileInfoPointer &fileInfo = DFMBASE_NAMESPACE::InfoFactory::create<FileInfo>(singleUrl, Global::CreateFileInfoType::kCreateFileInfoAuto, &errString);
+        if (fileInfo.isNull()) {
+            fmWarning() << "create selected FileInfo failed: " << singleUrl.toString() << errString;
+            continue;
+        }
+        actions &= actionIndex.actionsOfFile(fileInfo);
+    }
+
+    QList<DCustomActionEntry> ret;
+    for (int id : MenuActionIndex::ids(actions))
+        ret << actionEntry.at(id);
+    return ret;
+}
+
 /*!
     根据传入的\a actionSetting 解析菜单项，返回返回值为解析成功与否，关键字段缺失会被断定未无效文件，归于失败
 */
@@ -419,6 +458,31 @@ void DCustomActionParser::initHash()
     actionExecArg.insert(kStrActionArg[kUrlPaths], ActionArg::kUrlPaths);   //"%U"
 }
 
+/*!
+    以解析出的一级菜单项建立匹配索引，配置变化重新加载时重建
+*/
+void DCustomActionParser::initIndex()
+{
+    actionIndex.clear();
+    for (const DCustomActionEntry &entry : actionEntry) {
+        MenuActionIndex::Rule rule;
+        rule.combos = static_cast<int>(entry.fileCombo());
+        rule.showOnDesktop = isActionShouldShow(entry.notShowIn(), true);
+        rule.showInFileManager = isActionShouldShow(entry.notShowIn(), false);
+        //支持所有协议: 未特殊指明X-DFM-SupportSchemes或者"X-DFM-SupportSchemes=*"
+        rule.schemes = entry.surpportSchemes();
+        rule.anyScheme = rule.schemes.isEmpty() || rule.schemes.contains("*");
+        //未特殊指明支持后缀或者包含*为支持所有
+        rule.suffixes = entry.supportStuffix();
+        rule.anySuffix = rule.suffixes.isEmpty() || rule.suffixes.contains("*");
+        // MimeType在原有oem中，未指明或Mimetype=*都作为支持所有类型
+        rule.mimeTypes = entry.mimeTypes();
+        rule.anyMimeType = rule.mimeTypes.isEmpty();
+        rule.excludeMimeTypes = entry.excludeMimeTypes();
+        actionIndex.append(rule);
+    }
+}
+
 /*!
     获取配置文件对应组下的对应字段信息，\a actionSetting 是解析对象，\a group是待解析的组， \a key是待解析字段
 */
@@ -7,6 +7,7 @@
 
 #include "dfmplugin_menu_global.h"
 #include "dcustomactiondata.h"
+#include "utils/menuactionindex.h"
 
 #include <dfm-base/base/schemefactory.h>
 
@@ -43,10 +44,12 @@ public:
     ~DCustomActionParser();
 
     QList<DCustomActionEntry> getActionFiles(bool onDesktop);
+    QList<DCustomActionEntry> matchActions(const QList<QUrl> &selects, DCustomActionDefines::ComboTypes type, bool onDesktop);
 
     inline void refresh()
     {
         actionEntry.clear();
+        actionIndex.clear();
         loadDir(menuPaths);
     }
 protected slots:
@@ -61,6 +64,7 @@ private:
     bool parseFile(QList<DCustomActionData> &childrenActions, QSettings &actionSetting, const QString &group, const DCustomActionDefines::FileBasicInfos &basicInfos, bool &isSort, bool isTop = false);
     void initWatcher();
     void initHash();
+    void initIndex();
     QVariant getValue(QSettings &actionSetting, const QString &group, const QString &key);
     bool actionFileInfos(DCustomActionDefines::FileBasicInfos &basicInfo, QSettings &actionSetting);
 
@@ -74,6 +78,7 @@ private:
     QStringList menuPaths;
     QList<AbstractFileWatcherPointer> watcherGroup;
     QList<DCustomActionEntry> actionEntry;
+    MenuActionIndex actionIndex;   // the index of action is the one of its entry
     QSettings::Format customFormat;
     QHash<QString, DCustomActionDefines::ComboType> combos;
     QHash<QString, DCustomActionDefines::Separator> separtor;
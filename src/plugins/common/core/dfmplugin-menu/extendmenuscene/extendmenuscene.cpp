@@ -247,14 +247,11 @@ bool ExtendMenuScene::create(QMenu *parent)
         builder.setFocusFile(d->focusFile);
     }
 
-    //获取支持的菜单项
-    auto usedEntrys = builder.matchFileCombo(rootEntry, fileCombo);
-
-    //匹配类型支持
+    //获取支持文件组合及类型的菜单项
 #ifdef MENU_CHECK_FOCUSONLY
-    usedEntrys = builder.matchActions({ d->focusFile }, usedEntrys);
+    auto usedEntrys = d->customParser->matchActions({ d->focusFile }, fileCombo, d->onDesktop);
 #else
-    usedEntrys = builder.matchActions(d->selectFiles, usedEntrys);
+    auto usedEntrys = d->customParser->matchActions(d->selectFiles, fileCombo, d->onDesktop);
 #endif
     fmDebug() << "selected combo" << fileCombo << "entry count" << usedEntrys.size();
 
@@ -9,7 +9,6 @@
 #include <dfm-base/base/schemefactory.h>
 #include <dfm-base/base/device/deviceutils.h>
 #include <dfm-base/utils/fileutils.h>
-#include <dfm-base/mimetype/dmimedatabase.h>
 
 #include <QDir>
 #include <QFileInfo>
@@ -117,86 +116,90 @@ QStringList OemMenuPrivate::getValues(const DDesktopEntry &entry, const QString
     return values;
 }
 
-bool OemMenuPrivate::isMimeTypeSupport(const QString &mt, const QStringList &fileMimeTypes) const
+int OemMenuPrivate::typeBit(const QString &type) const
 {
-    for (auto fmt : fileMimeTypes) {
-        if (fmt.contains(mt, Qt::CaseInsensitive))
-            return true;
-    }
-
-    return false;
+    const int index = menuTypes.indexOf(type);
+    return index >= 0 ? 1 << index : 0;
 }
 
-bool OemMenuPrivate::isMimeTypeMatch(const QStringList &fileMimeTypes, const QStringList &supportMimeTypes) const
+MenuActionIndex::Rule OemMenuPrivate::makeRule(const QAction *action, const QStringList &types) const
 {
-    for (auto mt : supportMimeTypes) {
-        if (fileMimeTypes.contains(mt, Qt::CaseInsensitive))
-            return true;
+    MenuActionIndex::Rule rule;
+    for (const QString &type : types)
+        rule.combos |= typeBit(type);
 
-        int index = mt.indexOf("*");
-        if (index >= 0 && isMimeTypeSupport(mt.left(index), fileMimeTypes))
-            return true;
+    // X-DFM-NotShowIn not exist
+    if (action->property(kMenuHiddenKey).isValid() || action->property(kMenuHiddenAliasKey).isValid()) {
+        QStringList notShowInList = action->property(kMenuHiddenKey).toStringList();
+        notShowInList << action->property(kMenuHiddenAliasKey).toStringList();
+        rule.showOnDesktop = !notShowInList.contains(kDesktop, Qt::CaseInsensitive);
+        rule.showInFileManager = !notShowInList.contains(kFilemanager, Qt::CaseInsensitive);
     }
 
-    return false;
-}
-
-bool OemMenuPrivate::isActionShouldShow(const QAction *action, bool onDesktop) const
-{
-    if (!action)
-        return false;
+    // X-DFM-SupportSchemes not exist
+    rule.anyScheme = !action->property(kSupportSchemesKey).isValid() && !action->property(kSupportSchemesAliasKey).isValid();
+    rule.schemes = action->property(kSupportSchemesKey).toStringList();
+    rule.schemes << action->property(kSupportSchemesAliasKey).toStringList();
 
-    // X-DFM-NotShowIn not exist
-    if (!action->property(kMenuHiddenKey).isValid() && !action->property(kMenuHiddenAliasKey).isValid())
-        return true;
+    // X-DFM-SupportSuffix not exist
+    rule.anySuffix = !action->property(kSupportSuffixKey).isValid() && !action->property(kSupportSuffixAliasKey).isValid();
+    rule.suffixes = action->property(kSupportSuffixKey).toStringList();
+    rule.suffixes << action->property(kSupportSuffixAliasKey).toStringList();
 
-    QStringList notShowInList = action->property(kMenuHiddenKey).toStringList();
-    notShowInList << action->property(kMenuHiddenAliasKey).toStringList();
+    // MimeType not exist == MimeType=*
+    rule.anyMimeType = !action->property(kMimeType).isValid();
+    rule.mimeTypes = action->property(kMimeType).toStringList();
 
-    return (onDesktop && !notShowInList.contains(kDesktop, Qt::CaseInsensitive))
-            || (!onDesktop && !notShowInList.contains(kFilemanager, Qt::CaseInsensitive));
+    rule.excludeMimeTypes = action->property(kMimeTypeExcludeKey).toStringList();
+    rule.excludeMimeTypes << action->property(kMimeTypeExcludeAliasKey).toStringList();
+    return rule;
 }
 
-bool OemMenuPrivate::isSchemeSupport(const QAction *action, const QUrl &url) const
+QBitArray OemMenuPrivate::validActions(const FileInfoPointer &fileInfo, const bool allEx7z)
 {
-    // X-DFM-SupportSchemes not exist
-    if (!action || (!action->property(kSupportSchemesKey).isValid() && !action->property(kSupportSchemesAliasKey).isValid())) {
-        return true;
+    QBitArray valid = actionIndex.actionsOfScheme(fileInfo->urlOf(UrlInfoType::kUrl).scheme());
+    if (fileInfo->isAttributes(OptInfoType::kIsDir)) {
+        // the suffix of directory is not checked, but it is not 7z.xxx
+        if (allEx7z)
+            valid.fill(false);
+    } else {
+        valid &= actionIndex.actionsOfSuffix(fileInfo->nameOf(NameInfoType::kCompleteSuffix));
+        // 7z.001,7z.002, 7z.003 ... 7z.xxx are only shown in the actions supporting them
+        if (allEx7z)
+            valid &= actionIndex.actionsWithSuffix();
     }
-
-    QStringList supportList = action->property(kSupportSchemesKey).toStringList();
-    supportList << action->property(kSupportSchemesAliasKey).toStringList();
-
-    return supportList.contains(url.scheme(), Qt::CaseInsensitive);
+    return valid;
 }
 
-bool OemMenuPrivate::isSuffixSupport(const QAction *action, FileInfoPointer fileInfo, const bool allEx7z) const
+QBitArray OemMenuPrivate::matchFile(const QUrl &file, const FileInfoPointer &fileInfo, const bool allEx7z)
 {
-    // X-DFM-SupportSuffix not exist
-    if (!fileInfo || fileInfo->isAttributes(OptInfoType::kIsDir) || !action || (!action->property(kSupportSuffixKey).isValid() && !action->property(kSupportSuffixAliasKey).isValid())) {
-        if (allEx7z) {
-            return false;
-        }
-        return true;
-    }
+    QBitArray valid = validActions(fileInfo, allEx7z);
+    if (MenuActionIndex::isEmpty(valid))
+        return valid;
 
-    QStringList supportList = action->property(kSupportSuffixKey).toStringList();
-    supportList << action->property(kSupportSuffixAliasKey).toStringList();
+    // the support mime types are matched with the parent types, the exclude ones are not
+    // e.g. xlsx parentMimeTypes is application/zip
+    const QMimeType &mt = fileInfo->fileMimeType();
+    valid &= actionIndex.actionsOfMimeType(mt);
 
-    // 7z.001,7z.002, 7z.003 ... 7z.xxx
-    QString cs = fileInfo->nameOf(NameInfoType::kCompleteSuffix);
-    if (supportList.contains(cs, Qt::CaseInsensitive)) {
-        return true;
-    }
+    //The file attributes of some MTP mounted device directories do not meet the specifications
+    //(the ordinary directory mimeType is considered octet stream), so special treatment is required
+    if (file.path().contains("/mtp:host") && actionIndex.mimeTypeAncestors(mt).contains("application/octet-stream"))
+        valid &= ~actionIndex.actionsSupportMimeType("application/octet-stream");
 
-    for (QString suffix : supportList) {
-        int endPos = suffix.lastIndexOf("*");   // 7z.*
-        if (endPos >= 0 && cs.length() > endPos && suffix.left(endPos) == cs.left(endPos)) {
-            return true;
-        }
-    }
+    // compression is not supported on FTP
+    if (!MenuActionIndex::isEmpty(valid & compressActions) && DeviceUtils::isFtp(file))
+        valid &= ~compressActions;
+
+    return valid;
+}
 
-    return false;
+QList<QAction *> OemMenuPrivate::actionsOf(const QBitArray &bits) const
+{
+    QList<QAction *> result;
+    for (int id : MenuActionIndex::ids(bits))
+        result.append(actions.at(id));
+    return result;
 }
 
 bool OemMenuPrivate::isAllEx7zFile(const QList<QUrl> &files) const
@@ -224,14 +227,6 @@ bool OemMenuPrivate::isAllEx7zFile(const QList<QUrl> &files) const
     return true;
 }
 
-bool OemMenuPrivate::isValid(const QAction *action, FileInfoPointer fileInfo, const bool onDesktop, const bool allEx7z) const
-{
-    if (!action)
-        return false;
-
-    return isActionShouldShow(action, onDesktop) && isSchemeSupport(action, fileInfo->urlOf(UrlInfoType::kUrl)) && isSuffixSupport(action, fileInfo, allEx7z);
-}
-
 void OemMenuPrivate::clearSubMenus()
 {
     for (auto menu : subMenus) {
@@ -369,21 +364,6 @@ QStringList OemMenuPrivate::urlListToString(const QList<QUrl> &files) const
     return rets;
 }
 
-void OemMenuPrivate::appendParentMineType(const QStringList &parentmimeTypes, QStringList &mimeTypes) const
-{
-    if (parentmimeTypes.isEmpty())
-        return;
-
-    DFMBASE_NAMESPACE::DMimeDatabase db;
-    for (const QString &mtName : parentmimeTypes) {
-        QMimeType mt = db.mimeTypeForName(mtName);
-        mimeTypes.append(mt.name());
-        mimeTypes.append(mt.aliases());
-        QStringList pmts = mt.parentMimeTypes();
-        appendParentMineType(pmts, mimeTypes);
-    }
-}
-
 OemMenu::OemMenu(QObject *parent)
     : QObject(parent), d(new OemMenuPrivate(this))
 {
@@ -397,7 +377,8 @@ OemMenu::~OemMenu()
 void OemMenu::loadDesktopFile()
 {
     d->menuActionHolder.reset(new QObject(this));
-    d->actionListByType.clear();
+    d->actions.clear();
+    d->actionIndex.clear();
     d->clearSubMenus();
 
     for (auto path : d->oemMenuPath) {
@@ -426,9 +407,8 @@ void OemMenu::loadDesktopFile()
                 d->setActionProperty(action, entry, propery, kDesktopEntryGroup);
             }
 
-            for (const QString &type : menuTypes) {
-                d->actionListByType[type].append(action);
-            }
+            d->actions.append(action);
+            d->actionIndex.append(d->makeRule(action, menuTypes));
 
             // sub action
             QStringList &&entryActions = entry.stringListValue(kActionsKey, kDesktopEntryGroup);
@@ -454,25 +434,24 @@ void OemMenu::loadDesktopFile()
             }
         }
     }
+
+    d->compressActions = QBitArray(d->actions.size());
+    for (int i = 0; i < d->actions.size(); ++i) {
+        if (d->actions.at(i)->text() == QObject::tr("Compress"))
+            d->compressActions.setBit(i);
+    }
 }
 
 QList<QAction *> OemMenu::emptyActions(const QUrl &currentDir, bool onDesktop)
 {
-    QList<QAction *> actions = d->actionListByType[kEmptyArea];
     auto fileInfo = InfoFactory::create<FileInfo>(currentDir);
+    if (!fileInfo)
+        return {};
 
-    auto it = actions.begin();
-    while (it != actions.end()) {
-        QAction *action = *it;
-        if (!d->isValid(action, fileInfo, onDesktop)) {
-            it = actions.erase(it);
-            continue;
-        }
-
-        ++it;
-    }
-
-    return actions;
+    QBitArray actions = d->actionIndex.actionsOfCombo(d->typeBit(kEmptyArea));
+    actions &= d->actionIndex.actionsShownOn(onDesktop);
+    actions &= d->validActions(fileInfo);
+    return d->actionsOf(actions);
 }
 
 QList<QAction *> OemMenu::normalActions(const QList<QUrl> &files, bool onDesktop)
@@ -492,11 +471,12 @@ QList<QAction *> OemMenu::normalActions(const QList<QUrl> &files, bool onDesktop
         menuType = kMultiFileDirs;
     }
 
-    QList<QAction *> actions = d->actionListByType[menuType];
-    if (actions.isEmpty())
-        return actions;
+    QBitArray actions = d->actionIndex.actionsOfCombo(d->typeBit(menuType));
+    actions &= d->actionIndex.actionsShownOn(onDesktop);
+    if (MenuActionIndex::isEmpty(actions))
+        return {};
 
-    QStringList filePaths;
+    // the actions supporting all files, the files of same type are matched once
     bool bex7z = d->isAllEx7zFile(files);
     for (const QUrl &file : files) {
 
@@ -506,80 +486,22 @@ QList<QAction *> OemMenu::normalActions(const QList<QUrl> &files, bool onDesktop
             fmWarning() << "createFileInfo failed: " << file;
             continue;
         }
-        filePaths << file.path();
-
-        QStringList fileMimeTypes, fmts;
-        fileMimeTypes.append(fileInfo->fileMimeType().name());
-        fileMimeTypes.append(fileInfo->fileMimeType().aliases());
-        const QMimeType &mt = fileInfo->fileMimeType();
-        fmts = fileMimeTypes;
-        d->appendParentMineType(mt.parentMimeTypes(), fileMimeTypes);
-        fileMimeTypes.removeAll({});
-        fmts.removeAll({});
-
-        for (auto it = actions.begin(); it != actions.end();) {
-            QAction *action = *it;
-            if (!d->isValid(action, fileInfo, onDesktop, bex7z)) {
-                it = actions.erase(it);
-                continue;
-            }
-
-            // compression is not supported on FTP
-            if (action->text() == QObject::tr("Compress") && DeviceUtils::isFtp(file)) {
-                it = actions.erase(it);
-                continue;
-            }
-
-            // match exclude mime types
-            QStringList excludeMimeTypes = action->property(kMimeTypeExcludeKey).toStringList();
-            excludeMimeTypes << action->property(kMimeTypeExcludeAliasKey).toStringList();
-
-            excludeMimeTypes.removeAll({});
-            // e.g. xlsx parentMimeTypes is application/zip
-            bool match = d->isMimeTypeMatch(fmts, excludeMimeTypes);
-            if (match) {
-                it = actions.erase(it);
-                continue;
-            }
-
-            // MimeType not exist == MimeType=*
-            if (!action->property(kMimeType).isValid()) {
-                ++it;
-                continue;
-            }
 
-            // match support mime types
-            QStringList supportMimeTypes = action->property(kMimeType).toStringList();
-            supportMimeTypes.removeAll({});
-            match = d->isMimeTypeMatch(fileMimeTypes, supportMimeTypes);
-
-            //The file attributes of some MTP mounted device directories do not meet the specifications
-            //(the ordinary directory mimeType is considered octet stream), so special treatment is required
-            if (file.path().contains("/mtp:host") && supportMimeTypes.contains("application/octet-stream") && fileMimeTypes.contains("application/octet-stream")) {
-                match = false;
-            }
-
-            if (!match) {
-                it = actions.erase(it);
-                continue;
-            }
-
-            ++it;
-        }
+        actions &= d->matchFile(file, fileInfo, bex7z);
+        if (MenuActionIndex::isEmpty(actions))
+            break;
     }
 
-    return actions;
+    return d->actionsOf(actions);
 }
 
 QList<QAction *> OemMenu::focusNormalActions(const QUrl &foucs, const QList<QUrl> &files, bool onDesktop)
 {
-    QList<QAction *> actions;
-
     QString errString;
     auto fileInfo = DFMBASE_NAMESPACE::InfoFactory::create<FileInfo>(foucs, Global::CreateFileInfoType::kCreateFileInfoAuto, &errString);
     if (!fileInfo) {
         fmWarning() << errString;
-        return actions;
+        return {};
     }
 
     QString menuType;
@@ -589,80 +511,14 @@ QList<QAction *> OemMenu::focusNormalActions(const QUrl &foucs, const QList<QUrl
         menuType = kMultiFileDirs;
 
     // get actions surported menutype
-    actions = d->actionListByType[menuType];
-    if (actions.isEmpty())
-        return actions;
-
-    // get foucs file mimetype
-    QStringList mimeTypes;
-    QStringList siblingMimeTypes;
-    {
-        // get normal mimetype
-        mimeTypes.append(fileInfo->fileMimeType().name());
-        mimeTypes.append(fileInfo->fileMimeType().aliases());
-        mimeTypes.removeAll(QString(""));
-
-        // get parent mimetype
-        const QMimeType &mt = fileInfo->fileMimeType();
-        siblingMimeTypes = mimeTypes;
-        d->appendParentMineType(mt.parentMimeTypes(), siblingMimeTypes);
-        siblingMimeTypes.removeAll(QString(""));
-    }
-
-    // check each actons
-    for (auto it = actions.begin(); it != actions.end();) {
-        QAction *action = *it;
-        // check Desktop, Scheme, Suffix
-        if (!d->isValid(action, fileInfo, onDesktop, false)) {
-            it = actions.erase(it);
-            continue;
-        }
-
-        // compression is not supported on FTP
-        if (action->text() == QObject::tr("Compress") && DeviceUtils::isFtp(foucs)) {
-            it = actions.erase(it);
-            continue;
-        }
-
-        // match exclude mime types
-        QStringList excludeMimeTypes = action->property(kMimeTypeExcludeKey).toStringList();
-        excludeMimeTypes << action->property(kMimeTypeExcludeAliasKey).toStringList();
-
-        excludeMimeTypes.removeAll({});
-        // e.g. xlsx parentMimeTypes is application/zip
-        bool match = d->isMimeTypeMatch(mimeTypes, excludeMimeTypes);
-        if (match) {
-            it = actions.erase(it);
-            continue;
-        }
-
-        // MimeType not exist == MimeType=*
-        if (!action->property(kMimeType).isValid()) {
-            ++it;
-            continue;
-        }
-
-        // match support mime types
-        QStringList supportMimeTypes = action->property(kMimeType).toStringList();
-        supportMimeTypes.removeAll({});
-        match = d->isMimeTypeMatch(siblingMimeTypes, supportMimeTypes);
-
-        //The file attributes of some MTP mounted device directories do not meet the specifications
-        //(the ordinary directory mimeType is considered octet stream), so special treatment is required
-        if (foucs.path().contains("/mtp:host") && supportMimeTypes.contains("application/octet-stream")
-                && siblingMimeTypes.contains("application/octet-stream")) {
-            match = false;
-        }
-
-        if (!match) {
-            it = actions.erase(it);
-            continue;
-        }
-
-        ++it;
-    }
-
-    return actions;
+    QBitArray actions = d->actionIndex.actionsOfCombo(d->typeBit(menuType));
+    actions &= d->actionIndex.actionsShownOn(onDesktop);
+    if (MenuActionIndex::isEmpty(actions))
+        return {};
+
+    // check Scheme, Suffix and mime types of foucs file
+    actions &= d->matchFile(foucs, fileInfo);
+    return d->actionsOf(actions);
 }
 
 QPair<QString, QStringList> OemMenu::makeCommand(const QAction *action, const QUrl &dir, const QUrl &foucs, const QList<QUrl> &files)
@@ -6,6 +6,7 @@
 #define OEMMENU_P_H
 
 #include "dfmplugin_menu_global.h"
+#include "utils/menuactionindex.h"
 
 #include <dfm-base/interfaces/fileinfo.h>
 
@@ -37,13 +38,12 @@ public:
 
     QStringList getValues(const Dtk::Core::DDesktopEntry &entry, const QString &key, const QString &aliasKey, const QString &section = "Desktop Entry", const QStringList &whiteList = {}) const;
 
-    bool isMimeTypeSupport(const QString &mt, const QStringList &fileMimeTypes) const;
-    bool isMimeTypeMatch(const QStringList &fileMimeTypes, const QStringList &supportMimeTypes) const;
-    bool isActionShouldShow(const QAction *action, bool onDesktop) const;
-    bool isSchemeSupport(const QAction *action, const QUrl &url) const;
-    bool isSuffixSupport(const QAction *action, FileInfoPointer fileInfo, const bool allEx7z = false) const;
+    int typeBit(const QString &type) const;
+    MenuActionIndex::Rule makeRule(const QAction *action, const QStringList &types) const;
+    QBitArray validActions(const FileInfoPointer &fileInfo, const bool allEx7z = false);
+    QBitArray matchFile(const QUrl &file, const FileInfoPointer &fileInfo, const bool allEx7z = false);
+    QList<QAction *> actionsOf(const QBitArray &bits) const;
     bool isAllEx7zFile(const QList<QUrl> &files) const;
-    bool isValid(const QAction *action, FileInfoPointer fileInfo, const bool onDesktop, const bool allEx7z = false) const;
 
     void clearSubMenus();
     void setActionProperty(QAction *const action, const Dtk::Core::DDesktopEntry &entry, const QString &key, const QString &section = "Desktop Entry") const;
@@ -54,12 +54,13 @@ public:
     QStringList urlListToLocalFile(const QList<QUrl> &files) const;
     QString urlToString(const QUrl &file) const;
     QStringList urlListToString(const QList<QUrl> &files) const;
-    void appendParentMineType(const QStringList &parentmimeTypes, QStringList &mimeTypes) const;
 
 public:
     QSharedPointer<QTimer> delayedLoadFileTimer;
     QSharedPointer<QObject> menuActionHolder;
-    QMap<QString, QList<QAction *>> actionListByType;
+    QList<QAction *> actions;   // the actions in the order loaded, the index of action is its id
+    MenuActionIndex actionIndex;
+    QBitArray compressActions;   // compression is not supported on FTP
     QList<QMenu *> subMenus;
 
     QStringList oemMenuPath;
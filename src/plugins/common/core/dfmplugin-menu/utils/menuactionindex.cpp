@@ -0,0 +1,265 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "menuactionindex.h"
+
+#include <dfm-base/mimetype/dmimedatabase.h>
+
+using namespace dfmplugin_menu;
+DFMBASE_USE_NAMESPACE
+
+void MenuActionIndex::clear()
+{
+    size = 0;
+    comboIndex.clear();
+    desktopHidden.clear();
+    fileManagerHidden.clear();
+    anySchemeActions.clear();
+    schemeIndex.clear();
+    anySuffixActions.clear();
+    suffixIndex.clear();
+    suffixPatterns.clear();
+    anyMimeTypeActions.clear();
+    mimeTypeIndex.clear();
+    mimeTypePatterns.clear();
+    excludeIndex.clear();
+    excludePatterns.clear();
+    exactMimeTypeIndex.clear();
+
+    schemeCache.clear();
+    suffixCache.clear();
+    mimeTypeCache.clear();
+    ancestorCache.clear();
+}
+
+int MenuActionIndex::append(const Rule &rule)
+{
+    const int id = size++;
+    // the results memorized are sized by the old count
+    schemeCache.clear();
+    suffixCache.clear();
+    mimeTypeCache.clear();
+
+    for (int bit = 0; bit < 32; ++bit) {
+        if (rule.combos & (1 << bit))
+            comboIndex[bit].append(id);
+    }
+
+    if (!rule.showOnDesktop)
+        desktopHidden.append(id);
+    if (!rule.showInFileManager)
+        fileManagerHidden.append(id);
+
+    if (rule.anyScheme) {
+        anySchemeActions.append(id);
+    } else {
+        for (const QString &scheme : rule.schemes)
+            schemeIndex[scheme.toLower()].append(id);
+    }
+
+    if (rule.anySuffix) {
+        anySuffixActions.append(id);
+    } else {
+        for (const QString &suffix : rule.suffixes) {
+            suffixIndex[suffix.toLower()].append(id);
+            // 7z.001,7z.002, 7z.003 ... 7z.xxx
+            const int endPos = suffix.lastIndexOf('*');
+            if (endPos >= 0)
+                suffixPatterns.append({ suffix.left(endPos), id });
+        }
+    }
+
+    if (rule.anyMimeType) {
+        anyMimeTypeActions.append(id);
+    } else {
+        for (const QString &mimeType : rule.mimeTypes) {
+            if (mimeType.isEmpty())
+                continue;
+            mimeTypeIndex[mimeType.toLower()].append(id);
+            exactMimeTypeIndex[mimeType].append(id);
+            const int index = mimeType.indexOf('*');
+            if (index >= 0)
+                mimeTypePatterns.append({ mimeType.left(index), id });
+        }
+    }
+
+    for (const QString &mimeType : rule.excludeMimeTypes) {
+        if (mimeType.isEmpty())
+            continue;
+        excludeIndex[mimeType.toLower()].append(id);
+        const int index = mimeType.indexOf('*');
+        if (index >= 0)
+            excludePatterns.append({ mimeType.left(index), id });
+    }
+
+    return id;
+}
+
+QBitArray MenuActionIndex::actionsOfCombo(int combos) const
+{
+    QBitArray actions(size);
+    for (auto it = comboIndex.cbegin(); it != comboIndex.cend(); ++it) {
+        if (combos & (1 << it.key()))
+            actions |= bitsOf(it.value());
+    }
+    return actions;
+}
+
+QBitArray MenuActionIndex::actionsShownOn(bool onDesktop) const
+{
+    return ~bitsOf(onDesktop ? desktopHidden : fileManagerHidden);
+}
+
+QBitArray MenuActionIndex::actionsWithSuffix() const
+{
+    return ~bitsOf(anySuffixActions);
+}
+
+QBitArray MenuActionIndex::actionsSupportMimeType(const QString &mimeType) const
+{
+    return bitsOf(exactMimeTypeIndex.value(mimeType));
+}
+
+QBitArray MenuActionIndex::actionsOfScheme(const QString &scheme)
+{
+    const QString &key = scheme.toLower();
+    auto it = schemeCache.constFind(key);
+    if (it != schemeCache.cend())
+        return it.value();
+
+    QBitArray actions = bitsOf(anySchemeActions);
+    actions |= bitsOf(schemeIndex.value(key));
+    schemeCache.insert(key, actions);
+    return actions;
+}
+
+QBitArray MenuActionIndex::actionsOfSuffix(const QString &completeSuffix)
+{
+    auto it = suffixCache.constFind(completeSuffix);
+    if (it != suffixCache.cend())
+        return it.value();
+
+    QBitArray actions = bitsOf(anySuffixActions);
+    actions |= bitsOf(suffixIndex.value(completeSuffix.toLower()));
+    for (const Pattern &pattern : suffixPatterns) {
+        if (completeSuffix.length() > pattern.part.length() && completeSuffix.startsWith(pattern.part))
+            actions.setBit(pattern.id);
+    }
+    suffixCache.insert(completeSuffix, actions);
+    return actions;
+}
+
+QBitArray MenuActionIndex::actionsOfMimeType(const QMimeType &mimeType)
+{
+    const QString &name = mimeType.name();
+    auto it = mimeTypeCache.constFind(name);
+    if (it != mimeTypeCache.cend())
+        return it.value();
+
+    QStringList types { name };
+    types.append(mimeType.aliases());
+    types.removeAll({});
+    const QStringList &allTypes = mimeTypeAncestors(mimeType);
+
+    // the supported types are matched with the parent types, e.g. xlsx parentMimeTypes is application/zip
+    QBitArray actions = bitsOf(anyMimeTypeActions);
+    for (const QString &type : allTypes)
+        actions |= bitsOf(mimeTypeIndex.value(type.toLower()));
+    for (const Pattern &pattern : mimeTypePatterns) {
+        if (!actions.testBit(pattern.id) && containsPart(allTypes, pattern.part))
+            actions.setBit(pattern.id);
+    }
+
+    // but the excluded types are not
+    QBitArray excluded(size);
+    for (const QString &type : types)
+        excluded |= bitsOf(excludeIndex.value(type.toLower()));
+    for (const Pattern &pattern : excludePatterns) {
+        if (!excluded.testBit(pattern.id) && containsPart(types, pattern.part))
+            excluded.setBit(pattern.id);
+    }
+
+    actions &= ~excluded;
+    mimeTypeCache.insert(name, actions);
+    return actions;
+}
+
+QBitArray MenuActionIndex::actionsOfFile(const FileInfoPointer &fileInfo)
+{
+    if (!fileInfo)
+        return QBitArray(size);
+
+    QBitArray actions = actionsOfScheme(fileInfo->urlOf(UrlInfoType::kUrl).scheme());
+    if (!fileInfo->isAttributes(OptInfoType::kIsDir))
+        actions &= actionsOfSuffix(fileInfo->nameOf(NameInfoType::kCompleteSuffix));
+    if (isEmpty(actions))
+        return actions;
+
+    actions &= actionsOfMimeType(fileInfo->fileMimeType());
+    return actions;
+}
+
+QStringList MenuActionIndex::mimeTypeAncestors(const QMimeType &mimeType)
+{
+    const QString &name = mimeType.name();
+    auto it = ancestorCache.constFind(name);
+    if (it != ancestorCache.cend())
+        return it.value();
+
+    const QStringList &types = collectAncestors(mimeType);
+    ancestorCache.insert(name, types);
+    return types;
+}
+
+QList<int> MenuActionIndex::ids(const QBitArray &actions)
+{
+    QList<int> result;
+    for (int i = 0; i < actions.size(); ++i) {
+        if (actions.testBit(i))
+            result.append(i);
+    }
+    return result;
+}
+
+QBitArray MenuActionIndex::bitsOf(const QVector<int> &ids) const
+{
+    QBitArray actions(size);
+    for (int id : ids)
+        actions.setBit(id);
+    return actions;
+}
+
+QStringList MenuActionIndex::ancestorsOf(const QString &name)
+{
+    auto it = ancestorCache.constFind(name);
+    if (it != ancestorCache.cend())
+        return it.value();
+
+    // the hierarchy has no cycle, the placeholder stops a broken one
+    ancestorCache.insert(name, { name });
+    DMimeDatabase db;
+    const QStringList &types = collectAncestors(db.mimeTypeForName(name));
+    ancestorCache.insert(name, types);
+    return types;
+}
+
+QStringList MenuActionIndex::collectAncestors(const QMimeType &mimeType)
+{
+    QStringList types { mimeType.name() };
+    types.append(mimeType.aliases());
+    for (const QString &parent : mimeType.parentMimeTypes())
+        types.append(ancestorsOf(parent));
+    types.removeAll({});
+    types.removeDuplicates();
+    return types;
+}
+
+bool MenuActionIndex::containsPart(const QStringList &mimeTypes, const QString &part)
+{
+    for (const QString &type : mimeTypes) {
+        if (type.contains(part, Qt::CaseInsensitive))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef MENUACTIONINDEX_H
+#define MENUACTIONINDEX_H
+
+#include "dfmplugin_menu_global.h"
+
+#include <dfm-base/interfaces/fileinfo.h>
+
+#include <QHash>
+#include <QVector>
+#include <QBitArray>
+#include <QMimeType>
+#include <QStringList>
+
+namespace dfmplugin_menu {
+
+/*!
+ * \brief The MenuActionIndex class matches the actions of OEM and custom menus with the selected files.
+ * It is built once when the configs are loaded, the actions are given by ids in the order appended.
+ * The mime types, suffixes and schemes supported are kept as inverted indexes to the ids, and the
+ * result of a mime type (with its ancestors), suffix or scheme is memorized, so the actions of a
+ * selection are the intersection of the results of its files, and each distinct type is matched once.
+ * The results are bit arrays with a bit for each action.
+ */
+class MenuActionIndex
+{
+public:
+    struct Rule
+    {
+        int combos { 0 };   // the bits of menu types or file combos supported
+        bool showOnDesktop { true };
+        bool showInFileManager { true };
+        bool anyScheme { true };
+        QStringList schemes;
+        bool anySuffix { true };
+        QStringList suffixes;   // the complete suffixes, "7z.*" matches "7z.001"
+        bool anyMimeType { true };
+        QStringList mimeTypes;   // matched with the parent types, "image/*" matches the types containing "image/"
+        QStringList excludeMimeTypes;   // matched without the parent types
+    };
+
+    void clear();
+    // return the id of action
+    int append(const Rule &rule);
+    inline int count() const { return size; }
+
+    QBitArray actionsOfCombo(int combos) const;
+    QBitArray actionsShownOn(bool onDesktop) const;
+    // the actions supporting the given suffixes only
+    QBitArray actionsWithSuffix() const;
+    // the actions listing \a mimeType in the supported mime types
+    QBitArray actionsSupportMimeType(const QString &mimeType) const;
+
+    QBitArray actionsOfScheme(const QString &scheme);
+    QBitArray actionsOfSuffix(const QString &completeSuffix);
+    QBitArray actionsOfMimeType(const QMimeType &mimeType);
+    // the scheme, suffix (not for directory) and mime type of file are matched
+    QBitArray actionsOfFile(const FileInfoPointer &fileInfo);
+
+    // the names and aliases of mime type and all its parents
+    QStringList mimeTypeAncestors(const QMimeType &mimeType);
+
+    static QList<int> ids(const QBitArray &actions);
+    static inline bool isEmpty(const QBitArray &actions) { return actions.count(true) == 0; }
+
+private:
+    struct Pattern
+    {
+        QString part;   // the part before '*'
+        int id { 0 };
+    };
+
+    QBitArray bitsOf(const QVector<int> &ids) const;
+    QStringList ancestorsOf(const QString &name);
+    QStringList collectAncestors(const QMimeType &mimeType);
+    static bool containsPart(const QStringList &mimeTypes, const QString &part);
+
+private:
+    int size { 0 };
+    QHash<int, QVector<int>> comboIndex;   // the bit of combo to actions
+    QVector<int> desktopHidden;
+    QVector<int> fileManagerHidden;
+
+    QVector<int> anySchemeActions;
+    QHash<QString, QVector<int>> schemeIndex;   // in lower case
+    QVector<int> anySuffixActions;
+    QHash<QString, QVector<int>> suffixIndex;   // in lower case
+    QVector<Pattern> suffixPatterns;
+    QVector<int> anyMimeTypeActions;
+    QHash<QString, QVector<int>> mimeTypeIndex;   // in lower case
+    QVector<Pattern> mimeTypePatterns;
+    QHash<QString, QVector<int>> excludeIndex;   // in lower case
+    QVector<Pattern> excludePatterns;
+    QHash<QString, QVector<int>> exactMimeTypeIndex;
+
+    // the memorized results, cleared when the actions are changed
+    QHash<QString, QBitArray> schemeCache;
+    QHash<QString, QBitArray> suffixCache;
+    QHash<QString, QBitArray> mimeTypeCache;
+    QHash<QString, QStringList> ancestorCache;
+};
+
+}
+
+#endif   // MENUACTIONINDEX_H
@@ -12,6 +12,7 @@
 #include <dfm-framework/event/event.h>
 #include <dfm-io/dfileinfo.h>
 
+#include <QDateTime>
 #include <QDebug>
 #include <QStandardPaths>
 
@@ -20,23 +21,74 @@ DFMBASE_USE_NAMESPACE
 DPF_USE_NAMESPACE
 DPEMBLEM_USE_NAMESPACE
 
+namespace {
+// the metadata of gvfs does not change mtime, so the record is rechecked after a while.
+constexpr qint64 kRecheckInterval { 3000 };
+}
+
 void GioEmblemWorker::onProduce(const FileInfoPointer &info)
 {
     Q_ASSERT(qApp->thread() != QThread::currentThread());
 
-    const auto &emblems { fetchEmblems(info) };
+    Product emblems;
+    if (produce(info, &emblems))
+        emit emblemChanged(info->urlOf(UrlInfoType::kUrl), emblems);
+}
+
+/*!
+ * \brief resolve the emblems of a batch of files, which are usually all the files visible in a view,
+ * and report the changed ones in one signal. The batch is abandoned if a newer generation is started.
+ */
+void GioEmblemWorker::onProduceBatch(const PendingBatch &infos, int batchGeneration)
+{
+    Q_ASSERT(qApp->thread() != QThread::currentThread());
+
+    ProductQueue changed;
+    for (const FileInfoPointer &info : infos) {
+        // superseded, the results belong to an old directory.
+        if (batchGeneration != currentGeneration())
+            return;
+
+        Product emblems;
+        if (produce(info, &emblems))
+            changed.insert(info->urlOf(UrlInfoType::kUrl), emblems);
+    }
+
+    if (!changed.isEmpty())
+        emit emblemsChanged(changed);
+}
+
+bool GioEmblemWorker::produce(const FileInfoPointer &info, Product *changed)
+{
+    if (!info)
+        return false;
 
     const QUrl &url = info->urlOf(UrlInfoType::kUrl);
-    if (cache.contains(url)) {
-        const auto &old { cache.value(url) };
-        if (!iconNamesEqual(old, emblems)) {
-            cache[url] = emblems;
-            emit emblemChanged(url, emblems);
-        }
-    } else {   // save to cache
-        cache.insert(url, emblems);
-        emit emblemChanged(url, emblems);
+    const QVariant &inode = info->extendAttributes(ExtInfoType::kInode);
+    const qint64 lastModified = info->timeOf(TimeInfoType::kLastModifiedMSecond).toLongLong();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    auto itor = cache.find(url);
+    if (itor != cache.end() && itor->inode == inode && itor->lastModified == lastModified
+        && now - itor->checkedTime < kRecheckInterval)
+        return false;
+
+    const auto &emblems { fetchEmblems(info) };
+    if (itor == cache.end()) {   // save to cache
+        itor = cache.insert(url, Record());
+    } else if (iconNamesEqual(itor->product, emblems)) {
+        itor->inode = inode;
+        itor->lastModified = lastModified;
+        itor->checkedTime = now;
+        return false;
     }
+
+    itor->product = emblems;
+    itor->inode = inode;
+    itor->lastModified = lastModified;
+    itor->checkedTime = now;
+    *changed = emblems;
+    return true;
 }
 
 void GioEmblemWorker::onClear()
@@ -263,7 +315,18 @@ QList<QIcon> EmblemHelper::gioEmblemIcons(const QUrl &url) const
 
 void EmblemHelper::pending(const FileInfoPointer &info)
 {
-    emit requestProduce(info);
+    if (!info)
+        return;
+
+    // the files painted in one pass are collected and resolved together.
+    const QUrl &url = info->urlOf(UrlInfoType::kUrl);
+    if (!pendingInfos.contains(url)) {
+        pendingInfos.insert(url, info);
+        pendingOrder.append(info);
+    }
+
+    if (!flushTimer.isActive())
+        flushTimer.start();
 }
 
 bool EmblemHelper::isExtEmblemProhibited(const QUrl &url)
@@ -290,6 +353,32 @@ void EmblemHelper::onEmblemChanged(const QUrl &url, const Product &product)
     productQueue[url] = product;
     if (product.isEmpty())
         return;
+
+    notifyUpdated(url);
+}
+
+void EmblemHelper::onEmblemsChanged(const ProductQueue &products)
+{
+    for (auto it = products.begin(); it != products.end(); ++it) {
+        productQueue[it.key()] = it.value();
+        if (!it.value().isEmpty())
+            notifyUpdated(it.key());
+    }
+}
+
+void EmblemHelper::flushPending()
+{
+    if (pendingOrder.isEmpty())
+        return;
+
+    PendingBatch batch;
+    batch.swap(pendingOrder);
+    pendingInfos.clear();
+    emit requestProduceBatch(batch, worker->currentGeneration());
+}
+
+void EmblemHelper::notifyUpdated(const QUrl &url)
+{
     auto eventID { DPF_NAMESPACE::Event::instance()->eventType("ddplugin_canvas", "slot_FileInfoModel_UpdateFile") };
     if (eventID != DPF_NAMESPACE::EventTypeScope::kInValid)
         dpfSlotChannel->push("ddplugin_canvas", "slot_FileInfoModel_UpdateFile", url);
@@ -303,6 +392,10 @@ bool EmblemHelper::onUrlChanged(quint64 windowId, const QUrl &url)
     Q_UNUSED(url);
 
     clearEmblem();
+    pendingInfos.clear();
+    pendingOrder.clear();
+    // abandon the batches of previous directory which are not finished.
+    worker->cancelBatches();
     emit requestClear();
 
     return false;
@@ -313,11 +406,20 @@ void EmblemHelper::initialize()
     Q_ASSERT(qApp->thread() == QThread::currentThread());
     dpfSignalDispatcher->installEventFilter(GlobalEventType::kChangeCurrentUrl, this, &EmblemHelper::onUrlChanged);
 
+    qRegisterMetaType<PendingBatch>();
+    qRegisterMetaType<ProductQueue>();
+
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(0);
+    connect(&flushTimer, &QTimer::timeout, this, &EmblemHelper::flushPending);
+
     worker->moveToThread(&workerThread);
     connect(&workerThread, &QThread::finished, worker, &QObject::deleteLater);
     connect(this, &EmblemHelper::requestProduce, worker, &GioEmblemWorker::onProduce, Qt::QueuedConnection);
+    connect(this, &EmblemHelper::requestProduceBatch, worker, &GioEmblemWorker::onProduceBatch, Qt::QueuedConnection);
     connect(this, &EmblemHelper::requestClear, worker, &GioEmblemWorker::onClear, Qt::QueuedConnection);
     connect(worker, &GioEmblemWorker::emblemChanged, this, &EmblemHelper::onEmblemChanged, Qt::QueuedConnection);
+    connect(worker, &GioEmblemWorker::emblemsChanged, this, &EmblemHelper::onEmblemsChanged, Qt::QueuedConnection);
 
     workerThread.start();
 }
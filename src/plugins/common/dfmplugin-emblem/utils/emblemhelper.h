@@ -13,10 +13,12 @@
 
 #include <QIcon>
 #include <QThread>
+#include <QTimer>
 
 DPEMBLEM_BEGIN_NAMESPACE
 using Product = QList<QIcon>;   // for a url
 using ProductQueue = QHash<QUrl, Product>;
+using PendingBatch = QList<FileInfoPointer>;
 
 class GioEmblemWorker : public QObject
 {
@@ -25,21 +27,37 @@ class GioEmblemWorker : public QObject
 public:
     QList<QIcon> fetchEmblems(const FileInfoPointer &info) const;
 
+    // thread safe, the batches submitted before calling it are abandoned.
+    inline int cancelBatches() { return generation.fetchAndAddOrdered(1) + 1; }
+    inline int currentGeneration() const { return generation.loadAcquire(); }
+
 public Q_SLOTS:
     void onProduce(const FileInfoPointer &info);
+    void onProduceBatch(const PendingBatch &infos, int batchGeneration);
     void onClear();
 
 Q_SIGNALS:
     void emblemChanged(const QUrl &url, const Product &product);
+    void emblemsChanged(const ProductQueue &products);
 
 private:
+    struct Record
+    {
+        Product product;
+        QVariant inode;
+        qint64 lastModified { -1 };
+        qint64 checkedTime { 0 };
+    };
+
+    bool produce(const FileInfoPointer &info, Product *changed);
     QMap<int, QIcon> getGioEmblems(const FileInfoPointer &info) const;
     bool parseEmblemString(QIcon *emblem, QString &pos, const QString &emblemStr) const;
     bool iconNamesEqual(const QList<QIcon> &first, const QList<QIcon> &second);
     void setEmblemIntoIcons(const QString &pos, const QIcon &emblem, QMap<int, QIcon> *iconMap) const;
 
 private:
-    ProductQueue cache;
+    QHash<QUrl, Record> cache;
+    QAtomicInt generation { 0 };
 };
 
 class EmblemHelper : public QObject
@@ -61,19 +79,27 @@ public:
 
 Q_SIGNALS:
     void requestProduce(const FileInfoPointer &info);
+    void requestProduceBatch(const PendingBatch &infos, int batchGeneration);
     void requestClear();
 
 private Q_SLOTS:
     void onEmblemChanged(const QUrl &url, const Product &product);
+    void onEmblemsChanged(const ProductQueue &products);
+    void flushPending();
     bool onUrlChanged(quint64 windowId, const QUrl &url);
 
 private:
     void initialize();
     QIcon standardEmblem(const SystemEmblemType type) const;
+    void notifyUpdated(const QUrl &url);
 
 private:
     GioEmblemWorker *worker { new GioEmblemWorker };
     ProductQueue productQueue;
+    // the files painted in current event loop, they are sent to worker as one batch.
+    QHash<QUrl, FileInfoPointer> pendingInfos;
+    PendingBatch pendingOrder;
+    QTimer flushTimer;
     QThread workerThread;
 };
 
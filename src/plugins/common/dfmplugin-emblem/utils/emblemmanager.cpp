@@ -8,8 +8,10 @@
 #include "events/emblemeventsequence.h"
 
 #include <dfm-base/base/schemefactory.h>
+#include <dfm-base/utils/iconpixmapcache.h>
 
 #include <QPainter>
+#include <QStyle>
 
 DFMBASE_USE_NAMESPACE
 DFMGLOBAL_USE_NAMESPACE
@@ -58,10 +60,21 @@ bool EmblemManager::paintEmblems(int role, const FileInfoPointer &info, QPainter
         return false;
 
     const QList<QRectF> &paintRects = helper->emblemRects(*paintArea);
+    // QIcon::pixmap renders in the pixel ratio of application.
+    const qreal pixelRatio = qApp->devicePixelRatio();
     for (int i = 0; i < qMin(paintRects.count(), emblems.count()); ++i) {
         if (emblems.at(i).isNull())
             continue;
-        emblems.at(i).paint(painter, paintRects.at(i).toRect());
+
+        // the emblems are the same for many files, draw them from the cache.
+        const QRect &rect = paintRects.at(i).toRect();
+        const QPixmap &px = IconPixmapCache::instance().pixmap(emblems.at(i), rect.size(), pixelRatio);
+        if (px.isNull())
+            continue;
+
+        // centered in rect as QIcon::paint does.
+        const QSize &pxSize = (QSizeF(px.size()) / px.devicePixelRatio()).toSize();
+        painter->drawPixmap(QStyle::alignedRect(painter->layoutDirection(), Qt::AlignCenter, pxSize, rect), px);
     }
 
     return true;
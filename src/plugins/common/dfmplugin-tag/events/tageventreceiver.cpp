@@ -35,16 +35,22 @@ void TagEventReceiver::handleFileCutResult(const QList<QUrl> &srcUrls, const QLi
     if (!ok || destUrls.isEmpty())
         return;
 
-    for (const QUrl &url : srcUrls) {
-        const auto &tags = TagManager::instance()->getTagsByUrls({ url });
-        if (tags.isEmpty())
+    QMap<QUrl, QUrl> movedUrls;
+    for (int i = 0; i < srcUrls.size() && i < destUrls.size(); ++i) {
+        const QUrl &url = srcUrls.at(i);
+        const QUrl &newUrl = destUrls.at(i);
+        if (TagManager::instance()->canTagFile(newUrl)) {
+            movedUrls.insert(url, newUrl);
             continue;
+        }
 
-        TagManager::instance()->removeTagsOfFiles(tags, { url });
-        const QUrl &newUrl = destUrls.at(srcUrls.indexOf(url));
-        if (TagManager::instance()->canTagFile(newUrl))
-            TagManager::instance()->addTagsForFiles(tags, { newUrl });
+        const auto &tags = TagManager::instance()->getTagsByUrls({ url });
+        if (!tags.isEmpty())
+            TagManager::instance()->removeTagsOfFiles(tags, { url });
     }
+
+    if (!movedUrls.isEmpty())
+        TagManager::instance()->changeFilePaths(movedUrls);
 }
 
 void TagEventReceiver::handleHideFilesResult(const quint64 &winId, const QList<QUrl> &urls, bool ok)
@@ -85,15 +91,7 @@ void TagEventReceiver::handleFileRenameResult(quint64 winId, const QMap<QUrl, QU
     if (!ok || renamedUrls.isEmpty())
         return;
 
-    auto iter = renamedUrls.constBegin();
-    for (; iter != renamedUrls.constEnd(); ++iter) {
-        const auto &tags = TagManager::instance()->getTagsByUrls({ iter.key() });
-        if (tags.isEmpty())
-            continue;
-
-        TagManager::instance()->removeTagsOfFiles(tags, { iter.key() });
-        TagManager::instance()->addTagsForFiles(tags, { iter.value() });
-    }
+    TagManager::instance()->changeFilePaths(renamedUrls);
 }
 
 void TagEventReceiver::handleWindowUrlChanged(quint64 winId, const QUrl &url)
@@ -465,6 +465,19 @@ bool TagManager::changeTagName(const QString &tagName, const QString &newName)
     return TagProxyHandleIns->changeTagNamesWithFiles(oldAndNewName);
 }
 
+bool TagManager::changeFilePaths(const QMap<QUrl, QUrl> &oldAndNewUrls)
+{
+    if (oldAndNewUrls.isEmpty())
+        return false;
+
+    // the tag daemon moves the tags of the descendants too
+    QVariantMap oldAndNewPaths;
+    for (auto it = oldAndNewUrls.cbegin(); it != oldAndNewUrls.cend(); ++it)
+        oldAndNewPaths.insert(UrlRoute::urlToPath(it.key()), UrlRoute::urlToPath(it.value()));
+
+    return TagProxyHandleIns->changeFilePaths(oldAndNewPaths);
+}
+
 QMap<QString, QString> TagManager::getTagsColorName(const QStringList &tags) const
 {
     if (tags.isEmpty())
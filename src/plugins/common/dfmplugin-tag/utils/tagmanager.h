@@ -61,6 +61,7 @@ public:
     void deleteFiles(const QList<QUrl> &urls);
     bool changeTagColor(const QString &tagName, const QString &newTagColor);
     bool changeTagName(const QString &tagName, const QString &newName);
+    bool changeFilePaths(const QMap<QUrl, QUrl> &oldAndNewUrls);
 
     static void contenxtMenuHandle(quint64 windowId, const QUrl &url, const QPoint &globalPos);
     static void renameHandle(quint64 windowId, const QUrl &url, const QString &name);
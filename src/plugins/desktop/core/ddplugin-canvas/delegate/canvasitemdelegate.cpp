@@ -14,6 +14,7 @@
 #include <dfm-base/base/device/deviceutils.h>
 #include <dfm-base/utils/clipboard.h>
 #include <dfm-base/utils/fileutils.h>
+#include <dfm-base/utils/iconpixmapcache.h>
 #include <dfm-base/dfm_event_defines.h>
 
 #include <dfm-framework/dpf.h>
@@ -512,10 +513,7 @@ QPixmap CanvasItemDelegate::getIconPixmap(const QIcon &icon, const QSize &size,
         return QPixmap();
 
     // the QIcon::pixmap does size * pixelRatio.
-    auto px = icon.pixmap(size, mode, state);
-    px.setDevicePixelRatio(pixelRatio);
-
-    return px;
+    return IconPixmapCache::instance().pixmap(icon, size, pixelRatio, mode, state);
 }
 
 CanvasView *CanvasItemDelegate::parent() const
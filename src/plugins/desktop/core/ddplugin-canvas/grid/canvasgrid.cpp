@@ -331,6 +331,7 @@ void CanvasGridPrivate::clean()
     posItem.clear();
     itemPos.clear();
     overload.clear();
+    invalidateOccupancy();
 }
 
 void CanvasGridPrivate::sequence(QStringList sortedItems)
@@ -356,6 +357,7 @@ void CanvasGridPrivate::sequence(QStringList sortedItems)
 
         itemPos.insert(idx, allItem);
         posItem.insert(idx, allPos);
+        invalidateOccupancy(idx);
     }
     fmDebug() << "overload items " << sortedItems.size();
     overload = sortedItems;
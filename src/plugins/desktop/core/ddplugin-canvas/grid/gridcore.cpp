@@ -4,10 +4,11 @@
 
 #include "gridcore.h"
 
+#include <QtAlgorithms>
+
 uint qHash(const QPoint &key, uint seed)
 {
-    QString val = QString("%1x%2").arg(key.x()).arg(key.y());
-    return qHash<QString>(val, seed);
+    return qHash(qMakePair(key.x(), key.y()), seed);
 }
 
 using namespace ddplugin_canvas;
@@ -22,6 +23,7 @@ GridCore::GridCore(const GridCore &other)
     , posItem(other.posItem)
     , itemPos(other.itemPos)
     , overload(other.overload)
+    , occupancies(other.occupancies)
 {
 }
 
@@ -48,38 +50,52 @@ bool GridCore::applay(GridCore *core)
     posItem = core->posItem;
     itemPos = core->itemPos;
     overload = core->overload;
+    occupancies = core->occupancies;
     return true;
 }
 
 void GridCore::insert(int index, const QPoint &pos, const QString &it)
 {
     itemPos[index].insert(it, pos);
-    posItem[index].insert(pos, it);
+
+    auto &used = posItem[index];
+    const bool wasVoid = !used.contains(pos);
+    used.insert(pos, it);
+    if (wasVoid)
+        setOccupied(index, pos, true);
 }
 
 void GridCore::remove(int index, const QString &it)
 {
-    auto pos = itemPos[index].take(it);
-    posItem[index].remove(pos);
+    auto &items = itemPos[index];
+    auto itor = items.find(it);
+    if (itor == items.end())
+        return;
+
+    const QPoint pos = itor.value();
+    items.erase(itor);
+    if (posItem[index].remove(pos) > 0)
+        setOccupied(index, pos, false);
 }
 
 void GridCore::remove(int index, const QPoint &pos)
 {
-    QString it = posItem[index].take(pos);
+    auto &used = posItem[index];
+    auto itor = used.find(pos);
+    if (itor == used.end())
+        return;
+
+    const QString it = itor.value();
+    used.erase(itor);
     itemPos[index].remove(it);
+    setOccupied(index, pos, false);
 }
 
 QList<QPoint> GridCore::voidPos(int index) const
 {
     QList<QPoint> ret;
-    const QSize &size = surfaces.value(index, QSize(0, 0));
-    const QHash<QPoint, QString> &usedPos = posItem.value(index);
-    for (int x = 0; x < size.width(); ++x)
-        for (int y = 0; y < size.height(); ++y) {
-            QPoint pos(x, y);
-            if (!usedPos.contains(pos))
-                ret.append(pos);
-        }
+    for (int cell = nextVoidCell(index, 0); cell >= 0; cell = nextVoidCell(index, cell + 1))
+        ret.append(cellPos(index, cell));
 
     return ret;
 }
@@ -87,28 +103,101 @@ QList<QPoint> GridCore::voidPos(int index) const
 bool GridCore::findVoidPos(GridPos &pos) const
 {
     for (int idx : surfaceIndex()) {
-        const QHash<QPoint, QString> &usedPos = posItem.value(idx);
-        const QSize &size = surfaces.value(idx);
-
         // no void pos
         if (isFull(idx))
             continue;
 
         // find first void pos.
-        for (int x = 0; x < size.width(); ++x)
-            for (int y = 0; y < size.height(); ++y) {
-                QPoint curPos(x, y);
-                if (!usedPos.contains(curPos)) {
-                    pos.first = idx;
-                    pos.second = curPos;
-                    return true;
-                }
-            }
+        int cell = nextVoidCell(idx, 0);
+        if (cell >= 0) {
+            pos.first = idx;
+            pos.second = cellPos(idx, cell);
+            return true;
+        }
     }
 
     return false;
 }
 
+/*!
+ * \brief return the first void cell of surface \a index whose cell index is not less than \a from,
+ * or -1 if there is no one. It scans the occupancy bitmap a word at a time.
+ */
+int GridCore::nextVoidCell(int index, int from) const
+{
+    const Occupancy &occ = occupancy(index);
+    const int cells = occ.size.width() * occ.size.height();
+    if (from < 0)
+        from = 0;
+    if (from >= cells)
+        return -1;
+
+    int word = from / 64;
+    quint64 free = ~occ.bits.at(word) & (~quint64(0) << (from % 64));
+    const int words = occ.bits.size();
+    while (free == 0) {
+        if (++word >= words)
+            return -1;
+        free = ~occ.bits.at(word);
+    }
+
+    const int cell = word * 64 + static_cast<int>(qCountTrailingZeroBits(free));
+    return cell < cells ? cell : -1;
+}
+
+void GridCore::invalidateOccupancy(int index)
+{
+    if (index < 0)
+        occupancies.clear();
+    else
+        occupancies.remove(index);
+}
+
+const GridCore::Occupancy &GridCore::occupancy(int index) const
+{
+    const QSize size = surfaceSize(index);
+    const QHash<QPoint, QString> &used = posItem.value(index);
+
+    Occupancy &occ = occupancies[index];
+    if (occ.size == size && occ.count == used.size() && !occ.bits.isEmpty())
+        return occ;
+
+    // rebuild from posItem.
+    const int cells = qMax(0, size.width() * size.height());
+    occ.size = size;
+    occ.count = used.size();
+    occ.bits.fill(0, qMax(1, (cells + 63) / 64));
+    for (auto itor = used.begin(); itor != used.end(); ++itor) {
+        if (!CanvasGridSpecialist::isValid(itor.key(), size))
+            continue;
+        const int cell = itor.key().x() * size.height() + itor.key().y();
+        occ.bits[cell / 64] |= quint64(1) << (cell % 64);
+    }
+
+    return occ;
+}
+
+void GridCore::setOccupied(int index, const QPoint &pos, bool used)
+{
+    auto itor = occupancies.find(index);
+    if (itor == occupancies.end())
+        return;
+
+    // it will be rebuilt on next query.
+    if (itor->size != surfaceSize(index) || !isValid(index, pos)) {
+        occupancies.erase(itor);
+        return;
+    }
+
+    const int cell = cellIndex(index, pos);
+    const quint64 mask = quint64(1) << (cell % 64);
+    if (used)
+        itor->bits[cell / 64] |= mask;
+    else
+        itor->bits[cell / 64] &= ~mask;
+    itor->count += used ? 1 : -1;
+}
+
 bool GridCore::isFull(int index) const
 {
     const QSize &size = surfaces.value(index, QSize(0, 0));
@@ -147,7 +236,8 @@ void GridCore::removeAll(const QStringList &items)
             if (!itemPos[index].contains(it))
                 continue;
             auto pos = itemPos[index].take(it);
-            posItem[index].remove(pos);
+            if (posItem[index].remove(pos) > 0)
+                setOccupied(index, pos, false);
         }
     }
 }
@@ -250,16 +340,25 @@ QStringList AppendOper::appendAfter(QStringList items, int index, const QPoint &
     if (items.isEmpty())
         return items;
 
-    QList<QPoint> posList = voidPos(index);
-    for (const QPoint &pos : posList) {
-        if ((pos.x() > begin.x()) || (pos.x() == begin.x() && pos.y() >= begin.y())) {
-            // all items is appenped
-            if (items.isEmpty())
-                return items;
+    // the first cell that is after \a begin.
+    const int height = surfaceSize(index).height();
+    int from = 0;
+    if (begin.x() >= 0 && height > 0) {
+        if (begin.y() < 0)
+            from = begin.x() * height;
+        else if (begin.y() < height)
+            from = begin.x() * height + begin.y();
+        else
+            from = (begin.x() + 1) * height;
+    }
 
-            QString &&item = items.takeFirst();
-            insert(index, pos, item);
-        }
+    for (int cell = nextVoidCell(index, from); cell >= 0; cell = nextVoidCell(index, cell + 1)) {
+        // all items is appenped
+        if (items.isEmpty())
+            return items;
+
+        QString &&item = items.takeFirst();
+        insert(index, cellPos(index, cell), item);
     }
 
     return items;
@@ -268,14 +367,13 @@ QStringList AppendOper::appendAfter(QStringList items, int index, const QPoint &
 void AppendOper::append(QStringList items)
 {
     for (int idx : surfaceIndex()) {
-        auto posList = voidPos(idx);
-        for (const QPoint &pos : posList) {
+        for (int cell = nextVoidCell(idx, 0); cell >= 0; cell = nextVoidCell(idx, cell + 1)) {
             // all items is appenped
             if (items.isEmpty())
                 return;
 
             QString &&it = items.takeFirst();
-            insert(idx, pos, it);
+            insert(idx, cellPos(idx, cell), it);
         }
     }
 
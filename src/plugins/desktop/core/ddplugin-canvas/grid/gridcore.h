@@ -9,6 +9,7 @@
 
 #include <QMap>
 #include <QSize>
+#include <QVector>
 
 extern uint qHash(const QPoint &key, uint seed);
 
@@ -34,6 +35,8 @@ public:
     virtual bool position(const QString &item, GridPos &pos) const;
     virtual QString item(const GridPos &pos) const;
     virtual void removeAll(const QStringList &items);
+    int nextVoidCell(int index, int from) const;
+    void invalidateOccupancy(int index = -1);
 public:
     inline QSize surfaceSize(int index) const {
         return surfaces.value(index, QSize(0, 0));
@@ -50,11 +53,33 @@ public:
     inline void pushOverload(const QStringList &items){
         overload.append(items);
     }
+
+    // cells are numbered column by column, the same order used to fill the grid.
+    inline int cellIndex(int index, const QPoint &pos) const {
+        return pos.x() * surfaceSize(index).height() + pos.y();
+    }
+
+    inline QPoint cellPos(int index, int cell) const {
+        const int height = surfaceSize(index).height();
+        return QPoint(cell / height, cell % height);
+    }
+protected:
+    // bitmap of the used cells of a surface, it is a cache of posItem.
+    struct Occupancy
+    {
+        QSize size;
+        int count = 0;   // the size of posItem when it is in sync.
+        QVector<quint64> bits;
+    };
+    const Occupancy &occupancy(int index) const;
+    void setOccupied(int index, const QPoint &pos, bool used);
 public:
     QMap<int, QSize> surfaces;
     QMap<int, QHash<QPoint, QString>> posItem;
     QMap<int, QHash<QString, QPoint>> itemPos;
     QStringList overload;
+protected:
+    mutable QMap<int, Occupancy> occupancies;
 };
 
 class MoveGridOper : public GridCore
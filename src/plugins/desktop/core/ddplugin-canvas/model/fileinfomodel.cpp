@@ -18,12 +18,18 @@
 #include <QMimeData>
 #include <QDateTime>
 
+#include <algorithm>
+#include <functional>
+
 DFMBASE_USE_NAMESPACE
 using namespace ddplugin_canvas;
 
 FileInfoModelPrivate::FileInfoModelPrivate(FileInfoModel *qq)
     : QObject(qq), q(qq)
 {
+    pendingTimer.setSingleShot(true);
+    pendingTimer.setInterval(0);
+    connect(&pendingTimer, &QTimer::timeout, this, &FileInfoModelPrivate::flushPending);
 }
 
 void FileInfoModelPrivate::doRefresh()
@@ -49,6 +55,132 @@ QIcon FileInfoModelPrivate::fileIcon(FileInfoPointer info)
     return info->fileIcon();
 }
 
+int FileInfoModelPrivate::rowOf(const QUrl &url) const
+{
+    auto itor = rowIndex.constFind(url);
+    if (itor != rowIndex.constEnd()) {
+        const int row = itor.value();
+        if (row < fileList.count() && fileList.at(row) == url)
+            return row;
+    } else if (!fileMap.contains(url)) {
+        return -1;
+    }
+
+    // the rows are shifted by removing, rebuild it.
+    rebuildRowIndex();
+    return rowIndex.value(url, -1);
+}
+
+void FileInfoModelPrivate::rebuildRowIndex(int from) const
+{
+    // the rows before \a from are not changed.
+    if (from <= 0) {
+        rowIndex.clear();
+        rowIndex.reserve(fileList.count());
+        from = 0;
+    }
+    for (int i = from; i < fileList.count(); ++i)
+        rowIndex.insert(fileList.at(i), i);
+}
+
+void FileInfoModelPrivate::schedulePending()
+{
+    if (!pendingTimer.isActive())
+        pendingTimer.start();
+}
+
+void FileInfoModelPrivate::flushIfPending(const QUrl &url)
+{
+    if (pendingInsertSet.contains(url) || pendingRemoves.contains(url))
+        flushPending();
+}
+
+void FileInfoModelPrivate::flushPending()
+{
+    pendingTimer.stop();
+
+    // the urls in two queues are different, so the order between them does not matter.
+    flushRemoving();
+    flushInserting();
+}
+
+void FileInfoModelPrivate::flushRemoving()
+{
+    if (pendingRemoves.isEmpty())
+        return;
+
+    QList<int> rows;
+    for (const QUrl &url : pendingRemoves) {
+        int row = rowOf(url);
+        if (row >= 0)
+            rows.append(row);
+    }
+    pendingRemoves.clear();
+
+    // remove the continuous rows together, from bottom to top to keep the rows in front valid.
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    int i = 0;
+    while (i < rows.size()) {
+        const int last = rows.at(i);
+        int first = last;
+        while (++i < rows.size() && rows.at(i) == first - 1)
+            first = rows.at(i);
+
+        q->beginRemoveRows(q->rootIndex(), first, last);
+        {
+            QWriteLocker lk(&lock);
+            for (int row = first; row <= last; ++row) {
+                const QUrl &url = fileList.at(row);
+                rowIndex.remove(url);
+                fileMap.remove(url);
+            }
+            fileList.erase(fileList.begin() + first, fileList.begin() + last + 1);
+        }
+        q->endRemoveRows();
+    }
+
+    // only the rows after the first removed one are shifted.
+    if (!rows.isEmpty())
+        rebuildRowIndex(rows.last());
+}
+
+void FileInfoModelPrivate::flushInserting()
+{
+    if (pendingInserts.isEmpty())
+        return;
+
+    QList<QUrl> urls;
+    urls.swap(pendingInserts);
+    pendingInsertSet.clear();
+
+    QList<QUrl> fileUrls;
+    QList<FileInfoPointer> infos;
+    for (const QUrl &url : urls) {
+        auto itemInfo = FileCreator->createFileInfo(url);
+        if (Q_UNLIKELY(!itemInfo)) {
+            fmWarning() << "fail to create file info" << url;
+            continue;
+        }
+        fileUrls.append(url);
+        infos.append(itemInfo);
+    }
+
+    if (fileUrls.isEmpty())
+        return;
+
+    const int row = fileList.count();
+    q->beginInsertRows(q->rootIndex(), row, row + fileUrls.count() - 1);
+    {
+        QWriteLocker lk(&lock);
+        for (int i = 0; i < fileUrls.count(); ++i) {
+            fileList.append(fileUrls.at(i));
+            fileMap.insert(fileUrls.at(i), infos.at(i));
+            rowIndex.insert(fileUrls.at(i), row + i);
+        }
+    }
+    q->endInsertRows();
+}
+
 void FileInfoModelPrivate::resetData(const QList<QUrl> &urls)
 {
     fmDebug() << "to reset file, count:" << urls.size();
@@ -61,11 +193,18 @@ void FileInfoModelPrivate::resetData(const QList<QUrl> &urls)
         }
     }
 
+    // the events before resetting are included in \a urls.
+    pendingTimer.stop();
+    pendingInserts.clear();
+    pendingInsertSet.clear();
+    pendingRemoves.clear();
+
     q->beginResetModel();
     {
         QWriteLocker lk(&lock);
         fileList = fileUrls;
         fileMap = fileMaps;
+        rebuildRowIndex();
     }
 
     modelState = FileInfoModelPrivate::NormalState;
@@ -74,7 +213,10 @@ void FileInfoModelPrivate::resetData(const QList<QUrl> &urls)
 
 void FileInfoModelPrivate::insertData(const QUrl &url)
 {
-    int row = -1;
+    // keep the order of removing and inserting the same file.
+    if (pendingRemoves.contains(url))
+        flushPending();
+
     {
         QReadLocker lk(&lock);
         if (auto cur = fileMap.value(url)) {
@@ -85,45 +227,31 @@ void FileInfoModelPrivate::insertData(const QUrl &url)
             emit q->dataChanged(index, index);
             return;
         }
-        row = fileList.count();
     }
 
-    auto itemInfo = FileCreator->createFileInfo(url);
-    if (Q_UNLIKELY(!itemInfo)) {
-        fmWarning() << "fail to create file info" << url;
+    if (pendingInsertSet.contains(url))
         return;
-    }
 
-    q->beginInsertRows(q->rootIndex(), row, row);
-    {
-        QWriteLocker lk(&lock);
-        fileList.append(url);
-        fileMap.insert(url, itemInfo);
-    }
-    q->endInsertRows();
+    pendingInserts.append(url);
+    pendingInsertSet.insert(url);
+    schedulePending();
 }
 
 void FileInfoModelPrivate::removeData(const QUrl &url)
 {
-    int position = -1;
+    if (pendingInsertSet.contains(url))
+        flushPending();
+
     {
         QReadLocker lk(&lock);
-        position = fileList.indexOf(url);
-    }
-
-    if (Q_UNLIKELY(position < 0)) {
-        fmInfo() << "file dose not exists:" << url;
-        return;
+        if (Q_UNLIKELY(!fileMap.contains(url))) {
+            fmInfo() << "file dose not exists:" << url;
+            return;
+        }
     }
 
-    q->beginRemoveRows(q->rootIndex(), position, position);
-    {
-        QWriteLocker lk(&lock);
-        position = fileList.indexOf(url);
-        fileList.removeAt(position);
-        fileMap.remove(url);
-    }
-    q->endRemoveRows();
+    pendingRemoves.insert(url);
+    schedulePending();
 }
 
 void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
@@ -134,6 +262,9 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
         return;
     }
 
+    // apply the previous events before replacing.
+    flushPending();
+
     // check the newUrl whether has been in cache.
     auto cachedInfo = InfoCacheController::instance().getCacheInfo(newUrl);
     auto newInfo = FileCreator->createFileInfo(newUrl);
@@ -145,7 +276,7 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
 
     {
         QWriteLocker lk(&lock);
-        int position = fileList.indexOf(oldUrl);
+        int position = rowOf(oldUrl);
         if (Q_LIKELY(position < 0)) {
             if (!fileMap.contains(newUrl)) {
                 lk.unlock();
@@ -161,8 +292,9 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
                 // then remove and emit remove signal.
                 lk.unlock();
                 removeData(oldUrl);
+                flushPending();
                 lk.relock();
-                position = fileList.indexOf(newUrl);
+                position = rowOf(newUrl);
                 auto cur = fileMap.value(newUrl);
                 lk.unlock();
 
@@ -173,6 +305,8 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
                 fileList.replace(position, newUrl);
                 fileMap.remove(oldUrl);
                 fileMap.insert(newUrl, newInfo);
+                rowIndex.remove(oldUrl);
+                rowIndex.insert(newUrl, position);
                 lk.unlock();
 
                 // refresh file because an old info cahe may exist.
@@ -190,6 +324,7 @@ void FileInfoModelPrivate::replaceData(const QUrl &oldUrl, const QUrl &newUrl)
 
 void FileInfoModelPrivate::updateData(const QUrl &url)
 {
+    flushIfPending(url);
     {
         QReadLocker lk(&lock);
         if (Q_UNLIKELY(!fileMap.contains(url)))
@@ -211,6 +346,7 @@ void FileInfoModelPrivate::updateData(const QUrl &url)
 
 void FileInfoModelPrivate::dataUpdated(const QUrl &url, const bool isLinkOrg)
 {
+    flushIfPending(url);
     {
         QReadLocker lk(&lock);
         if (Q_UNLIKELY(!fileMap.contains(url)))
@@ -231,6 +367,7 @@ void FileInfoModelPrivate::dataUpdated(const QUrl &url, const bool isLinkOrg)
 void FileInfoModelPrivate::thumbUpdated(const QUrl &url, const QString &thumb)
 {
     using namespace dfmbase::Global;
+    flushIfPending(url);
     FileInfoPointer info { nullptr };
     {
         QReadLocker lk(&lock);
@@ -328,10 +465,9 @@ QModelIndex FileInfoModel::index(const QUrl &url, int column) const
     if (url.isEmpty())
         return QModelIndex();
 
-    if (d->fileMap.contains(url)) {
-        int row = d->fileList.indexOf(url);
+    int row = d->rowOf(url);
+    if (row >= 0)
         return createIndex(row, column);
-    }
 
     if (url == rootUrl())
         return rootIndex();
@@ -8,7 +8,10 @@
 #include "fileinfomodel.h"
 #include "fileprovider.h"
 
+#include <QHash>
 #include <QReadWriteLock>
+#include <QSet>
+#include <QTimer>
 
 namespace ddplugin_canvas {
 
@@ -24,6 +27,9 @@ public:
     explicit FileInfoModelPrivate(FileInfoModel *qq);
     void doRefresh();
     QIcon fileIcon(FileInfoPointer info);
+    int rowOf(const QUrl &url) const;
+    void rebuildRowIndex(int from = 0) const;
+    void flushPending();
 
 public slots:
     void resetData(const QList<QUrl> &urls);
@@ -34,14 +40,28 @@ public slots:
     void dataUpdated(const QUrl &url, const bool isLinkOrg);
     void thumbUpdated(const QUrl &url, const QString &thumb);
 
+private:
+    void schedulePending();
+    void flushIfPending(const QUrl &url);
+    void flushRemoving();
+    void flushInserting();
+
 public:
     QDir::Filters filters = QDir::NoFilter;
     ModelState modelState = NullState;
     FileProvider *fileProvider = nullptr;
     QList<QUrl> fileList;
     QMap<QUrl, FileInfoPointer> fileMap;
+    // the row of url in fileList, the rows are verified when reading and rebuilt if outdated.
+    mutable QHash<QUrl, int> rowIndex;
     QReadWriteLock lock;
 
+    // file events received in one event loop are applied together.
+    QList<QUrl> pendingInserts;
+    QSet<QUrl> pendingInsertSet;
+    QSet<QUrl> pendingRemoves;
+    QTimer pendingTimer;
+
 private:
     FileInfoModel *q = nullptr;
 };
@@ -17,6 +17,7 @@
 #include <dfm-base/dfm_global_defines.h>
 #include <dfm-base/dfm_event_defines.h>
 #include <dfm-base/utils/fileutils.h>
+#include <dfm-base/utils/iconpixmapcache.h>
 
 #include <dfm-framework/dpf.h>
 
@@ -506,10 +507,8 @@ QPixmap CollectionItemDelegate::getIconPixmap(const QIcon &icon, const QSize &si
     if (size.width() <= 0 || size.height() <= 0)
         return QPixmap();
 
-    auto px = icon.pixmap(size, mode, state);
-    px.setDevicePixelRatio(pixelRatio);
-
-    return px;
+    // the QIcon::pixmap does size * pixelRatio.
+    return IconPixmapCache::instance().pixmap(icon, size, pixelRatio, mode, state);
 }
 
 CollectionView *CollectionItemDelegate::parent() const
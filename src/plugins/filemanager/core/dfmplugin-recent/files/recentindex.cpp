@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "recentindex.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <cstring>
+
+#include <sys/stat.h>
+
+namespace dfmplugin_recent {
+
+static constexpr char kBookmarkStart[] { "<bookmark" };
+static constexpr char kBookmarkEnd[] { "</bookmark>" };
+
+bool RecentIndex::update(const QString &path, Delta *delta)
+{
+    struct stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0) {
+        // the file is removed, so are the bookmarks
+        if (entries.isEmpty())
+            return false;
+        update(QByteArray(), delta);
+        key = FileKey();
+        return true;
+    }
+
+    FileKey newKey;
+    newKey.size = st.st_size;
+    newKey.mtime = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    newKey.inode = st.st_ino;
+    if (newKey == key)
+        return false;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fmWarning() << "failed to open recent file: " << path << " error: " << file.errorString();
+        return false;
+    }
+
+    update(file.readAll(), delta);
+    key = newKey;
+    return true;
+}
+
+void RecentIndex::update(const QByteArray &newContent, Delta *delta)
+{
+    // the bookmarks before the first byte changed are the same
+    const qint64 sameSize = std::mismatch(content.cbegin(), content.cbegin() + std::min(content.size(), newContent.size()),
+                                          newContent.cbegin())
+                                    .first
+            - content.cbegin();
+    if (sameSize == content.size() && sameSize == newContent.size()) {
+        lastParsedSize = 0;
+        return;
+    }
+
+    const auto keptEnd = std::partition_point(order.cbegin(), order.cend(), [this, sameSize](const QString &href) {
+        const Entry &entry = entries.value(href);
+        return entry.offset + entry.length <= sameSize;
+    });
+    const int kept = static_cast<int>(keptEnd - order.cbegin());
+    qint64 pos = 0;
+    if (kept > 0) {
+        const Entry &last = entries.value(order.at(kept - 1));
+        pos = last.offset + last.length;
+    }
+
+    // the bookmarks after are compared with the ones parsed again
+    QHash<QString, Entry> oldEntries;
+    for (int i = kept; i < order.size(); ++i)
+        oldEntries.insert(order.at(i), entries.take(order.at(i)));
+    order.resize(kept);
+
+    lastParsedSize = newContent.size() - pos;
+    const int startSize = static_cast<int>(strlen(kBookmarkStart));
+    const int endSize = static_cast<int>(strlen(kBookmarkEnd));
+    while (pos < newContent.size()) {
+        const int start = newContent.indexOf(kBookmarkStart, static_cast<int>(pos));
+        if (start < 0 || start + startSize >= newContent.size())
+            break;
+
+        // <bookmark:applications> and so on are in the bookmark
+        const char next = newContent.at(start + startSize);
+        if (next != ' ' && next != '\t' && next != '\n' && next != '\r' && next != '>' && next != '/') {
+            pos = start + startSize;
+            continue;
+        }
+
+        const int tagEnd = newContent.indexOf('>', start);
+        if (tagEnd < 0)
+            break;
+        int end = tagEnd + 1;
+        if (newContent.at(tagEnd - 1) != '/') {
+            const int close = newContent.indexOf(kBookmarkEnd, tagEnd);
+            if (close < 0)
+                break;
+            end = close + endSize;
+        }
+        pos = end;
+
+        const QByteArray &tag = QByteArray::fromRawData(newContent.constData() + start, tagEnd - start);
+        const QString &href = attribute(tag, "href");
+        if (href.isEmpty() || entries.contains(href))
+            continue;
+
+        Entry entry;
+        entry.modified = attribute(tag, "modified");
+        entry.visited = attribute(tag, "visited");
+        entry.offset = start;
+        entry.length = end - start;
+
+        auto it = oldEntries.find(href);
+        if (it == oldEntries.end()) {
+            delta->added.append(href);
+        } else {
+            if (it->modified != entry.modified || it->visited != entry.visited)
+                delta->updated.append(href);
+            oldEntries.erase(it);
+        }
+        entries.insert(href, entry);
+        order.append(href);
+    }
+
+    for (auto it = oldEntries.cbegin(); it != oldEntries.cend(); ++it)
+        delta->removed.append(it.key());
+
+    content = newContent;
+}
+
+void RecentIndex::clear()
+{
+    entries.clear();
+    order.clear();
+    content.clear();
+    key = FileKey();
+    lastParsedSize = 0;
+}
+
+QString RecentIndex::attribute(const QByteArray &tag, const char *name)
+{
+    const QByteArray &pattern = QByteArray(name) + '=';
+    int pos = 0;
+    while ((pos = tag.indexOf(pattern, pos)) > 0) {
+        const char before = tag.at(pos - 1);
+        const int valueStart = pos + pattern.size();
+        pos = valueStart;
+        if ((before != ' ' && before != '\t' && before != '\n' && before != '\r') || valueStart >= tag.size())
+            continue;
+
+        const char quote = tag.at(valueStart);
+        if (quote != '"' && quote != '\'')
+            continue;
+        const int valueEnd = tag.indexOf(quote, valueStart + 1);
+        if (valueEnd < 0)
+            return QString();
+        return unescape(tag.mid(valueStart + 1, valueEnd - valueStart - 1));
+    }
+    return QString();
+}
+
+QString RecentIndex::unescape(const QByteArray &value)
+{
+    if (!value.contains('&'))
+        return QString::fromUtf8(value);
+
+    QByteArray result;
+    result.reserve(value.size());
+    for (int i = 0; i < value.size(); ++i) {
+        const int end = value.at(i) == '&' ? value.indexOf(';', i) : -1;
+        if (end < 0) {
+            result.append(value.at(i));
+            continue;
+        }
+
+        const QByteArray &entity = value.mid(i + 1, end - i - 1);
+        if (entity == "amp") {
+            result.append('&');
+        } else if (entity == "lt") {
+            result.append('<');
+        } else if (entity == "gt") {
+            result.append('>');
+        } else if (entity == "quot") {
+            result.append('"');
+        } else if (entity == "apos") {
+            result.append('\'');
+        } else if (entity.startsWith('#')) {
+            bool ok = false;
+            const uint code = entity.startsWith("#x") ? entity.mid(2).toUInt(&ok, 16) : entity.mid(1).toUInt(&ok, 10);
+            if (!ok) {
+                result.append(value.at(i));
+                continue;
+            }
+            result.append(QString::fromUcs4(&code, 1).toUtf8());
+        } else {
+            result.append(value.at(i));
+            continue;
+        }
+        i = end;
+    }
+    return QString::fromUtf8(result);
+}
+
+}
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RECENTINDEX_H
+#define RECENTINDEX_H
+
+#include "dfmplugin_recent_global.h"
+
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QByteArray>
+
+namespace dfmplugin_recent {
+
+/*!
+ * \brief The RecentIndex class keeps the bookmarks of recently-used.xbel in memory.
+ * The file is reloaded only if its size, mtime or inode is changed. The bytes before the first
+ * changed one are the same as the last load, so the bookmarks in them are kept and only the
+ * bookmarks after are parsed again. The changes are given as the hrefs added, removed and updated.
+ */
+class RecentIndex
+{
+public:
+    struct Entry
+    {
+        QString modified;
+        QString visited;
+        qint64 offset { 0 };   // the offset of the bookmark in the file
+        qint64 length { 0 };
+    };
+
+    struct Delta
+    {
+        QStringList added;
+        QStringList removed;
+        QStringList updated;   // the modified or visited time is changed
+
+        inline bool isEmpty() const { return added.isEmpty() && removed.isEmpty() && updated.isEmpty(); }
+    };
+
+    // reload the xbel file of \a path, return false if it is not changed
+    bool update(const QString &path, Delta *delta);
+    // reload the content of xbel file
+    void update(const QByteArray &content, Delta *delta);
+    void clear();
+
+    inline bool contains(const QString &href) const { return entries.contains(href); }
+    inline Entry entry(const QString &href) const { return entries.value(href); }
+    inline int count() const { return entries.count(); }
+    inline QStringList hrefs() const { return order.toList(); }
+    // the bytes parsed in the last update
+    inline qint64 parsedSize() const { return lastParsedSize; }
+
+private:
+    struct FileKey
+    {
+        qint64 size { -1 };
+        qint64 mtime { -1 };   // in nanoseconds
+        quint64 inode { 0 };
+
+        inline bool operator==(const FileKey &other) const
+        {
+            return size == other.size && mtime == other.mtime && inode == other.inode;
+        }
+    };
+
+    static QString attribute(const QByteArray &tag, const char *name);
+    static QString unescape(const QByteArray &value);
+
+private:
+    QHash<QString, Entry> entries;
+    QVector<QString> order;   // the hrefs in the order of file
+    QByteArray content;   // the content of the last load
+    FileKey key;
+    qint64 lastParsedSize { 0 };
+};
+
+}
+
+#endif   // RECENTINDEX_H
@@ -12,7 +12,7 @@
 #include <dfm-base/base/device/deviceutils.h>
 
 #include <QDir>
-#include <QXmlStreamReader>
+#include <QSet>
 #include <QUrl>
 #include <QMetaType>
 #include <QList>
@@ -28,56 +28,77 @@ RecentIterateWorker::RecentIterateWorker()
 
 void RecentIterateWorker::onRecentFileChanged(const QList<QUrl> &cachedUrls)
 {
-    QFile file(RecentHelper::xbelPath());
-    QList<QUrl> urlList;
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-        return;
-
-    QXmlStreamReader reader(&file);
-    while (!reader.atEnd()) {
-        if (reader.readNext() == QXmlStreamReader::EndDocument)
-            continue;
-
-        if (!reader.isStartElement() || reader.name() != "bookmark")
-            continue;
+    // only the bookmarks changed are checked, the others are the same as last time
+    RecentIndex::Delta delta;
+    index.update(RecentHelper::xbelPath(), &delta);
+
+    QSet<QUrl> deletedUrls;
+    for (const QString &href : delta.removed) {
+        const QUrl &url = recentUrls.take(href);
+        if (url.isValid())
+            deletedUrls.insert(url);
+    }
 
-        const QString &location = reader.attributes().value("href").toString();
-        const QString &readTime = reader.attributes().value("modified").toString();
+    // the bookmarks rejected last time are checked again when their href or modified time changes,
+    // or when the index is reset by mounting or unmounting a device
+    for (const QString &href : delta.added + delta.updated) {
+        if (stopped)
+            return;
 
-        if (location.isEmpty())
-            continue;
+        const QUrl &recentUrl = recentUrlOf(href);
+        const QUrl &oldUrl = recentUrls.value(href);
+        if (oldUrl.isValid() && oldUrl != recentUrl)
+            deletedUrls.insert(oldUrl);
 
-        const QUrl &url { QUrl(location) };
-        if (DeviceUtils::isLowSpeedDevice(url))
+        if (!recentUrl.isValid()) {
+            recentUrls.remove(href);
             continue;
-
-        auto info = InfoFactory::create<FileInfo>(url, Global::CreateFileInfoType::kCreateFileInfoSync);
-        if (stopped)
-            return;
-        if (info && info->exists() && info->isAttributes(OptInfoType::kIsFile)) {
-            const auto &bindPath = FileUtils::bindPathTransform(info->pathOf(PathInfoType::kAbsoluteFilePath), false);
-            QUrl recentUrl { QUrl::fromLocalFile(bindPath) };
-            recentUrl.setScheme(RecentHelper::scheme());
-            qint64 readTimeSecs = QDateTime::fromString(readTime, Qt::ISODate).toSecsSinceEpoch();
-            urlList.append(recentUrl);
-            emit updateRecentFileInfo(recentUrl, location, readTimeSecs);
         }
-    }
 
-    if (reader.hasError()) {
-        fmWarning() << "Read recent xml file has error! Error: " << reader.errorString();
-        return;
+        recentUrls.insert(href, recentUrl);
+        const QString &readTime = index.entry(href).modified;
+        qint64 readTimeSecs = QDateTime::fromString(readTime, Qt::ISODate).toSecsSinceEpoch();
+        emit updateRecentFileInfo(recentUrl, href, readTimeSecs);
     }
 
     // delete cached recent file when recent file removed
-    QList<QUrl> deletedUrls;
+    QSet<QUrl> shownUrls;
+    shownUrls.reserve(recentUrls.size());
+    for (const QUrl &url : recentUrls)
+        shownUrls.insert(url);
     for (const QUrl &url : cachedUrls) {
-        if (!urlList.contains(url))
-            deletedUrls << url;
+        if (!shownUrls.contains(url))
+            deletedUrls.insert(url);
     }
     if (!deletedUrls.isEmpty())
-        emit deleteExistRecentUrls(deletedUrls);
+        emit deleteExistRecentUrls(deletedUrls.toList());
+}
+
+void RecentIterateWorker::onRecentFileReset(const QList<QUrl> &cachedUrls)
+{
+    // the files may be gone with the device, all the bookmarks are checked again
+    index.clear();
+    recentUrls.clear();
+    onRecentFileChanged(cachedUrls);
+}
+
+QUrl RecentIterateWorker::recentUrlOf(const QString &href)
+{
+    if (href.isEmpty())
+        return QUrl();
+
+    const QUrl &url { QUrl(href) };
+    if (DeviceUtils::isLowSpeedDevice(url))
+        return QUrl();
+
+    auto info = InfoFactory::create<FileInfo>(url, Global::CreateFileInfoType::kCreateFileInfoSync);
+    if (!info || !info->exists() || !info->isAttributes(OptInfoType::kIsFile))
+        return QUrl();
+
+    const auto &bindPath = FileUtils::bindPathTransform(info->pathOf(PathInfoType::kAbsoluteFilePath), false);
+    QUrl recentUrl { QUrl::fromLocalFile(bindPath) };
+    recentUrl.setScheme(RecentHelper::scheme());
+    return recentUrl;
 }
 
 void RecentIterateWorker::stop()
@@ -6,8 +6,11 @@
 #define RECENTITERATEWORKER_H
 
 #include "dfmplugin_recent_global.h"
+#include "files/recentindex.h"
 
 #include <QObject>
+#include <QHash>
+#include <QUrl>
 
 namespace dfmplugin_recent {
 
@@ -20,14 +23,21 @@ public:
 
 public slots:
     void onRecentFileChanged(const QList<QUrl> &cachedUrls);
+    void onRecentFileReset(const QList<QUrl> &cachedUrls);
 public:
     void stop();
 
 signals:
     void updateRecentFileInfo(const QUrl &url, const QString originPath, qint64 readTime);
     void deleteExistRecentUrls(const QList<QUrl> &urls);
+
+private:
+    QUrl recentUrlOf(const QString &href);
+
 private:
     std::atomic_bool stopped{ false };
+    RecentIndex index;   // the bookmarks in recently-used.xbel
+    QHash<QString, QUrl> recentUrls;   // the recent urls of bookmarks shown
 };
 }
 #endif   // RECENTITERATEWORKER_H
@@ -189,6 +189,8 @@ void RecentManager::init()
     connect(&workerThread, &QThread::finished, iteratorWorker, &QObject::deleteLater);
     connect(this, &RecentManager::asyncHandleFileChanged,
             iteratorWorker, &RecentIterateWorker::onRecentFileChanged);
+    connect(this, &RecentManager::asyncResetRecent,
+            iteratorWorker, &RecentIterateWorker::onRecentFileReset);
 
     connect(iteratorWorker, &RecentIterateWorker::updateRecentFileInfo, this,
             &RecentManager::onUpdateRecentFileInfo);
@@ -204,7 +206,8 @@ void RecentManager::init()
     connect(watcher.data(), &AbstractFileWatcher::fileAttributeChanged, this, &RecentManager::updateRecent);
     watcher->startWatcher();
 
-    connect(DevProxyMng, &DeviceProxyManager::protocolDevUnmounted, this, &RecentManager::updateRecent);
+    connect(DevProxyMng, &DeviceProxyManager::protocolDevMounted, this, &RecentManager::resetRecent);
+    connect(DevProxyMng, &DeviceProxyManager::protocolDevUnmounted, this, &RecentManager::resetRecent);
 }
 
 void RecentManager::updateRecent()
@@ -212,6 +215,11 @@ void RecentManager::updateRecent()
     emit asyncHandleFileChanged(recentNodes.keys());
 }
 
+void RecentManager::resetRecent()
+{
+    emit asyncResetRecent(recentNodes.keys());
+}
+
 void RecentManager::onUpdateRecentFileInfo(const QUrl &url, const QString &originPath, qint64 readTime)
 {
     if (!recentNodes.contains(url)) {
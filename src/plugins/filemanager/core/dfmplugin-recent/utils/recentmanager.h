@@ -77,6 +77,7 @@ public:
 
 signals:
     void asyncHandleFileChanged(const QList<QUrl> &);
+    void asyncResetRecent(const QList<QUrl> &);
 
 private:
     explicit RecentManager(QObject *parent = nullptr);
@@ -86,6 +87,7 @@ private:
 
 public slots:
     void updateRecent();
+    void resetRecent();
 private slots:
     void onUpdateRecentFileInfo(const QUrl &url, const QString &originPath, qint64 readTime);
     void onDeleteExistRecentUrls(const QList<QUrl> &urls);
@@ -20,13 +20,18 @@ CompleterViewModel::~CompleterViewModel()
 void CompleterViewModel::setStringList(const QStringList &list)
 {
     removeAll();
+
+    // the rows are inserted at once, the completer filters them once only
+    QList<QStandardItem *> items;
+    items.reserve(list.size());
     for (const auto &str : list) {
         if (str.isEmpty())
             continue;
 
-        QStandardItem *item = new QStandardItem(str);
-        appendRow(item);
+        items.append(new QStandardItem(str));
     }
+    if (!items.isEmpty())
+        invisibleRootItem()->appendRows(items);
 }
 
 void CompleterViewModel::removeAll()
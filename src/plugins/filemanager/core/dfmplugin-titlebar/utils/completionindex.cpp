@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "completionindex.h"
+
+#include <dfm-base/utils/chinese2pinyin.h>
+
+#include <algorithm>
+
+using namespace dfmplugin_titlebar;
+
+void CompletionIndex::setHistory(const QStringList &history)
+{
+    clear();
+    for (int i = 0; i < history.size(); ++i)
+        appendWord(history.at(i), static_cast<double>(i + 1) / history.size());
+}
+
+void CompletionIndex::append(const QStringList &words)
+{
+    for (const QString &word : words)
+        appendWord(word, 0);
+}
+
+void CompletionIndex::clear()
+{
+    words.clear();
+    scores.clear();
+    wordIndexes.clear();
+    keys.clear();
+    pendingKeys.clear();
+}
+
+void CompletionIndex::used(const QString &word)
+{
+    useCounts[word]++;
+}
+
+QStringList CompletionIndex::match(const QString &prefix, int limit) const
+{
+    if (limit <= 0 || words.isEmpty())
+        return {};
+
+    sortKeys();
+
+    Key begin;
+    begin.text = foldedKey(prefix);
+    const auto first = std::lower_bound(keys.cbegin(), keys.cend(), begin);
+    const auto last = std::partition_point(first, keys.cend(), [&begin](const Key &key) {
+        return key.text.startsWith(begin.text);
+    });
+
+    // the words of same score are in the order of keys, a word may be matched by both of its keys
+    struct Matched
+    {
+        double score;
+        int order;
+        int word;
+    };
+    QVector<Matched> matched;
+    matched.reserve(static_cast<int>(last - first));
+    for (auto it = first; it != last; ++it) {
+        if (it->isPinyin && foldedKey(words.at(it->word)).startsWith(begin.text))
+            continue;
+        matched.append({ scoreOf(it->word), matched.size(), it->word });
+    }
+
+    const int size = std::min(limit, matched.size());
+    std::partial_sort(matched.begin(), matched.begin() + size, matched.end(), [](const Matched &left, const Matched &right) {
+        if (left.score != right.score)
+            return left.score > right.score;
+        return left.order < right.order;
+    });
+
+    QStringList result;
+    result.reserve(size);
+    for (int i = 0; i < size; ++i)
+        result.append(words.at(matched.at(i).word));
+    return result;
+}
+
+QString CompletionIndex::foldedKey(const QString &word)
+{
+    return word.toCaseFolded();
+}
+
+QString CompletionIndex::pinyinInitials(const QString &word)
+{
+    QString initials;
+    bool hasPinyin = false;
+    initials.reserve(word.size());
+    for (const QChar &ch : word) {
+        if (ch.unicode() < 0x3400) {
+            initials.append(ch.toCaseFolded());
+            continue;
+        }
+
+        const QString &pinyin = Pinyin::Chinese2Pinyin(QString(ch));
+        if (pinyin.isEmpty() || pinyin == ch) {
+            initials.append(ch);
+            continue;
+        }
+        initials.append(pinyin.at(0).toLower());
+        hasPinyin = true;
+    }
+    return hasPinyin ? initials : QString();
+}
+
+void CompletionIndex::appendWord(const QString &word, double score)
+{
+    // 防止出现空的补全提示
+    if (word.isEmpty())
+        return;
+
+    auto it = wordIndexes.find(word);
+    if (it != wordIndexes.end()) {
+        scores[it.value()] = std::max(scores.at(it.value()), score);
+        return;
+    }
+
+    const int index = words.size();
+    words.append(word);
+    scores.append(score);
+    wordIndexes.insert(word, index);
+
+    Key key;
+    key.text = foldedKey(word);
+    key.word = index;
+    pendingKeys.append(key);
+
+    key.text = pinyinInitials(word);
+    key.isPinyin = true;
+    if (!key.text.isEmpty())
+        pendingKeys.append(key);
+}
+
+void CompletionIndex::sortKeys() const
+{
+    if (pendingKeys.isEmpty())
+        return;
+
+    // the keys appended are merged into the sorted ones, they are not sorted again
+    std::sort(pendingKeys.begin(), pendingKeys.end());
+    const int sortedSize = keys.size();
+    keys.append(pendingKeys);
+    pendingKeys.clear();
+    std::inplace_merge(keys.begin(), keys.begin() + sortedSize, keys.end());
+}
+
+double CompletionIndex::scoreOf(int index) const
+{
+    return scores.at(index) + useCounts.value(words.at(index));
+}
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef COMPLETIONINDEX_H
+#define COMPLETIONINDEX_H
+
+#include "dfmplugin_titlebar_global.h"
+
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+namespace dfmplugin_titlebar {
+
+/*!
+ * \brief The CompletionIndex class finds the completions of the address bar by prefix.
+ * The words are appended in batches while the directory is traversed, each word is keyed by its
+ * case folded text and, if it has chinese characters, by its pinyin initials. The keys are kept
+ * in a sorted array, so the words matching a prefix are a range found by binary search.
+ * The matched words are ranked by their frecency: the history used recently and the words
+ * completed often are ranked first.
+ */
+class CompletionIndex
+{
+public:
+    // the words appended to the history are ranked by their position, the last is the most recent
+    void setHistory(const QStringList &history);
+    void append(const QStringList &words);
+    void clear();
+    // the word is completed once more, it is ranked before the others
+    void used(const QString &word);
+
+    // the best \a limit words starting with \a prefix, the case and pinyin initials are ignored
+    QStringList match(const QString &prefix, int limit) const;
+    inline int count() const { return words.count(); }
+
+    static QString foldedKey(const QString &word);
+    static QString pinyinInitials(const QString &word);
+
+private:
+    struct Key
+    {
+        QString text;
+        int word { 0 };   // the index of word
+        bool isPinyin { false };
+
+        inline bool operator<(const Key &other) const { return text < other.text; }
+    };
+
+    void appendWord(const QString &word, double score);
+    void sortKeys() const;
+    double scoreOf(int index) const;
+
+private:
+    QStringList words;
+    QVector<double> scores;   // the recency of the words in history
+    QHash<QString, int> wordIndexes;
+    mutable QVector<Key> keys;   // sorted by text
+    mutable QVector<Key> pendingKeys;   // the keys appended after the last match
+    QHash<QString, int> useCounts;   // kept after clear, the words are completed in other directories too
+};
+
+}
+
+#endif   // COMPLETIONINDEX_H
@@ -22,6 +22,8 @@
 
 using namespace dfmplugin_titlebar;
 
+static constexpr int kCompletionLimit { 100 };
+
 /*!
  * \class AddressBarPrivate
  * \brief parent
@@ -185,7 +187,8 @@ void AddressBarPrivate::setCompleter(QCompleter *c)
 
     urlCompleter->setModel(&completerModel);
     urlCompleter->setPopup(completerView);
-    urlCompleter->setCompletionMode(QCompleter::PopupCompletion);
+    // the model is filled with the matched completions, it is not filtered by completer again
+    urlCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
     urlCompleter->setCaseSensitivity(Qt::CaseSensitive);
     urlCompleter->setMaxVisibleItems(10);
     completerView->setItemDelegate(&cpItemDelegate);
@@ -204,9 +207,16 @@ void AddressBarPrivate::setCompleter(QCompleter *c)
 void AddressBarPrivate::clearCompleterModel()
 {
     isHistoryInCompleterModel = false;
+    completionIndex.clear();
     completerModel.setStringList(QStringList());
 }
 
+void AddressBarPrivate::updateCompleterModel(const QString &prefix)
+{
+    completerModel.setStringList(completionIndex.match(prefix, kCompletionLimit));
+    urlCompleter->setCompletionPrefix(prefix);
+}
+
 void AddressBarPrivate::updateCompletionState(const QString &text)
 {
     if (ipRegExp.exactMatch(text)) {
@@ -265,18 +275,13 @@ void AddressBarPrivate::doComplete()
 
 void AddressBarPrivate::appendToCompleterModel(const QStringList &stringList)
 {
-    for (const QString &str : stringList) {
-        // 防止出现空的补全提示
-        if (str.isEmpty())
-            continue;
-
-        QStandardItem *item = new QStandardItem(str);
-        completerModel.appendRow(item);
-    }
+    // the model is updated when the traversal is finished or the text is edited
+    completionIndex.append(stringList);
 }
 
 void AddressBarPrivate::onTravelCompletionListFinished()
 {
+    updateCompleterModel(urlCompleter->completionPrefix());
     if (urlCompleter->completionCount() > 0) {
         if (urlCompleter->popup()->isHidden() && q->isVisible())
             doComplete();
@@ -319,19 +324,18 @@ void AddressBarPrivate::completeSearchHistory(const QString &text)
     // Update Icon
     setIndicator(AddressBar::IndicatorType::Search);
 
-    // set completion prefix.
-    urlCompleter->setCompletionPrefix(text);
-
-    // Check if we already loaded history list in model
-    if (isHistoryInCompleterModel)
-        return;
+    // Check if we already loaded history list in index
+    if (!isHistoryInCompleterModel) {
+        // Set Base String
+        this->completerBaseString = "";
 
-    // Set Base String
-    this->completerBaseString = "";
+        // History completion.
+        isHistoryInCompleterModel = true;
+        completionIndex.setHistory(historyList);
+    }
 
-    // History completion.
-    isHistoryInCompleterModel = true;
-    completerModel.setStringList(historyList);
+    // set completion prefix.
+    updateCompleterModel(text);
 }
 
 void AddressBarPrivate::completeIpAddress(const QString &text)
@@ -381,7 +385,7 @@ void AddressBarPrivate::completeLocalPath(const QString &text, const QUrl &url,
     if (!isHistoryInCompleterModel
         && (this->completerBaseString == text.left(slashIndex + 1)
             || UrlRoute::fromUserInput(completerBaseString) == UrlRoute::fromUserInput(text.left(slashIndex + 1)))) {
-        urlCompleter->setCompletionPrefix(text.mid(slashIndex + 1));   // set completion prefix first
+        updateCompleterModel(text.mid(slashIndex + 1));   // set completion prefix first
         onCompletionModelCountChanged();   // will call complete()
         return;
     }
@@ -475,6 +479,7 @@ void AddressBarPrivate::insertCompletion(const QString &completion)
         return;
     }
 
+    completionIndex.used(completion);
     if (inputIsIpAddress) {
         q->setText(completion);
     } else {
@@ -494,10 +499,11 @@ void AddressBarPrivate::onCompletionHighlighted(const QString &highlightedComple
         q->setText(highlightedCompletion);
         q->setSelection(0, selectLength);
     } else {
-        int completionPrefixLen = urlCompleter->completionPrefix().length();
-        int selectBeginPos = highlightedCompletion.length() - completionPrefixLen;
+        // the case insensitive and pinyin matches do not start with the text typed, the whole name is selected
+        const QString &completionPrefix = urlCompleter->completionPrefix();
+        const int matchedLen = highlightedCompletion.startsWith(completionPrefix) ? completionPrefix.length() : 0;
         q->setText(completerBaseString + highlightedCompletion);
-        q->setSelection(q->text().length() - selectBeginPos, q->text().length());
+        q->setSelection(completerBaseString.length() + matchedLen, highlightedCompletion.length() - matchedLen);
     }
 }
 
@@ -661,7 +667,8 @@ void AddressBar::keyPressEvent(QKeyEvent *e)
             if (ret) {
                 d->historyList.clear();
                 d->historyList.append(SearchHistroyManager::instance()->getSearchHistroy());
-                d->completerModel.setStringList(d->historyList);
+                d->completionIndex.setHistory(d->historyList);
+                d->updateCompleterModel(d->urlCompleter->completionPrefix());
             }
         }
 
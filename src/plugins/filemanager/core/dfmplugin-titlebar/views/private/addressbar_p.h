@@ -10,6 +10,7 @@
 #include "views/completerview.h"
 #include "views/completerviewdelegate.h"
 #include "models/completerviewmodel.h"
+#include "utils/completionindex.h"
 
 #include <dfm-base/base/urlroute.h>
 
@@ -58,6 +59,7 @@ class AddressBarPrivate : public QObject
     bool isKeyPressed { false };
     CrumbInterface *crumbController { nullptr };
     CompleterViewModel completerModel;
+    CompletionIndex completionIndex;   // the completions of history or the directory, the model shows the best of them
     CompleterView *completerView { nullptr };
     QCompleter *urlCompleter { nullptr };
     CompleterViewDelegate cpItemDelegate;
@@ -79,6 +81,7 @@ public:
     void setIndicator(enum AddressBar::IndicatorType type);
     void setCompleter(QCompleter *c);
     void clearCompleterModel();
+    void updateCompleterModel(const QString &prefix);
     void updateCompletionState(const QString &text);
     void doComplete();
     void requestCompleteByUrl(const QUrl &url);
@@ -5,6 +5,7 @@
 #include "itemdelegatehelper.h"
 
 #include <dfm-base/utils/fileutils.h>
+#include <dfm-base/utils/iconpixmapcache.h>
 
 #include <QPainter>
 #include <QApplication>
@@ -32,10 +33,7 @@ QPixmap ItemDelegateHelper::getIconPixmap(const QIcon &icon, const QSize &size,
     if (size.width() <= 0 || size.height() <= 0)
         return QPixmap();
 
-    auto px = icon.pixmap(size, mode, state);
-    px.setDevicePixelRatio(qApp->devicePixelRatio());
-
-    return px;
+    return IconPixmapCache::instance().pixmap(icon, size, qApp->devicePixelRatio(), mode, state);
 }
 /*!
  * \brief paintIcon 绘制指定区域内每一个icon的pixmap
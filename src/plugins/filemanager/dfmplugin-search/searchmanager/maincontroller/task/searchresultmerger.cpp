@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "searchresultmerger.h"
+
+#include <algorithm>
+
+DPSEARCH_USE_NAMESPACE
+
+namespace {
+// 名称匹配得分
+constexpr int kExactMatch = 1000;
+constexpr int kPrefixMatch = 600;
+constexpr int kWordMatch = 400;
+constexpr int kContainMatch = 200;
+// 相对搜索目录每深一层扣分，最多扣到 kMaxDepthPenalty
+constexpr int kDepthPenalty = 10;
+constexpr int kMaxDepthPenalty = 150;
+}
+
+SearchResultMerger::SearchResultMerger(const QUrl &searchUrl, const QString &keyword, int capacity)
+    : rootPath(searchUrl.path()),
+      keyword(keyword.trimmed()),
+      capacity(qMax(1, capacity))
+{
+    if (!rootPath.endsWith('/'))
+        rootPath.append('/');
+}
+
+/*!
+ * \brief merge a batch of urls coming from one searcher.
+ * \return true if there were no pending results before this call and there is at least one now.
+ */
+bool SearchResultMerger::merge(const QList<QUrl> &urls)
+{
+    const bool wasEmpty = pending.empty();
+    for (const QUrl &url : urls) {
+        if (seen.contains(url))
+            continue;
+
+        Item item { score(url), seq++, url };
+        if (delivered + static_cast<int>(pending.size()) < capacity) {
+            seen.insert(url);
+            pending.push_back(std::move(item));
+            std::push_heap(pending.begin(), pending.end(), betterThan);
+            continue;
+        }
+
+        // 已满，只有比当前最差的待分发结果更好时才替换
+        if (pending.empty() || !betterThan(item, pending.front()))
+            continue;
+
+        std::pop_heap(pending.begin(), pending.end(), betterThan);
+        pending.back() = std::move(item);
+        std::push_heap(pending.begin(), pending.end(), betterThan);
+        seen.insert(url);
+    }
+
+    return wasEmpty && !pending.empty();
+}
+
+/*!
+ * \brief take all pending results, the best match comes first.
+ */
+QList<QUrl> SearchResultMerger::takePending()
+{
+    std::sort_heap(pending.begin(), pending.end(), betterThan);
+
+    QList<QUrl> results;
+    results.reserve(static_cast<int>(pending.size()));
+    for (auto it = pending.begin(); it != pending.end(); ++it)
+        results.append(std::move(it->url));
+
+    delivered += results.size();
+    pending.clear();
+    return results;
+}
+
+bool SearchResultMerger::hasPending() const
+{
+    return !pending.empty();
+}
+
+int SearchResultMerger::count() const
+{
+    return delivered + static_cast<int>(pending.size());
+}
+
+int SearchResultMerger::score(const QUrl &url) const
+{
+    const QString &path = url.path();
+    const int nameStart = path.lastIndexOf('/') + 1;
+    const QStringRef name = path.midRef(nameStart);
+
+    int value = 0;
+    if (!keyword.isEmpty()) {
+        const int pos = name.indexOf(keyword, 0, Qt::CaseInsensitive);
+        if (pos == 0) {
+            value = name.size() == keyword.size() ? kExactMatch : kPrefixMatch;
+        } else if (pos > 0) {
+            const QChar prev = name.at(pos - 1);
+            value = prev.isLetterOrNumber() ? kContainMatch : kWordMatch;
+        }
+        // 全文搜索的结果名称不一定包含关键字，得分为0
+    }
+
+    int depth = 0;
+    const int from = path.startsWith(rootPath) ? rootPath.size() : 0;
+    for (int i = from; i < nameStart; ++i) {
+        if (path.at(i) == '/')
+            ++depth;
+    }
+
+    return value - qMin(depth * kDepthPenalty, kMaxDepthPenalty);
+}
+
+// 得分高的更好，得分相同时先到的更好；堆顶因此总是最差的结果
+bool SearchResultMerger::betterThan(const Item &a, const Item &b)
+{
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.seq < b.seq;
+}
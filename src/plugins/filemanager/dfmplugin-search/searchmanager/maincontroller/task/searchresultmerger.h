@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SEARCHRESULTMERGER_H
+#define SEARCHRESULTMERGER_H
+
+#include "dfmplugin_search_global.h"
+
+#include <QUrl>
+#include <QSet>
+#include <QList>
+
+#include <vector>
+
+DPSEARCH_BEGIN_NAMESPACE
+
+/*!
+ * \brief The SearchResultMerger class merges the results of all the searchers of one task.
+ * Results are de-duplicated across searchers and ranked by relevance, the best
+ * matches of every batch are handed out first. At most `capacity` results are
+ * accepted for a task, when full a better match evicts the worst pending one.
+ * Not thread safe, the caller must serialize access.
+ */
+class SearchResultMerger
+{
+public:
+    enum { kDefaultCapacity = 100000 };
+
+    explicit SearchResultMerger(const QUrl &searchUrl, const QString &keyword,
+                                int capacity = kDefaultCapacity);
+
+    bool merge(const QList<QUrl> &urls);
+    QList<QUrl> takePending();
+    bool hasPending() const;
+    int count() const;
+
+    int score(const QUrl &url) const;
+
+private:
+    struct Item
+    {
+        int score;
+        quint64 seq;
+        QUrl url;
+    };
+    static bool betterThan(const Item &a, const Item &b);
+
+    QString rootPath;
+    QString keyword;
+    int capacity = kDefaultCapacity;
+    int delivered = 0;
+    quint64 seq = 0;
+
+    QSet<QUrl> seen;
+    std::vector<Item> pending;   // heap ordered by betterThan, the worst item is at the top
+};
+
+DPSEARCH_END_NAMESPACE
+
+#endif   // SEARCHRESULTMERGER_H
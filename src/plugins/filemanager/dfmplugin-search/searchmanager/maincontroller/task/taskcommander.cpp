@@ -13,9 +13,10 @@
 
 DPSEARCH_USE_NAMESPACE
 
-TaskCommanderPrivate::TaskCommanderPrivate(TaskCommander *parent)
+TaskCommanderPrivate::TaskCommanderPrivate(const QUrl &url, const QString &keyword, TaskCommander *parent)
     : QObject(parent),
-      q(parent)
+      q(parent),
+      merger(url, keyword)
 {
 }
 
@@ -52,11 +53,8 @@ void TaskCommanderPrivate::onUnearthed(AbstractSearcher *searcher)
     if (allSearchers.contains(searcher) && searcher->hasItem()) {
         auto results = searcher->takeAll();
         QWriteLocker lk(&rwLock);
-        bool isEmpty = resultList.isEmpty();
-
-        resultList += results;
         //回到主线程发送信号
-        if (isEmpty)
+        if (merger.merge(results))
             QMetaObject::invokeMethod(q, "matched", Qt::QueuedConnection, Q_ARG(QString, taskId));
     }
 }
@@ -77,7 +75,7 @@ void TaskCommanderPrivate::onFinished()
 
 TaskCommander::TaskCommander(QString taskId, const QUrl &url, const QString &keyword, QObject *parent)
     : QObject(parent),
-      d(new TaskCommanderPrivate(this))
+      d(new TaskCommanderPrivate(url, keyword, this))
 {
     d->taskId = taskId;
     createSearcher(url, keyword);
@@ -90,8 +88,8 @@ QString TaskCommander::taskID() const
 
 QList<QUrl> TaskCommander::getResults() const
 {
-    QReadLocker lk(&d->rwLock);
-    return std::move(d->resultList);
+    QWriteLocker lk(&d->rwLock);
+    return d->merger.takePending();
 }
 
 bool TaskCommander::start()
@@ -7,6 +7,7 @@
 
 #include "taskcommander.h"
 #include "searchmanager/searcher/abstractsearcher.h"
+#include "searchresultmerger.h"
 
 #include <QFutureWatcher>
 #include <QUrl>
@@ -20,7 +21,7 @@ class TaskCommanderPrivate : public QObject
     friend class TaskCommander;
 
 public:
-    explicit TaskCommanderPrivate(TaskCommander *parent);
+    explicit TaskCommanderPrivate(const QUrl &url, const QString &keyword, TaskCommander *parent);
     ~TaskCommanderPrivate();
 
 private:
@@ -36,9 +37,9 @@ private:
     volatile bool isWorking = false;
     QString taskId;
 
-    //当前所有的搜索结果和新数据缓冲区
+    //当前所有的搜索结果和新数据缓冲区，多个搜索器的结果在此去重并按相关度排序
     QReadWriteLock rwLock;
-    QList<QUrl> resultList;
+    SearchResultMerger merger;
 
     bool deleted = false;
     bool finished = false;   //保证结束信号只发一次
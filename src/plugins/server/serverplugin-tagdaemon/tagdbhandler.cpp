@@ -26,6 +26,7 @@ SERVERTAGDAEMON_BEGIN_NAMESPACE
 
 static constexpr char kTagTableFileTags[] = "file_tags";
 static constexpr char kTagTableTagProperty[] = "tag_property";
+static constexpr char kFileTagsPathIndex[] = "file_tags_filePath";
 
 TagDbHandler *TagDbHandler::instance()
 {
@@ -38,16 +39,7 @@ QVariantMap TagDbHandler::getAllTags()
     DFMBASE_NAMESPACE::FinallyUtil finally([&]() { lastErr.clear(); });
     finally.dismiss();
 
-    const auto &tagPropertyBean = handle->query<TagProperty>().toBeans();
-    if (tagPropertyBean.isEmpty()) {
-        return {};
-    }
-
-    QVariantMap tagPropertyMap;
-    for (auto &bean : tagPropertyBean)
-        tagPropertyMap.insert(bean->getTagName(), QVariant { bean->getTagColor() });
-
-    return tagPropertyMap;
+    return index.allTags();
 }
 
 QVariantMap TagDbHandler::getTagsColor(const QStringList &tags)
@@ -60,13 +52,11 @@ QVariantMap TagDbHandler::getTagsColor(const QStringList &tags)
     }
 
     // query
-    const auto &field = Expression::Field<TagProperty>;
     QVariantMap tagColorsMap;
     for (auto &tag : tags) {
-        const auto &beanList = handle->query<TagProperty>().where(field("tagName") == tag).toBeans();
-        const auto &color = beanList.isEmpty() ? "" : beanList.first()->getTagColor();
+        const auto &color = index.tagColor(tag);
         if (!color.isEmpty())
-            tagColorsMap.insert(tag, QVariant { QVariant { color } });
+            tagColorsMap.insert(tag, QVariant { color });
     }
 
     finally.dismiss();
@@ -82,15 +72,9 @@ QVariantMap TagDbHandler::getTagsByUrls(const QStringList &urlList)
     }
 
     // query
-    const auto &field = Expression::Field<FileTagInfo>;
     QVariantMap allFileTags;
     for (auto &path : urlList) {
-        const auto &beanList = handle->query<FileTagInfo>().where(field("filePath") == path).toBeans();
-
-        QStringList fileTags;
-        for (auto oneBean : beanList)
-            fileTags.append(oneBean->getTagName());
-
+        const auto &fileTags = index.tagsOfFile(path);
         if (!fileTags.isEmpty())
             allFileTags.insert(path, fileTags);
     }
@@ -139,16 +123,9 @@ QVariantMap TagDbHandler::getFilesByTag(const QStringList &tags)
     }
 
     // query
-    const auto &field = Expression::Field<FileTagInfo>;
     QVariantMap allTagFiles;
-    for (auto &tag : tags) {
-        const auto &obj = handle->query<FileTagInfo>().where(field("tagName") == tag).toBeans();
-        QStringList files;
-        for (auto tempBean : obj)
-            files.append(tempBean->getFilePath());
-
-        allTagFiles.insert(tag, QVariant { files });
-    }
+    for (auto &tag : tags)
+        allTagFiles.insert(tag, QVariant { index.filesOfTag(tag) });
 
     finally.dismiss();
     return allTagFiles;
@@ -159,25 +136,7 @@ QVariantHash TagDbHandler::getAllFileWithTags()
     DFMBASE_NAMESPACE::FinallyUtil finally([&]() { lastErr.clear(); });
     finally.dismiss();
 
-    // query
-    const auto &beans = handle->query<FileTagInfo>().toBeans();
-
-    QVariantHash fileTagsMap;
-    for (auto &bean : beans) {
-        const auto &path = bean->getFilePath();
-        if (fileTagsMap.contains(path)) {
-            QStringList list { fileTagsMap[path].toStringList() };
-            const QString &tagName { bean->getTagName() };
-            if (list.contains(tagName))
-                continue;
-            list.append(bean->getTagName());
-            fileTagsMap[path] = list;
-        } else {
-            fileTagsMap.insert(path, { bean->getTagName() });
-        }
-    }
-
-    return fileTagsMap;
+    return index.allFileTags();
 }
 
 bool TagDbHandler::addTagProperty(const QVariantMap &data)
@@ -190,13 +149,22 @@ bool TagDbHandler::addTagProperty(const QVariantMap &data)
     }
 
     // insert tagProPerty
-    auto it = data.begin();
-    for (; it != data.end(); ++it) {
-        if (!checkTag(it.key())) {
-            if (!insertTagProperty(it.key(), it.value()))
-                return false;
+    QVariantMap newTags;
+    bool ret = handle->transaction([data, &newTags, this]() -> bool {
+        for (auto it = data.begin(); it != data.end(); ++it) {
+            if (!checkTag(it.key())) {
+                if (!insertTagProperty(it.key(), it.value()))
+                    return false;
+                newTags.insert(it.key(), it.value());
+            }
         }
-    }
+        return true;
+    });
+    if (!ret)
+        return false;
+
+    for (auto it = newTags.begin(); it != newTags.end(); ++it)
+        index.setTagColor(it.key(), it.value().toString());
 
     emit newTagsAdded(data);
     finally.dismiss();
@@ -236,6 +204,11 @@ bool TagDbHandler::addTagsForFiles(const QVariantMap &data)
         return true;
     });
 
+    if (ret) {
+        for (auto dataIt = tmpData.begin(); dataIt != tmpData.end(); ++dataIt)
+            index.addFileTags(dataIt.key(), dataIt.value().toStringList());
+    }
+
     emit filesWereTagged(data);
     finally.dismiss();
     return ret;
@@ -259,6 +232,11 @@ bool TagDbHandler::removeTagsOfFiles(const QVariantMap &data)
         return true;
     });
 
+    if (ret) {
+        for (auto it = data.begin(); it != data.end(); ++it)
+            index.removeFileTags(it.key(), it.value().toStringList());
+    }
+
     emit filesUntagged(data);
     finally.dismiss();
     return ret;
@@ -273,18 +251,22 @@ bool TagDbHandler::deleteTags(const QStringList &tags)
         return false;
     }
 
-    const auto &fieldOne = Expression::Field<TagProperty>;
-    const auto &fieldTwo = Expression::Field<FileTagInfo>;
+    bool ret = handle->transaction([tags, this]() -> bool {
+        const auto &fieldOne = Expression::Field<TagProperty>;
+        const auto &fieldTwo = Expression::Field<FileTagInfo>;
+        for (const auto &tag : tags) {
+            if (!handle->remove<TagProperty>(fieldOne("tagName") == tag))
+                return false;
+            if (!handle->remove<FileTagInfo>(fieldTwo("tagName") == tag))
+                return false;
+        }
+        return true;
+    });
+    if (!ret)
+        return ret;
 
-    bool ret = true;
-    for (const auto &tag : tags) {
-        ret = handle->remove<TagProperty>(fieldOne("tagName") == tag);
-        if (!ret)
-            return ret;
-        ret = handle->remove<FileTagInfo>(fieldTwo("tagName") == tag);
-        if (!ret)
-            return ret;
-    }
+    for (const auto &tag : tags)
+        index.removeTag(tag);
 
     emit tagsDeleted(tags);
     finally.dismiss();
@@ -300,11 +282,19 @@ bool TagDbHandler::deleteFiles(const QStringList &urls)
         return false;
     }
 
-    auto field = Expression::Field<FileTagInfo>;
-    for (const auto &url : urls) {
-        if (!handle->remove<FileTagInfo>(field("filePath") == url))
-            return false;
-    }
+    bool ret = handle->transaction([urls, this]() -> bool {
+        auto field = Expression::Field<FileTagInfo>;
+        for (const auto &url : urls) {
+            if (!handle->remove<FileTagInfo>(field("filePath") == url))
+                return false;
+        }
+        return true;
+    });
+    if (!ret)
+        return false;
+
+    for (const auto &url : urls)
+        index.removeFile(url);
 
     finally.dismiss();
     return true;
@@ -319,13 +309,18 @@ bool TagDbHandler::changeTagColors(const QVariantMap &data)
         return false;
     }
 
-    auto it = data.begin();
-    bool ret = true;
-    for (; it != data.end(); ++it) {
-        ret = changeTagColor(it.key(), it.value().toString());
-        if (!ret)
-            return ret;
-    }
+    bool ret = handle->transaction([data, this]() -> bool {
+        for (auto it = data.begin(); it != data.end(); ++it) {
+            if (!changeTagColor(it.key(), it.value().toString()))
+                return false;
+        }
+        return true;
+    });
+    if (!ret)
+        return ret;
+
+    for (auto it = data.begin(); it != data.end(); ++it)
+        index.setTagColor(it.key(), it.value().toString());
 
     emit tagsColorChanged(data);
 
@@ -346,9 +341,10 @@ bool TagDbHandler::changeTagNamesWithFiles(const QVariantMap &data)
     QVariantMap updatedData;
     bool ret = true;
     for (; it != data.end(); ++it) {
-        if (changeTagNameWithFile(it.key(), it.value().toString()))
+        if (changeTagNameWithFile(it.key(), it.value().toString())) {
+            index.renameTag(it.key(), it.value().toString());
             updatedData.insert(it.key(), it.value());
-        else
+        } else
             ret = false;
     }
 
@@ -370,10 +366,45 @@ bool TagDbHandler::changeFilePaths(const QVariantMap &data)
         return false;
     }
 
-    auto it = data.begin();
-    for (; it != data.end(); ++it)
-        if (!changeFilePath(it.key(), it.value().toString()))
-            return false;
+    // a moved directory takes the tags of all its descendants with it
+    QVariantMap oldFileTags;
+    for (auto it = data.begin(); it != data.end(); ++it) {
+        const auto &tags = index.tagsOfFile(it.key());
+        if (!tags.isEmpty())
+            oldFileTags.insert(it.key(), tags);
+        oldFileTags.unite(index.tagsOfFilesUnder(it.key()));
+    }
+    if (oldFileTags.isEmpty()) {
+        finally.dismiss();
+        return true;
+    }
+
+    bool ret = handle->transaction([data, this]() -> bool {
+        for (auto it = data.begin(); it != data.end(); ++it) {
+            if (!changeFilePath(it.key(), it.value().toString()))
+                return false;
+        }
+        return true;
+    });
+    if (!ret)
+        return false;
+
+    QVariantMap newFileTags;
+    for (auto it = data.begin(); it != data.end(); ++it) {
+        const QString &oldPath = it.key();
+        const QString &newPath = it.value().toString();
+        index.renameFile(oldPath, newPath);
+        index.renameDir(oldPath, newPath);
+
+        const auto &tags = index.tagsOfFile(newPath);
+        if (!tags.isEmpty())
+            newFileTags.insert(newPath, tags);
+        newFileTags.unite(index.tagsOfFilesUnder(newPath));
+    }
+
+    // there is no path changed signal, clients follow the untag/tag pair
+    emit filesUntagged(oldFileTags);
+    emit filesWereTagged(newFileTags);
 
     finally.dismiss();
     return true;
@@ -417,6 +448,9 @@ void TagDbHandler::initialize()
 
     if (!createTable(kTagTableTagProperty))
         fmWarning() << "Create table failed:" << kTagTableFileTags;
+
+    // tags are read far more often than written, answer queries from memory
+    index.load(handle->query<TagProperty>().toBeans(), handle->query<FileTagInfo>().toBeans());
 }
 
 bool TagDbHandler::createTable(const QString &tableName)
@@ -428,6 +462,10 @@ bool TagDbHandler::createTable(const QString &tableName)
                 SqliteConstraint::primary("fileIndex"),
                 SqliteConstraint::autoIncreament("fileIndex"),
                 SqliteConstraint::unique("fileIndex"));
+
+        // tags are looked up by file path far more often than they are written
+        if (ret && !handle->createIndex<FileTagInfo>(kFileTagsPathIndex, { "filePath" }))
+            fmWarning() << "Create index failed:" << kFileTagsPathIndex;
     }
 
     if (SqliteHelper::tableName<TagProperty>() == tableName) {
@@ -443,7 +481,7 @@ bool TagDbHandler::createTable(const QString &tableName)
 
 bool TagDbHandler::checkTag(const QString &tag)
 {
-    return handle->query<TagProperty>().where(Expression::Field<TagProperty>("tagName") == tag).toBeans().size() > 0;
+    return index.hasTag(tag);
 }
 
 bool TagDbHandler::insertTagProperty(const QString &name, const QVariant &value)
@@ -589,9 +627,22 @@ bool TagDbHandler::changeFilePath(const QString &oldPath, const QString &newPath
         return false;
     }
 
-    const auto &field = Expression::Field<FileTagInfo>;
-    if (!handle->update<TagProperty>(field("filePath") = newPath, field("filePath") == oldPath)) {
-        lastErr = QString("Change file path failed! oldPath: %1, newPath: %2").arg(oldPath).arg(oldPath);
+    if (!handle->excutePrepared(QString("UPDATE %1 SET filePath=? WHERE filePath=?;").arg(kTagTableFileTags),
+                                { newPath, oldPath })) {
+        lastErr = QString("Change file path failed! oldPath: %1, newPath: %2").arg(oldPath).arg(newPath);
+        return false;
+    }
+
+    // rewrite the descendants with one indexed range scan: "old/" <= filePath < "old0"
+    const QString &oldPrefix = oldPath.endsWith('/') ? oldPath : oldPath + '/';
+    const QString &newPrefix = newPath.endsWith('/') ? newPath : newPath + '/';
+    QString upperBound = oldPrefix;
+    upperBound[upperBound.size() - 1] = QChar('/' + 1);
+    if (!handle->excutePrepared(QString("UPDATE %1 SET filePath=? || substr(filePath, ?) "
+                                        "WHERE filePath>=? AND filePath<?;")
+                                        .arg(kTagTableFileTags),
+                                { newPrefix, oldPrefix.toUcs4().size() + 1, oldPrefix, upperBound })) {
+        lastErr = QString("Change descendant paths failed! oldPath: %1, newPath: %2").arg(oldPath).arg(newPath);
         return false;
     }
 
@@ -6,6 +6,7 @@
 #define TAGDBHANDLER_H
 
 #include "serverplugin_tagdaemon_global.h"
+#include "tagindex.h"
 
 #include <dfm-base/base/db/sqlitehandle.h>
 
@@ -79,6 +80,7 @@ Q_SIGNALS:
 
 private:
     QScopedPointer<DFMBASE_NAMESPACE::SqliteHandle> handle;
+    TagIndex index;
     QString lastErr;
 };
 
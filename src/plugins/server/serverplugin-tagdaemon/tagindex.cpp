@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "tagindex.h"
+
+#include "beans/filetaginfo.h"
+#include "beans/tagproperty.h"
+
+SERVERTAGDAEMON_BEGIN_NAMESPACE
+
+void TagIndex::load(const QList<QSharedPointer<TagProperty>> &properties,
+                    const QList<QSharedPointer<FileTagInfo>> &fileTagInfos)
+{
+    clear();
+
+    for (const auto &bean : properties) {
+        if (!tagColors.contains(bean->getTagName()))
+            tagColors.insert(bean->getTagName(), bean->getTagColor());
+    }
+
+    for (const auto &bean : fileTagInfos)
+        addFileTags(bean->getFilePath(), { bean->getTagName() });
+}
+
+void TagIndex::clear()
+{
+    tagColors.clear();
+    fileTags.clear();
+    tagFiles.clear();
+}
+
+QVariantMap TagIndex::allTags() const
+{
+    QVariantMap tags;
+    for (auto it = tagColors.cbegin(); it != tagColors.cend(); ++it)
+        tags.insert(it.key(), QVariant { it.value() });
+
+    return tags;
+}
+
+QString TagIndex::tagColor(const QString &tag) const
+{
+    return tagColors.value(tag);
+}
+
+bool TagIndex::hasTag(const QString &tag) const
+{
+    return tagColors.contains(tag);
+}
+
+void TagIndex::setTagColor(const QString &tag, const QString &color)
+{
+    tagColors.insert(tag, color);
+}
+
+void TagIndex::removeTag(const QString &tag)
+{
+    tagColors.remove(tag);
+
+    const auto &paths = tagFiles.take(tag);
+    for (const auto &path : paths) {
+        auto it = fileTags.find(path);
+        if (it == fileTags.end())
+            continue;
+        it->removeAll(tag);
+        if (it->isEmpty())
+            fileTags.erase(it);
+    }
+}
+
+void TagIndex::renameTag(const QString &tag, const QString &newName)
+{
+    if (tag == newName)
+        return;
+
+    if (tagColors.contains(tag))
+        tagColors.insert(newName, tagColors.take(tag));
+
+    const auto &paths = tagFiles.take(tag);
+    for (const auto &path : paths) {
+        auto it = fileTags.find(path);
+        if (it == fileTags.end())
+            continue;
+        it->removeAll(tag);
+        if (!it->contains(newName))
+            it->append(newName);
+    }
+    if (!paths.isEmpty())
+        tagFiles[newName].unite(paths);
+}
+
+QStringList TagIndex::tagsOfFile(const QString &path) const
+{
+    return fileTags.value(path);
+}
+
+QStringList TagIndex::filesOfTag(const QString &tag) const
+{
+    return tagFiles.value(tag).values();
+}
+
+QVariantMap TagIndex::tagsOfFilesUnder(const QString &dirPath) const
+{
+    QString prefix { dirPath };
+    if (!prefix.endsWith('/'))
+        prefix.append('/');
+
+    QVariantMap files;
+    for (auto it = fileTags.lowerBound(prefix); it != fileTags.cend() && it.key().startsWith(prefix); ++it)
+        files.insert(it.key(), it.value());
+
+    return files;
+}
+
+QVariantHash TagIndex::allFileTags() const
+{
+    QVariantHash files;
+    files.reserve(fileTags.size());
+    for (auto it = fileTags.cbegin(); it != fileTags.cend(); ++it)
+        files.insert(it.key(), it.value());
+
+    return files;
+}
+
+void TagIndex::addFileTags(const QString &path, const QStringList &tags)
+{
+    if (path.isEmpty() || tags.isEmpty())
+        return;
+
+    auto &pathTags = fileTags[path];
+    for (const auto &tag : tags) {
+        if (pathTags.contains(tag))
+            continue;
+        pathTags.append(tag);
+        tagFiles[tag].insert(path);
+    }
+}
+
+void TagIndex::removeFileTags(const QString &path, const QStringList &tags)
+{
+    auto it = fileTags.find(path);
+    if (it == fileTags.end())
+        return;
+
+    for (const auto &tag : tags) {
+        it->removeAll(tag);
+        auto tagIt = tagFiles.find(tag);
+        if (tagIt != tagFiles.end()) {
+            tagIt->remove(path);
+            if (tagIt->isEmpty())
+                tagFiles.erase(tagIt);
+        }
+    }
+
+    if (it->isEmpty())
+        fileTags.erase(it);
+}
+
+void TagIndex::removeFile(const QString &path)
+{
+    removeFileTags(path, fileTags.value(path));
+}
+
+void TagIndex::renameFile(const QString &oldPath, const QString &newPath)
+{
+    if (oldPath == newPath)
+        return;
+
+    const QStringList tags { fileTags.value(oldPath) };
+    removeFileTags(oldPath, tags);
+    addFileTags(newPath, tags);
+}
+
+void TagIndex::renameDir(const QString &oldPath, const QString &newPath)
+{
+    QString oldPrefix { oldPath };
+    if (!oldPrefix.endsWith('/'))
+        oldPrefix.append('/');
+    QString newPrefix { newPath };
+    if (!newPrefix.endsWith('/'))
+        newPrefix.append('/');
+    if (oldPrefix == newPrefix)
+        return;
+
+    QStringList descendants;
+    for (auto it = fileTags.lowerBound(oldPrefix); it != fileTags.cend() && it.key().startsWith(oldPrefix); ++it)
+        descendants.append(it.key());
+
+    for (const auto &path : descendants)
+        renameFile(path, newPrefix + path.mid(oldPrefix.size()));
+}
+
+SERVERTAGDAEMON_END_NAMESPACE
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TAGINDEX_H
+#define TAGINDEX_H
+
+#include "serverplugin_tagdaemon_global.h"
+
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QVariant>
+#include <QSharedPointer>
+
+SERVERTAGDAEMON_BEGIN_NAMESPACE
+
+class FileTagInfo;
+class TagProperty;
+
+/*!
+ * \brief The TagIndex class is the in-memory copy of the tag database.
+ * It is loaded once and then kept in step with the database by TagDbHandler
+ * after every successful write, all the queries are answered from here.
+ * File paths are kept sorted so that the files under a directory are one range.
+ * Not thread safe, it lives in the tag DBus worker thread like TagDbHandler.
+ */
+class TagIndex
+{
+public:
+    void load(const QList<QSharedPointer<TagProperty>> &properties,
+              const QList<QSharedPointer<FileTagInfo>> &fileTags);
+    void clear();
+
+    // tags
+    QVariantMap allTags() const;
+    QString tagColor(const QString &tag) const;
+    bool hasTag(const QString &tag) const;
+    void setTagColor(const QString &tag, const QString &color);
+    void removeTag(const QString &tag);
+    void renameTag(const QString &tag, const QString &newName);
+
+    // files
+    QStringList tagsOfFile(const QString &path) const;
+    QStringList filesOfTag(const QString &tag) const;
+    QVariantMap tagsOfFilesUnder(const QString &dirPath) const;
+    QVariantHash allFileTags() const;
+    void addFileTags(const QString &path, const QStringList &tags);
+    void removeFileTags(const QString &path, const QStringList &tags);
+    void removeFile(const QString &path);
+    void renameFile(const QString &oldPath, const QString &newPath);
+    void renameDir(const QString &oldPath, const QString &newPath);
+
+private:
+    QMap<QString, QString> tagColors;   // tag--color
+    QMap<QString, QStringList> fileTags;   // path--tags, sorted by path
+    QHash<QString, QSet<QString>> tagFiles;   // tag--paths
+};
+
+SERVERTAGDAEMON_END_NAMESPACE
+
+#endif   // TAGINDEX_H
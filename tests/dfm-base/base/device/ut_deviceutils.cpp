@@ -8,6 +8,7 @@
 #include <dfm-base/base/application/settings.h>
 #include <dfm-base/base/device/deviceutils.h>
 #include <dfm-base/base/device/deviceproxymanager.h>
+#include <dfm-base/base/device/private/mounttablecache.h>
 #include <dfm-base/base/schemefactory.h>
 #include <dfm-base/file/local/localfilewatcher.h>
 #include <dfm-base/file/local/localdiriterator.h>
@@ -15,6 +16,8 @@
 
 #include <QUrl>
 #include <QSet>
+#include <QFile>
+#include <QTemporaryDir>
 
 #include <gtest/gtest.h>
 
@@ -50,10 +53,88 @@ TEST_F(UT_DeviceUtils, bug_139803_UseLibmount)
         libmnt_table *table { NULL };
         return table;
     });
-    DeviceUtils::getMountInfo("/dev/sr0");
+    MountTableCache cache;
+    cache.targetOfSource("/dev/sr0");
     EXPECT_TRUE(useLibMountInterfaces);
 }
 
+TEST_F(UT_DeviceUtils, MountTableCache)
+{
+    MountTableCache cache;
+    cache.load({ { "/dev/sda1", "/", "", "ext4" },
+                 { "/dev/sda2", "/home", "", "ext4" },
+                 { "/dev/sdb1", "/media/user/disk", "", "vfat" },
+                 { "dlnfs", "/home/user/Desktop", "", "fuse.dlnfs" },
+                 { "/dev/sdc1", "/media/user/disk", "", "ntfs" } });
+
+    EXPECT_EQ(cache.longestMountRoot("/etc/fstab"), QString("/"));
+    EXPECT_EQ(cache.longestMountRoot("/home"), QString("/home/"));
+    EXPECT_EQ(cache.longestMountRoot("/home/user/a.txt"), QString("/home/"));
+    EXPECT_EQ(cache.longestMountRoot("/homer/a.txt"), QString("/"));
+    EXPECT_EQ(cache.longestMountRoot("/media/user/disk/a//b"), QString("/media/user/disk/"));
+    EXPECT_EQ(cache.longestMountRoot("/media/user"), QString("/"));
+
+    // the latest mount over the same target wins.
+    EXPECT_EQ(cache.mountSource("/media/user/disk/a"), QString("/dev/sdc1"));
+    EXPECT_EQ(cache.mountSource("/home/user/b"), QString("/dev/sda2"));
+
+    EXPECT_EQ(cache.targetOfSource("/dev/sda2"), QString("/home"));
+    EXPECT_TRUE(cache.targetOfSource("/dev/sdz").isEmpty());
+    EXPECT_EQ(cache.sourceOfTarget("/home"), QString("/dev/sda2"));
+    EXPECT_EQ(cache.sourceOfTarget("/home/"), QString("/dev/sda2"));
+    EXPECT_TRUE(cache.sourceOfTarget("/home/user").isEmpty());
+
+    EXPECT_EQ(cache.dlnfsMountRoots(), QStringList { "/home/user/Desktop/" });
+}
+
+TEST_F(UT_DeviceUtils, MountTableCacheCanonicalSource)
+{
+    // the device in /dev/mapper is a symlink to /dev/dm-N
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString &device = dir.filePath("dm-0");
+    const QString &mapper = dir.filePath("vg-root");
+    QFile file(device);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.close();
+    ASSERT_TRUE(QFile::link(device, mapper));
+
+    MountTableCache cache;
+    cache.load({ { mapper, "/data", "", "ext4" } });
+    EXPECT_EQ(cache.targetOfSource(mapper), QString("/data"));
+    EXPECT_EQ(cache.targetOfSource(device), QString("/data"));
+
+    cache.load({ { device, "/data", "", "ext4" } });
+    EXPECT_EQ(cache.targetOfSource(mapper), QString("/data"));
+}
+
+TEST_F(UT_DeviceUtils, MountTableCacheRetryReload)
+{
+    int parsed = 0;
+    stub.set_lamda(&mnt_table_parse_mtab, [&parsed] {
+        __DBG_STUB_INVOKE__
+        ++parsed;
+        return -1;
+    });
+    MountTableCache cache;
+    cache.load({ { "/dev/sda1", "/", "", "ext4" } });
+    stub.set_lamda(&MountTableCache::tableChanged, [] {
+        __DBG_STUB_INVOKE__
+        return true;
+    });
+    cache.mountSource("/home");
+    EXPECT_EQ(parsed, 1);
+
+    // the change is consumed, but the table is parsed again until it succeeds
+    stub.set_lamda(&MountTableCache::tableChanged, [] {
+        __DBG_STUB_INVOKE__
+        return false;
+    });
+    cache.mountSource("/home");
+    EXPECT_EQ(parsed, 2);
+    EXPECT_EQ(cache.mountSource("/home"), QString("/dev/sda1"));
+}
+
 TEST_F(UT_DeviceUtils, GetBlockDeviceId)
 {
     EXPECT_EQ("/org/freedesktop/UDisks2/block_devices/sdb1", DeviceUtils::getBlockDeviceId("/dev/sdb1"));
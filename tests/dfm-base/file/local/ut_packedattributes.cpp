@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-base/file/local/private/packedattributes.h>
+#include <dfm-base/interfaces/fileinfo.h>
+
+#include <gtest/gtest.h>
+
+DFMBASE_USE_NAMESPACE
+
+using AttrID = FileInfo::FileInfoAttributeID;
+
+TEST(UT_PackedAttributes, hotAndRare)
+{
+    EXPECT_GE(PackedAttributesData::slotOf(static_cast<int>(AttrID::kStandardSize)), 0);
+    EXPECT_EQ(PackedAttributesData::slotOf(static_cast<int>(AttrID::kTrashOrigPath)), -1);
+    EXPECT_EQ(PackedAttributesData::slotOf(-1), -1);
+    EXPECT_EQ(PackedAttributesData::slotOf(5000), -1);
+
+    PackedAttributes<AttrID> attrs;
+    EXPECT_TRUE(attrs.isEmpty());
+    EXPECT_FALSE(attrs.value(AttrID::kStandardSize).isValid());
+
+    attrs.insert(AttrID::kStandardSize, qint64(1024));
+    attrs.insert(AttrID::kStandardName, QString("a.txt"));
+    attrs.insert(AttrID::kTrashOrigPath, QString("/tmp/a.txt"));
+    EXPECT_EQ(attrs.size(), 3);
+    EXPECT_TRUE(attrs.contains(AttrID::kStandardSize));
+    EXPECT_TRUE(attrs.contains(AttrID::kTrashOrigPath));
+    EXPECT_FALSE(attrs.contains(AttrID::kStandardIsDir));
+    EXPECT_EQ(attrs.value(AttrID::kStandardSize).toLongLong(), 1024);
+    EXPECT_EQ(attrs.value(AttrID::kStandardName).toString(), QString("a.txt"));
+    EXPECT_EQ(attrs.value(AttrID::kTrashOrigPath).toString(), QString("/tmp/a.txt"));
+
+    auto keys = attrs.keys();
+    EXPECT_EQ(keys.size(), 3);
+    EXPECT_TRUE(keys.contains(AttrID::kTrashOrigPath));
+
+    attrs.remove(AttrID::kStandardSize);
+    attrs.remove(AttrID::kTrashOrigPath);
+    EXPECT_FALSE(attrs.contains(AttrID::kStandardSize));
+    EXPECT_FALSE(attrs.contains(AttrID::kTrashOrigPath));
+    EXPECT_EQ(attrs.size(), 1);
+
+    attrs.clear();
+    EXPECT_TRUE(attrs.isEmpty());
+}
+
+TEST(UT_PackedAttributes, update)
+{
+    PackedAttributes<AttrID> attrs;
+    EXPECT_FALSE(attrs.update(AttrID::kStandardSize, QVariant()));
+    EXPECT_TRUE(attrs.update(AttrID::kStandardSize, qint64(1)));
+    EXPECT_FALSE(attrs.update(AttrID::kStandardSize, qint64(1)));
+    EXPECT_TRUE(attrs.update(AttrID::kStandardSize, qint64(2)));
+    EXPECT_TRUE(attrs.update(AttrID::kGvfsBackend, QString("smb")));
+    EXPECT_FALSE(attrs.update(AttrID::kGvfsBackend, QString("smb")));
+    EXPECT_EQ(attrs.value(AttrID::kStandardSize).toLongLong(), 2);
+}
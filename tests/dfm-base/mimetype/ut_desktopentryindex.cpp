@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-base/mimetype/desktopentryindex.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+
+#include <gtest/gtest.h>
+
+DFMBASE_USE_NAMESPACE
+
+class UT_DesktopEntryIndex : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        folders = { dir.filePath("applications"), dir.filePath("local/applications") };
+        for (const QString &folder : folders)
+            QDir().mkpath(folder);
+        cacheFile = dir.filePath("cache/DesktopEntries.cache");
+    }
+
+    QString writeDesktop(const QString &path, const QString &name, const QString &mimeTypes, bool noDisplay = false)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        file.write(QString("[Desktop Entry]\nType=Application\nName=%1\nExec=%1 %U\nMimeType=%2\n%3")
+                           .arg(name, mimeTypes, noDisplay ? "NoDisplay=true\n" : "")
+                           .toUtf8());
+        return path;
+    }
+
+    QTemporaryDir dir;
+    QStringList folders;
+    QString cacheFile;
+};
+
+TEST_F(UT_DesktopEntryIndex, update)
+{
+    const QString &text = writeDesktop(folders.at(0) + "/text.desktop", "text", "text/plain;");
+    const QString &image = writeDesktop(folders.at(0) + "/image.desktop", "image", "image/png;text/plain;");
+    writeDesktop(folders.at(0) + "/hidden.desktop", "hidden", "text/plain;", true);
+    const QString &sub = writeDesktop(folders.at(1) + "/kde4/sub.desktop", "sub", "video/mp4;");
+
+    DesktopEntryIndex index(folders, cacheFile);
+    EXPECT_TRUE(index.update({}));
+    EXPECT_EQ(4, index.parsedCount());
+    EXPECT_EQ(3, index.desktopFiles().size());
+    EXPECT_EQ(3, index.desktopObjs().size());
+    EXPECT_EQ("text", index.desktopFile(text).desktopLocalName());
+    EXPECT_EQ(2, index.mimeApps().value("text/plain").size());
+    EXPECT_EQ(QStringList({ sub }), index.mimeApps().value("video/mp4"));
+    EXPECT_EQ(sub, index.pathOfId("kde4-sub.desktop"));
+    EXPECT_TRUE(QFile::exists(cacheFile));
+
+    // nothing is changed
+    EXPECT_FALSE(index.update({}));
+    EXPECT_EQ(0, index.parsedCount());
+
+    // only the file changed is read again
+    writeDesktop(image, "image2", "image/png;");
+    EXPECT_TRUE(index.update({}));
+    EXPECT_EQ(1, index.parsedCount());
+    EXPECT_EQ(QStringList({ text }), index.mimeApps().value("text/plain"));
+    EXPECT_EQ("image2", index.desktopFile(image).desktopLocalName());
+
+    // the file removed
+    QFile::remove(text);
+    EXPECT_TRUE(index.update({}));
+    EXPECT_EQ(0, index.parsedCount());
+    EXPECT_FALSE(index.contains(text));
+    EXPECT_FALSE(index.mimeApps().contains("text/plain"));
+
+    // the mime types of dde
+    EXPECT_TRUE(index.update({ { "image.desktop", { "text/plain" } } }));
+    EXPECT_EQ(QStringList({ image }), index.mimeApps().value("text/plain"));
+}
+
+TEST_F(UT_DesktopEntryIndex, sameIdInFolders)
+{
+    const QString &first = writeDesktop(folders.at(0) + "/app.desktop", "app", "text/plain;");
+    writeDesktop(folders.at(1) + "/app.desktop", "app", "text/plain;");
+    const QString &only = writeDesktop(folders.at(1) + "/only.desktop", "only", "text/plain;");
+
+    DesktopEntryIndex index(folders, cacheFile);
+    index.update({});
+    EXPECT_TRUE(index.contains(first));
+    // resolved by GIO
+    EXPECT_TRUE(index.pathOfId("app.desktop").isEmpty());
+    EXPECT_EQ(only, index.pathOfId("only.desktop"));
+}
+
+TEST_F(UT_DesktopEntryIndex, cache)
+{
+    const QString &text = writeDesktop(folders.at(0) + "/text.desktop", "text", "text/plain;");
+    {
+        DesktopEntryIndex index(folders, cacheFile);
+        index.update({ { "text.desktop", { "text/html" } } });
+    }
+
+    // the entries are loaded from the cache of last process
+    DesktopEntryIndex index(folders, cacheFile);
+    EXPECT_TRUE(index.update({ { "text.desktop", { "text/html" } } }));
+    EXPECT_EQ(0, index.parsedCount());
+    EXPECT_EQ("text", index.desktopFile(text).desktopLocalName());
+    EXPECT_EQ(QStringList({ text }), index.mimeApps().value("text/html"));
+
+    // the cache of other folders is not used
+    DesktopEntryIndex other({ folders.at(0) }, cacheFile);
+    other.update({});
+    EXPECT_EQ(1, other.parsedCount());
+
+    // the broken cache is ignored
+    QFile file(cacheFile);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    file.resize(file.size() / 2);
+    file.close();
+    DesktopEntryIndex broken({ folders.at(0) }, cacheFile);
+    broken.update({});
+    EXPECT_EQ(1, broken.parsedCount());
+}
+
+TEST_F(UT_DesktopEntryIndex, largeTree)
+{
+    const int count = 2000;
+    for (int i = 0; i < count; ++i)
+        writeDesktop(QString("%1/app%2.desktop").arg(folders.at(i % 2)).arg(i), QString("app%1").arg(i),
+                     QString("text/plain;application/x-test%1;").arg(i % 50));
+
+    DesktopEntryIndex cold(folders, cacheFile);
+    cold.update({});
+    EXPECT_EQ(count, cold.parsedCount());
+    EXPECT_EQ(count, cold.mimeApps().value("text/plain").size());
+
+    // a package installed
+    writeDesktop(folders.at(0) + "/installed.desktop", "installed", "text/plain;");
+    EXPECT_TRUE(cold.update({}));
+    EXPECT_EQ(1, cold.parsedCount());
+    EXPECT_EQ(count + 1, cold.mimeApps().value("text/plain").size());
+
+    // the next process starts from the cache
+    DesktopEntryIndex warm(folders, cacheFile);
+    EXPECT_TRUE(warm.update({}));
+    EXPECT_EQ(0, warm.parsedCount());
+    EXPECT_EQ(count + 1, warm.desktopFiles().size());
+}
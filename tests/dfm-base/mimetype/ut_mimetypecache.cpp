@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-base/mimetype/mimetypecache.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+DFMBASE_USE_NAMESPACE
+
+TEST(UT_MimeTypeCache, makeKey)
+{
+    MimeTypeCache::FileKey key;
+    EXPECT_FALSE(MimeTypeCache::makeKey(QString(), QMimeDatabase::MatchDefault, &key));
+    EXPECT_FALSE(MimeTypeCache::makeKey("/no/such/file", QMimeDatabase::MatchDefault, &key));
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    EXPECT_FALSE(MimeTypeCache::makeKey(dir.path(), QMimeDatabase::MatchDefault, &key));
+
+    const QString &path = dir.filePath("a.txt");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("hello");
+    file.close();
+
+    EXPECT_TRUE(MimeTypeCache::makeKey(path, QMimeDatabase::MatchDefault, &key));
+    EXPECT_EQ(key.size, 5);
+
+    EXPECT_EQ(key.fileName, QString("a.txt"));
+
+    // the extension is matched without reading the file
+    MimeTypeCache::FileKey other;
+    EXPECT_FALSE(MimeTypeCache::makeKey(path, QMimeDatabase::MatchExtension, &other));
+    EXPECT_TRUE(MimeTypeCache::makeKey(path, QMimeDatabase::MatchContent, &other));
+    EXPECT_FALSE(key == other);
+
+    // the same inode under another name
+    const QString &renamed = dir.filePath("a.png");
+    ASSERT_TRUE(QFile::rename(path, renamed));
+    EXPECT_TRUE(MimeTypeCache::makeKey(renamed, QMimeDatabase::MatchDefault, &other));
+    EXPECT_EQ(key.inode, other.inode);
+    EXPECT_FALSE(key == other);
+    ASSERT_TRUE(QFile::rename(renamed, path));
+
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write(" world");
+    file.close();
+    EXPECT_TRUE(MimeTypeCache::makeKey(path, QMimeDatabase::MatchDefault, &other));
+    EXPECT_FALSE(key == other);
+}
+
+TEST(UT_MimeTypeCache, valueAndInsert)
+{
+    MimeTypeCache cache;
+    MimeTypeCache::FileKey key;
+    key.device = 1;
+    key.inode = 2;
+    key.size = 3;
+
+    EXPECT_TRUE(cache.value(key).isEmpty());
+    EXPECT_EQ(cache.missCount(), 1);
+
+    cache.insert(key, QString());
+    EXPECT_TRUE(cache.value(key).isEmpty());
+
+    cache.insert(key, "text/plain");
+    EXPECT_EQ(cache.value(key), QString("text/plain"));
+    EXPECT_EQ(cache.hitCount(), 1);
+    EXPECT_EQ(cache.missCount(), 2);
+
+    key.mtimeSec = 1;
+    EXPECT_TRUE(cache.value(key).isEmpty());
+
+    cache.setCapacity(1);
+    MimeTypeCache::FileKey key2;
+    cache.insert(key2, "text/plain");
+    cache.insert(key, "text/html");
+    EXPECT_TRUE(cache.value(key2).isEmpty());
+    EXPECT_EQ(cache.value(key), QString("text/html"));
+
+    cache.clear();
+    EXPECT_TRUE(cache.value(key).isEmpty());
+}
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfm-base/utils/chinese2pinyin.h"
+
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+#include <QtConcurrent>
+
+#include <gtest/gtest.h>
+
+// the dict parsed as it was at runtime before the table is generated
+static QHash<uint, QString> parseDict()
+{
+    QHash<uint, QString> dict;
+    QFile file(PINYIN_DICT_FILE);
+    if (!file.open(QIODevice::ReadOnly))
+        return dict;
+
+    QByteArray content = file.readAll();
+    QTextStream stream(&content, QIODevice::ReadOnly);
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine();
+        const QStringList items = line.split(QChar(':'));
+        if (items.size() == 2)
+            dict.insert(static_cast<uint>(items[0].toInt(nullptr, 16)), items[1]);
+    }
+    return dict;
+}
+
+static QString oldChinese2Pinyin(const QHash<uint, QString> &dict, const QString &words)
+{
+    QString result;
+    for (int i = 0; i < words.length(); ++i) {
+        auto it = dict.find(words.at(i).unicode());
+        if (it != dict.end())
+            result.append(it.value());
+        else
+            result.append(words.at(i));
+    }
+    return result;
+}
+
+TEST(UT_Chinese2Pinyin, testSameAsDict)
+{
+    const QHash<uint, QString> &dict = parseDict();
+    ASSERT_EQ(25333, dict.size());
+
+    // every character in BMP
+    for (uint code = 1; code <= 0xffff; ++code) {
+        const QString &word = QString(QChar(static_cast<ushort>(code)));
+        ASSERT_EQ(oldChinese2Pinyin(dict, word), Pinyin::Chinese2Pinyin(word)) << code;
+    }
+
+    const QString &words = QString::fromUtf8("文件管理器 File Manager 2023.txt");
+    EXPECT_EQ(oldChinese2Pinyin(dict, words), Pinyin::Chinese2Pinyin(words));
+    EXPECT_EQ("wen2jian4guan3li3qi4 File Manager 2023.txt", Pinyin::Chinese2Pinyin(words));
+    EXPECT_EQ("", Pinyin::Chinese2Pinyin(""));
+}
+
+TEST(UT_Chinese2Pinyin, testToPinyinKeys)
+{
+    const QStringList &words { QString::fromUtf8("文档"), "Documents", "", QString::fromUtf8("图片-1"),
+                               QString::fromUtf8("音乐") };
+    const QStringList &keys = Pinyin::toPinyinKeys(words);
+    ASSERT_EQ(words.size(), keys.size());
+    for (int i = 0; i < words.size(); ++i)
+        EXPECT_EQ(Pinyin::Chinese2Pinyin(words.at(i)), keys.at(i));
+    EXPECT_EQ("wen2dang4", keys.first());
+    EXPECT_EQ("tu2pian4-1", keys.at(3));
+}
+
+TEST(UT_Chinese2Pinyin, testConcurrent)
+{
+    QStringList words;
+    for (int i = 0; i < 10000; ++i)
+        words.append(QString::fromUtf8("文件%1管理器").arg(i));
+
+    // the table is read only, the threads do not race on it
+    const QStringList &keys = QtConcurrent::blockingMapped(words, [](const QString &word) {
+        return Pinyin::Chinese2Pinyin(word);
+    });
+    ASSERT_EQ(words.size(), keys.size());
+    for (int i = 0; i < words.size(); ++i)
+        EXPECT_EQ(QString("wen2jian4%1guan3li3qi4").arg(i), keys.at(i));
+}
+
+TEST(UT_Chinese2Pinyin, testAllWords)
+{
+    const QHash<uint, QString> &dict = parseDict();
+    QStringList words;
+    for (auto it = dict.cbegin(); it != dict.cend(); ++it)
+        words.append(QString(QChar(static_cast<ushort>(it.key()))) + QString::fromUtf8("文件.txt"));
+
+    // the batch gives the same keys as one by one
+    const QStringList &keys = Pinyin::toPinyinKeys(words);
+    ASSERT_EQ(words.size(), keys.size());
+    for (int i = 0; i < words.size(); ++i)
+        EXPECT_EQ(Pinyin::Chinese2Pinyin(words.at(i)), keys.at(i));
+}
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-base/utils/elidetextlayout.h>
+
+#include <QTextDocument>
+#include <QTextCursor>
+#include <QImage>
+#include <QPainter>
+
+#include <gtest/gtest.h>
+
+DFMBASE_USE_NAMESPACE
+
+TEST(UT_ElideTextLayout, layout_cached)
+{
+    ElideTextLayout::clearLayoutCache();
+    const QString text("a long long long long long long long file name.txt");
+
+    ElideTextLayout first(text);
+    first.setAttribute(ElideTextLayout::kLineHeight, 20);
+    QStringList firstLines;
+    auto firstRects = first.layout(QRectF(0, 0, 80, 40), Qt::ElideMiddle, nullptr, Qt::NoBrush, &firstLines);
+    ASSERT_EQ(firstRects.size(), 2);
+    EXPECT_EQ(firstLines.size(), 2);
+
+    // same text and attributes at another position.
+    ElideTextLayout second(text);
+    second.setAttribute(ElideTextLayout::kLineHeight, 20);
+    QStringList secondLines;
+    auto secondRects = second.layout(QRectF(10, 30, 80, 40), Qt::ElideMiddle, nullptr, Qt::NoBrush, &secondLines);
+    ASSERT_EQ(secondRects.size(), firstRects.size());
+    EXPECT_EQ(secondLines, firstLines);
+    for (int i = 0; i < firstRects.size(); ++i)
+        EXPECT_EQ(secondRects.at(i), firstRects.at(i).translated(10, 30));
+
+    // draw from the cache.
+    QImage img(100, 100, QImage::Format_ARGB32);
+    QPainter pa(&img);
+    ElideTextLayout third(text);
+    third.setAttribute(ElideTextLayout::kLineHeight, 20);
+    EXPECT_EQ(third.layout(QRectF(0, 0, 80, 40), Qt::ElideMiddle, &pa, QBrush(Qt::red)), firstRects);
+}
+
+TEST(UT_ElideTextLayout, layout_decorated)
+{
+    ElideTextLayout lay("file.txt");
+    QTextCursor cursor(lay.documentHandle());
+    cursor.setPosition(0);
+    cursor.insertText(QString(QChar::ObjectReplacementCharacter));
+
+    QStringList lines;
+    auto rects = lay.layout(QRectF(0, 0, 200, 40), Qt::ElideMiddle, nullptr, Qt::NoBrush, &lines);
+    ASSERT_EQ(rects.size(), 1);
+    EXPECT_TRUE(lines.first().startsWith(QChar::ObjectReplacementCharacter));
+}
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-base/utils/iconpixmapcache.h>
+
+#include "stubext.h"
+
+#include <gtest/gtest.h>
+
+DFMBASE_USE_NAMESPACE
+
+TEST(UT_IconPixmapCache, pixmap)
+{
+    IconPixmapCache cache;
+    EXPECT_TRUE(cache.pixmap(QIcon(), QSize(16, 16), 1.0).isNull());
+
+    QPixmap src(64, 64);
+    src.fill(Qt::red);
+    QIcon icon(src);
+    EXPECT_TRUE(cache.pixmap(icon, QSize(0, 16), 1.0).isNull());
+
+    int rendered = 0;
+    stub_ext::StubExt stub;
+    typedef QPixmap (QIcon::*PixmapFunc)(const QSize &, QIcon::Mode, QIcon::State) const;
+    stub.set_lamda(static_cast<PixmapFunc>(&QIcon::pixmap), [&rendered, src]() {
+        __DBG_STUB_INVOKE__
+        ++rendered;
+        return src.scaled(32, 32);
+    });
+
+    QPixmap px = cache.pixmap(icon, QSize(32, 32), 2.0);
+    EXPECT_EQ(rendered, 1);
+    EXPECT_EQ(px.devicePixelRatio(), 2.0);
+
+    // same icon, size and ratio are served from the cache.
+    EXPECT_EQ(cache.pixmap(icon, QSize(32, 32), 2.0).cacheKey(), px.cacheKey());
+    EXPECT_EQ(rendered, 1);
+
+    cache.pixmap(icon, QSize(32, 32), 1.0);
+    EXPECT_EQ(rendered, 2);
+    cache.pixmap(icon, QSize(32, 32), 2.0, QIcon::Disabled);
+    EXPECT_EQ(rendered, 3);
+
+    cache.clear();
+    cache.pixmap(icon, QSize(32, 32), 2.0);
+    EXPECT_EQ(rendered, 4);
+}
@@ -11,12 +11,15 @@
 #include <dfm-base/file/local/asyncfileinfo.h>
 #include <dfm-base/file/local/syncfileinfo.h>
 #include <dfm-base/file/local/localfilehandler.h>
+#include <dfm-base/base/device/deviceutils.h>
 #include <dfm-base/utils/clipboard.h>
 
 #include <dfm-framework/event/event.h>
 
 #include <dfm-io/dfmio_utils.h>
 
+#include <QTemporaryDir>
+
 #include <gtest/gtest.h>
 
 typedef QMap<QString,QVariant> * mapValue;
@@ -96,7 +99,7 @@ TEST_F(UT_DoCutFilesWorker, testCutFiles)
     stub.set_lamda(&DoCutFilesWorker::doHandleErrorAndWait, []{ __DBG_STUB_INVOKE__
                 return AbstractJobHandler::SupportAction::kNoAction;});
     worker.stop();
-    worker.sourceUrls.append(QUrl());
+    worker.leftUrls.append(QUrl());
     EXPECT_FALSE(worker.cutFiles());
 
     worker.resume();
@@ -106,9 +109,9 @@ TEST_F(UT_DoCutFilesWorker, testCutFiles)
                 return AbstractJobHandler::SupportAction::kSkipAction;});
     EXPECT_TRUE(worker.cutFiles());
 
-    worker.sourceUrls.clear();
+    worker.leftUrls.clear();
     auto sorceUrl = QUrl::fromLocalFile(QDir::currentPath() + "/sourceUrl.txt");
-    worker.sourceUrls.append(sorceUrl);
+    worker.leftUrls.append(sorceUrl);
     stub.set_lamda(&DoCutFilesWorker::checkSelf, []{ __DBG_STUB_INVOKE__ return true;});
     EXPECT_TRUE(worker.cutFiles());
 
@@ -134,6 +137,115 @@ TEST_F(UT_DoCutFilesWorker, testCutFiles)
     EXPECT_FALSE(worker.cutFiles());
 }
 
+TEST_F(UT_DoCutFilesWorker, testRenameFilesInBatch)
+{
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    QDir dir(tempDir.path());
+    ASSERT_TRUE(dir.mkpath("source/folder"));
+    ASSERT_TRUE(dir.mkpath("target"));
+    auto touch = [](const QString &path) {
+        QFile file(path);
+        file.open(QIODevice::WriteOnly);
+        file.write("cut");
+    };
+    touch(dir.filePath("source/a.txt"));
+    touch(dir.filePath("source/same.txt"));
+    touch(dir.filePath("target/same.txt"));
+
+    DoCutFilesWorker worker;
+    worker.workData.reset(new WorkerData);
+    stub_ext::StubExt stub;
+    stub.set_lamda(&DoCutFilesWorker::saveOperations, []{ __DBG_STUB_INVOKE__ });
+    worker.targetOrgUrl = QUrl::fromLocalFile(dir.filePath("target"));
+    worker.sourceUrls = { QUrl::fromLocalFile(dir.filePath("source/a.txt")),
+                          QUrl::fromLocalFile(dir.filePath("source/folder")),
+                          QUrl::fromLocalFile(dir.filePath("source/same.txt")),
+                          QUrl::fromLocalFile(dir.filePath("source/none.txt")) };
+
+    QList<QUrl> others;
+    EXPECT_TRUE(worker.renameFilesInBatch(&others));
+    EXPECT_TRUE(QFile::exists(dir.filePath("target/a.txt")));
+    EXPECT_TRUE(QFileInfo(dir.filePath("target/folder")).isDir());
+    EXPECT_FALSE(QFile::exists(dir.filePath("source/a.txt")));
+    EXPECT_EQ(2, worker.completeSourceFiles.count());
+    EXPECT_EQ(3, worker.workData->blockRenameWriteSize.load());
+    // the conflict and the missing file are left to the per-file way
+    EXPECT_EQ(2, others.count());
+    EXPECT_TRUE(others.contains(QUrl::fromLocalFile(dir.filePath("source/same.txt"))));
+    EXPECT_TRUE(QFile::exists(dir.filePath("source/same.txt")));
+
+    // the target is moved into itself
+    worker.sourceUrls = { QUrl::fromLocalFile(dir.filePath("target")) };
+    worker.targetOrgUrl = QUrl::fromLocalFile(dir.filePath("target/folder"));
+    others.clear();
+    EXPECT_TRUE(worker.renameFilesInBatch(&others));
+    EXPECT_EQ(1, others.count());
+
+    worker.targetOrgUrl = QUrl();
+    others.clear();
+    EXPECT_TRUE(worker.renameFilesInBatch(&others));
+    EXPECT_EQ(worker.sourceUrls, others);
+
+    worker.stop();
+    worker.sourceUrls = { QUrl::fromLocalFile(dir.filePath("target/a.txt")) };
+    worker.targetOrgUrl = QUrl::fromLocalFile(dir.filePath("source"));
+    others.clear();
+    EXPECT_FALSE(worker.renameFilesInBatch(&others));
+    EXPECT_TRUE(QFile::exists(dir.filePath("target/a.txt")));
+}
+
+TEST_F(UT_DoCutFilesWorker, testStatisticsFilesSize)
+{
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    QDir dir(tempDir.path());
+    ASSERT_TRUE(dir.mkpath("source/folder/sub"));
+    ASSERT_TRUE(dir.mkpath("target"));
+    QFile file(dir.filePath("source/a.txt"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("cut");
+    file.close();
+
+    DoCutFilesWorker worker;
+    worker.workData.reset(new WorkerData);
+    stub_ext::StubExt stub;
+    stub.set_lamda(&DoCutFilesWorker::saveOperations, []{ __DBG_STUB_INVOKE__ });
+    QList<QUrl> walkedUrls;
+    stub.set_lamda(VADDR(AbstractWorker, statisticsFilesSize), [&walkedUrls](AbstractWorker *self) {
+        __DBG_STUB_INVOKE__
+        walkedUrls = self->sourceUrls;
+        self->sourceFilesTotalSize = 100;
+        self->sourceFilesCount = 1;
+        return true;
+    });
+    worker.targetOrgUrl = QUrl::fromLocalFile(dir.filePath("target"));
+    worker.sourceUrls = { QUrl::fromLocalFile(dir.filePath("source/a.txt")),
+                          QUrl::fromLocalFile(dir.filePath("source/folder")),
+                          QUrl::fromLocalFile(dir.filePath("source/none.txt")) };
+
+    // the renamed files are not walked, only the file left is
+    EXPECT_TRUE(worker.statisticsFilesSize());
+    EXPECT_EQ(QList<QUrl>({ QUrl::fromLocalFile(dir.filePath("source/none.txt")) }), walkedUrls);
+    EXPECT_EQ(walkedUrls, worker.leftUrls);
+    EXPECT_EQ(3, worker.sourceUrls.count());
+    EXPECT_EQ(3, worker.sourceFilesCount.load());
+    EXPECT_EQ(100 + 3 + FileUtils::getMemoryPageSize(), worker.sourceFilesTotalSize.load());
+    EXPECT_TRUE(QFileInfo(dir.filePath("target/folder/sub")).isDir());
+
+    // nothing is walked when all the files are renamed
+    walkedUrls.clear();
+    worker.sourceUrls = { QUrl::fromLocalFile(dir.filePath("target/a.txt")) };
+    worker.targetOrgUrl = QUrl::fromLocalFile(dir.filePath("source"));
+    worker.sourceFilesTotalSize = 0;
+    worker.sourceFilesCount = 0;
+    EXPECT_TRUE(worker.statisticsFilesSize());
+    EXPECT_TRUE(walkedUrls.isEmpty());
+    EXPECT_TRUE(worker.leftUrls.isEmpty());
+    EXPECT_EQ(1, worker.sourceFilesCount.load());
+    EXPECT_EQ(3, worker.sourceFilesTotalSize.load());
+}
+
 bool checkDiskSpaceAvailableFunc(DoCutFilesWorker *&, const QUrl &fromUrl,
                   const QUrl &toUrl,
                   bool *skip) {
@@ -243,8 +355,8 @@ TEST_F(UT_DoCutFilesWorker, testRenameFileByHandler)
     bool skip{false};
     EXPECT_FALSE(worker.doRenameFile(sorceInfo, targetInfo, toInfo, "tests_iiii.txt", &skip));
 
-    stub.set_lamda(&DFMUtils::deviceNameFromUrl, []{ __DBG_STUB_INVOKE__
-        return QByteArray("test-device");
+    stub.set_lamda(&DeviceUtils::getMountSource, []{ __DBG_STUB_INVOKE__
+        return QString("test-device");
     });
     EXPECT_FALSE(worker.doRenameFile(sorceInfo, targetInfo, toInfo, "tests_iiii.txt", &skip));
 
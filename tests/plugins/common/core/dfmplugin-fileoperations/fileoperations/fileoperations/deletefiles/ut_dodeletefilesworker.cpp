@@ -13,6 +13,7 @@
 #include <dfm-base/file/local/localfilehandler.h>
 #include <dfm-base/utils/clipboard.h>
 #include <dfm-base/file/local/localdiriterator.h>
+#include <dfm-base/utils/fileutils.h>
 
 #include <dfm-framework/event/event.h>
 
@@ -20,6 +21,8 @@
 
 #include <dfm-io/denumerator.h>
 
+#include <QTemporaryDir>
+
 typedef QMap<QString,QVariant> * mapValue;
 Q_DECLARE_METATYPE(mapValue);
 
@@ -70,27 +73,41 @@ TEST_F(UT_DoDeleteFilesWorker, testDeleteFilesOnCanNotRemoveDevice)
     DoDeleteFilesWorker worker;
     stub_ext::StubExt stub;
     worker.localFileHandler.reset(new LocalFileHandler);
+    stub.set_lamda(&FileUtils::notifyFileChangeManual, []{ __DBG_STUB_INVOKE__ });
 
     worker.stop();
     EXPECT_TRUE(worker.deleteFilesOnCanNotRemoveDevice());
 
-    worker.allFilesList.append(QUrl());
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString &root = tempDir.path() + "/tree";
+    for (const QString &dir : { "/a/b/c", "/a/d", "/e" })
+        ASSERT_TRUE(QDir().mkpath(root + dir));
+    for (const QString &file : { "/f", "/a/f", "/a/b/f", "/a/b/c/f", "/a/d/f" }) {
+        QFile f(root + file);
+        ASSERT_TRUE(f.open(QIODevice::WriteOnly));
+    }
+    const QString &single = tempDir.path() + "/single";
+    {
+        QFile f(single);
+        ASSERT_TRUE(f.open(QIODevice::WriteOnly));
+    }
+
+    worker.sourceUrls = { QUrl::fromLocalFile(root), QUrl::fromLocalFile(single),
+                          QUrl::fromLocalFile(root), QUrl::fromLocalFile(root + "/a") };
     EXPECT_FALSE(worker.deleteFilesOnCanNotRemoveDevice());
+    EXPECT_TRUE(QFile::exists(root));
 
     worker.resume();
-    stub.set_lamda(&DoDeleteFilesWorker::doHandleErrorAndWait, []{ __DBG_STUB_INVOKE__
-                return AbstractJobHandler::SupportAction::kNoAction;});
-    worker.sourceUrls.append(QUrl());
-    stub.set_lamda(&LocalFileHandler::deleteFile, []{ __DBG_STUB_INVOKE__ return false;});
-    EXPECT_TRUE(worker.deleteFilesOnCanNotRemoveDevice());
-
-    stub.set_lamda(&DoDeleteFilesWorker::doHandleErrorAndWait, []{ __DBG_STUB_INVOKE__
-                return AbstractJobHandler::SupportAction::kSkipAction;});
-    EXPECT_TRUE(worker.deleteFilesOnCanNotRemoveDevice());
-
     stub.set_lamda(&DoDeleteFilesWorker::doHandleErrorAndWait, []{ __DBG_STUB_INVOKE__
                 return AbstractJobHandler::SupportAction::kCancelAction;});
-    EXPECT_FALSE(worker.deleteFilesOnCanNotRemoveDevice());
+    EXPECT_TRUE(worker.deleteFilesOnCanNotRemoveDevice());
+    EXPECT_FALSE(QFile::exists(root));
+    EXPECT_FALSE(QFile::exists(single));
+    // 10 entries under tree, tree itself and single.
+    EXPECT_EQ(worker.deleteFilesCount.loadAcquire(), 12);
+    // the duplicated source is handled once, the nested source has been deleted with its parent.
+    EXPECT_EQ(worker.completeSourceFiles.count(), 3);
 }
 
 TEST_F(UT_DoDeleteFilesWorker, testDeleteFilesOnOtherDevice)
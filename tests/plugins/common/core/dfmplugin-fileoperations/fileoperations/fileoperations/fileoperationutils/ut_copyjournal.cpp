@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stubext.h"
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/copyjournal.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+#include <gtest/gtest.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+class UT_CopyJournal : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        const QString &journalDir = dir.filePath("journal");
+        stub.set_lamda(&CopyJournal::journalDir, [journalDir] { __DBG_STUB_INVOKE__ return journalDir; });
+
+        sources = { QUrl::fromLocalFile(dir.filePath("a")), QUrl::fromLocalFile(dir.filePath("b")) };
+        target = QUrl::fromLocalFile(dir.filePath("target"));
+        QDir(dir.path()).mkpath("target");
+    }
+    void TearDown() override
+    {
+        stub.clear();
+    }
+
+    QUrl createFile(const QString &name, qint64 size)
+    {
+        QFile file(dir.filePath(name));
+        file.open(QIODevice::WriteOnly);
+        file.write(QByteArray(static_cast<int>(size), 'x'));
+        file.close();
+        return QUrl::fromLocalFile(file.fileName());
+    }
+
+    QTemporaryDir dir;
+    stub_ext::StubExt stub;
+    QList<QUrl> sources;
+    QUrl target;
+};
+
+TEST_F(UT_CopyJournal, testNewJob)
+{
+    CopyJournal journal(sources, target);
+    EXPECT_TRUE(journal.open());
+    EXPECT_FALSE(journal.isResuming());
+    EXPECT_TRUE(QFile::exists(journal.filePath()));
+
+    journal.remove();
+    EXPECT_FALSE(QFile::exists(journal.filePath()));
+}
+
+TEST_F(UT_CopyJournal, testRemoveExpired)
+{
+    QString crashedPath;
+    {
+        CopyJournal journal(sources, target);
+        ASSERT_TRUE(journal.open());
+        journal.fileCompleted(sources.at(0), target, 10, 1);
+        crashedPath = journal.filePath();
+    }
+    CopyJournal running({ sources.at(0) }, target);
+    ASSERT_TRUE(running.open());
+
+    // the journals are not expired yet
+    CopyJournal::removeExpired(QDateTime::currentDateTime().addDays(-CopyJournal::kExpiredDays));
+    EXPECT_TRUE(QFile::exists(crashedPath));
+
+    // the journal of the running job is locked
+    CopyJournal::removeExpired(QDateTime::currentDateTime().addSecs(60));
+    EXPECT_FALSE(QFile::exists(crashedPath));
+    EXPECT_TRUE(QFile::exists(running.filePath()));
+    running.remove();
+}
+
+TEST_F(UT_CopyJournal, testResume)
+{
+    const QUrl &done = createFile("target/a", 10);
+    const QUrl &partial = createFile("target/b", 100);
+    {
+        CopyJournal journal(sources, target);
+        ASSERT_TRUE(journal.open());
+        journal.dirCreated(QUrl::fromLocalFile(dir.filePath("c")), target);
+        journal.fileCompleted(sources.at(0), done, 10, 1);
+        journal.fileProgressed(sources.at(1), partial, 64, 200, 2);
+        // the job crashed, the journal is not removed
+    }
+
+    CopyJournal journal(sources, target);
+    ASSERT_TRUE(journal.open());
+    EXPECT_TRUE(journal.isResuming());
+
+    CopyJournal::Record record = journal.record(sources.at(0), 10, 1);
+    EXPECT_TRUE(record.completed);
+    EXPECT_EQ(done, record.target);
+    // the source is changed
+    EXPECT_FALSE(journal.record(sources.at(0), 11, 1).target.isValid());
+    EXPECT_FALSE(journal.record(sources.at(0), 10, 3).target.isValid());
+
+    record = journal.record(sources.at(1), 200, 2);
+    EXPECT_FALSE(record.completed);
+    EXPECT_EQ(64, record.offset);
+
+    EXPECT_EQ(target, journal.dirTarget(QUrl::fromLocalFile(dir.filePath("c"))));
+    EXPECT_FALSE(journal.dirTarget(sources.at(0)).isValid());
+
+    // the target is removed after the last run
+    QFile::remove(done.toLocalFile());
+    EXPECT_FALSE(journal.record(sources.at(0), 10, 1).target.isValid());
+    journal.remove();
+}
+
+TEST_F(UT_CopyJournal, testCheckpoint)
+{
+    int synced = 0;
+    stub.set_lamda(&CopyJournal::syncTarget, [&synced] { __DBG_STUB_INVOKE__ ++synced; return true; });
+    const QUrl &done = createFile("target/a", 10);
+
+    CopyJournal journal(sources, target);
+    ASSERT_TRUE(journal.open());
+    const qint64 headerSize = QFileInfo(journal.filePath()).size();
+
+    // the completed files are pending until the checkpoint
+    journal.fileCompleted(sources.at(0), done, 10, 1);
+    EXPECT_EQ(headerSize, QFileInfo(journal.filePath()).size());
+    EXPECT_EQ(0, synced);
+
+    // the target is synced before the records are written
+    journal.checkpoint();
+    EXPECT_EQ(1, synced);
+    EXPECT_LT(headerSize, QFileInfo(journal.filePath()).size());
+
+    // nothing is pending
+    journal.checkpoint();
+    EXPECT_EQ(1, synced);
+
+    for (int i = 0; i < CopyJournal::kCheckpointCount; ++i)
+        journal.fileCompleted(sources.at(0), done, 10, 1);
+    EXPECT_EQ(2, synced);
+    journal.remove();
+}
+
+TEST_F(UT_CopyJournal, testCheckpointSyncFailed)
+{
+    stub.set_lamda(&CopyJournal::syncTarget, [] { __DBG_STUB_INVOKE__ return false; });
+    {
+        CopyJournal journal(sources, target);
+        ASSERT_TRUE(journal.open());
+        journal.fileCompleted(sources.at(0), createFile("target/a", 10), 10, 1);
+    }
+
+    // the record is not trusted if the target is not synced
+    CopyJournal journal(sources, target);
+    ASSERT_TRUE(journal.open());
+    EXPECT_FALSE(journal.isResuming());
+    journal.remove();
+}
+
+TEST_F(UT_CopyJournal, testOtherJob)
+{
+    {
+        CopyJournal journal(sources, target);
+        ASSERT_TRUE(journal.open());
+        journal.fileCompleted(sources.at(0), createFile("target/a", 10), 10, 1);
+    }
+
+    // the journal of another job is not loaded
+    CopyJournal other({ sources.at(0) }, target);
+    ASSERT_TRUE(other.open());
+    EXPECT_FALSE(other.isResuming());
+    other.remove();
+
+    // the journal is locked by the running job
+    CopyJournal journal(sources, target);
+    ASSERT_TRUE(journal.open());
+    CopyJournal same(sources, target);
+    EXPECT_FALSE(same.open());
+    journal.remove();
+}
+
+TEST_F(UT_CopyJournal, testBrokenLine)
+{
+    QString path;
+    {
+        CopyJournal journal(sources, target);
+        ASSERT_TRUE(journal.open());
+        journal.fileCompleted(sources.at(0), createFile("target/a", 10), 10, 1);
+        path = journal.filePath();
+    }
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("C\t10\t1\t");
+    file.close();
+
+    CopyJournal journal(sources, target);
+    ASSERT_TRUE(journal.open());
+    EXPECT_TRUE(journal.isResuming());
+    EXPECT_TRUE(journal.record(sources.at(0), 10, 1).completed);
+    journal.remove();
+}
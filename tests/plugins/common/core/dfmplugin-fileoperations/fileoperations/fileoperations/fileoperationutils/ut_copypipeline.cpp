@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stubext.h"
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/copypipeline.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+USING_IO_NAMESPACE
+
+TEST(UT_CopyBlockTuner, testRecord)
+{
+    CopyBlockTuner tuner;
+    EXPECT_EQ(CopyBlockTuner::kInitBlockSize, tuner.blockSize());
+
+    // 1 MiB in 1 ms, grow
+    tuner.record(CopyBlockTuner::kRead, 1024 * 1024, 1000 * 1000);
+    EXPECT_EQ(CopyBlockTuner::kInitBlockSize * 2, tuner.blockSize());
+
+    // the slower stage decides, 1 MiB in 1 s, shrink
+    tuner.record(CopyBlockTuner::kWrite, 1024 * 1024, 1000 * 1000 * 1000);
+    EXPECT_EQ(CopyBlockTuner::kInitBlockSize, tuner.blockSize());
+
+    for (int i = 0; i < 10; ++i)
+        tuner.record(CopyBlockTuner::kWrite, 1024 * 1024, 1000 * 1000 * 1000);
+    EXPECT_EQ(CopyBlockTuner::kMinBlockSize, tuner.blockSize());
+
+    tuner.reset();
+    for (int i = 0; i < 10; ++i)
+        tuner.record(CopyBlockTuner::kRead, 1024 * 1024, 1000);
+    EXPECT_EQ(CopyBlockTuner::kMaxBlockSize, tuner.blockSize());
+}
+
+TEST(UT_CopyPipeline, testRead)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QByteArray content;
+    for (int i = 0; i < 3 * 1024 * 1024 + 123; ++i)
+        content.append(static_cast<char>(i % 251));
+    QFile file(dir.filePath("source"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(content);
+    file.close();
+
+    QSharedPointer<DFile> source(new DFile(QUrl::fromLocalFile(file.fileName())));
+    ASSERT_TRUE(source->open(DFile::OpenFlag::kReadOnly));
+
+    CopyBlockTuner tuner;
+    CopyPipeline pipeline;
+    pipeline.start(source, content.size(), &tuner);
+    QByteArray copied;
+    while (CopyPipeline::Block *block = pipeline.take()) {
+        copied.append(block->data, static_cast<int>(block->size));
+        pipeline.giveBack(block);
+    }
+    pipeline.stop();
+
+    EXPECT_FALSE(pipeline.hasReadError());
+    EXPECT_EQ(content, copied);
+    EXPECT_NE(nullptr, pipeline.buffer(4096));
+}
+
+TEST(UT_CopyPipeline, testReadError)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QFile file(dir.filePath("source"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(4096, 'a'));
+    file.close();
+
+    QSharedPointer<DFile> source(new DFile(QUrl::fromLocalFile(file.fileName())));
+    ASSERT_TRUE(source->open(DFile::OpenFlag::kReadOnly));
+
+    // the file is shorter than expected
+    CopyBlockTuner tuner;
+    CopyPipeline pipeline;
+    pipeline.start(source, 8192, &tuner);
+    qint64 total = 0;
+    while (CopyPipeline::Block *block = pipeline.take()) {
+        total += block->size;
+        pipeline.giveBack(block);
+    }
+    pipeline.stop();
+
+    EXPECT_EQ(4096, total);
+    EXPECT_TRUE(pipeline.hasReadError());
+    EXPECT_EQ(4096, pipeline.errorPos());
+}
@@ -4,6 +4,7 @@
 
 #include "stubext.h"
 #include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/docopyfileworker.h"
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/filechecksum.h"
 
 #include <dfm-base/base/urlroute.h>
 #include <dfm-base/base/schemefactory.h>
@@ -12,6 +13,8 @@
 #include <dfm-base/file/local/localfilehandler.h>
 #include <dfm-base/utils/fileutils.h>
 
+#include <QTemporaryDir>
+
 #include <gtest/gtest.h>
 
 
@@ -393,42 +396,42 @@ TEST_F(UT_DoCopyFileWorker, testVerifyFileIntegrity)
 {
     QSharedPointer<WorkerData> data(new WorkerData);
     DoCopyFileWorker worker(data);
-    auto sorceUrl = QUrl::fromLocalFile(QDir::currentPath() + "/sourceUrl.txt");
-    auto targetUrl = QUrl::fromLocalFile(QDir::currentPath() + "/targetUrl.txt");
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QByteArray content(4096 * 3 + 17, 'x');
+    QFile target(dir.filePath("targetUrl.txt"));
+    ASSERT_TRUE(target.open(QIODevice::WriteOnly));
+    target.write(content);
+    target.close();
+    auto sorceUrl = QUrl::fromLocalFile(dir.filePath("sourceUrl.txt"));
+    auto targetUrl = QUrl::fromLocalFile(target.fileName());
     auto targetInfo = InfoFactory::create<FileInfo>(targetUrl);
     auto sorceInfo = InfoFactory::create<FileInfo>(sorceUrl);
-    bool skip{false};
-    worker.stop();
-    QSharedPointer<DFMIO::DFile> file{new DFile(sorceUrl)};
-    qint64 blocksize = 512, readsize = 0;
-    char buffer[512];
+    QSharedPointer<DFMIO::DFile> file { new DFile(targetUrl) };
+    qint64 blocksize = 512;
+    const quint32 checkSum = FileChecksum::crc32c(0, content.constData(), content.size());
     stub_ext::StubExt stub;
     data->signalThread = false;
-    worker.retry = true;
-    EXPECT_TRUE(worker.verifyFileIntegrity(blocksize, blocksize, sorceInfo, targetInfo, file));
+    EXPECT_TRUE(worker.verifyFileIntegrity(blocksize, checkSum + 1, sorceInfo, targetInfo, file));
 
     data->jobFlags |= AbstractJobHandler::JobFlag::kCopyIntegrityChecking;
-    stub.set_lamda(&DoCopyFileWorker::doHandleErrorAndWait,[]{
+    EXPECT_TRUE(worker.verifyFileIntegrity(blocksize, checkSum, sorceInfo, targetInfo, file));
+    EXPECT_EQ(content.size(), data->checkSumSize);
+
+    stub.set_lamda(&DoCopyFileWorker::doHandleErrorAndWait, [] {
         __DBG_STUB_INVOKE__
         return AbstractJobHandler::SupportAction::kNoAction;
     });
-    EXPECT_FALSE(worker.verifyFileIntegrity(blocksize, blocksize, sorceInfo, targetInfo, file));
+    EXPECT_FALSE(worker.verifyFileIntegrity(blocksize, checkSum + 1, sorceInfo, targetInfo, file));
 
-    typedef qint64 (DFile::*readFunc)(char *, qint64);
-    stub.set_lamda(static_cast<readFunc>(&DFile::read),[]{ __DBG_STUB_INVOKE__ return 1;});
-    EXPECT_FALSE(worker.verifyFileIntegrity(blocksize, blocksize, sorceInfo, targetInfo, file));
-
-    worker.resume();
-    int index = 0;
-    stub.set_lamda(static_cast<readFunc>(&DFile::read),[&index]{ __DBG_STUB_INVOKE__
-        index++;
-        return index % 2;});
-    worker.retry = true;
-    stub.set_lamda(&DFile::pos, []{ __DBG_STUB_INVOKE__ return 0; });
-    stub.set_lamda(VADDR(SyncFileInfo, size), []{ __DBG_STUB_INVOKE__ return 0;});
-    EXPECT_FALSE(worker.verifyFileIntegrity(blocksize, blocksize, sorceInfo, targetInfo, file));
+    stub.set_lamda(&DoCopyFileWorker::doHandleErrorAndWait, [] {
+        __DBG_STUB_INVOKE__
+        return AbstractJobHandler::SupportAction::kSkipAction;
+    });
+    EXPECT_TRUE(worker.verifyFileIntegrity(blocksize, checkSum + 1, sorceInfo, targetInfo, file));
 
-    EXPECT_TRUE(worker.verifyFileIntegrity(blocksize, 12517567, sorceInfo, targetInfo, file));
+    worker.stop();
+    EXPECT_FALSE(worker.verifyFileIntegrity(blocksize, checkSum, sorceInfo, targetInfo, file));
 }
 
 int OpenFunc(const char *__file, int __oflag, ...){
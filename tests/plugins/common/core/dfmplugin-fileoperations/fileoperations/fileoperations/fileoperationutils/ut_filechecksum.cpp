@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/filechecksum.h"
+
+#include <QByteArray>
+
+#include <gtest/gtest.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+TEST(UT_FileChecksum, testCrc32c)
+{
+    EXPECT_EQ(0u, FileChecksum::crc32c(0, nullptr, 0));
+    EXPECT_EQ(0xE3069283u, FileChecksum::crc32c(0, "123456789", 9));
+    EXPECT_FALSE(FileChecksum::algorithm().isEmpty());
+}
+
+TEST(UT_FileChecksum, testUpdate)
+{
+    QByteArray data;
+    for (int i = 0; i < 1000; ++i)
+        data.append(static_cast<char>(i * 31));
+
+    FileChecksum checksum;
+    checksum.update(data.constData(), 3);
+    checksum.update(data.constData() + 3, 500);
+    checksum.update(data.constData() + 503, data.size() - 503);
+    EXPECT_EQ(FileChecksum::crc32c(0, data.constData(), data.size()), checksum.value());
+
+    checksum.reset();
+    EXPECT_EQ(0u, checksum.value());
+}
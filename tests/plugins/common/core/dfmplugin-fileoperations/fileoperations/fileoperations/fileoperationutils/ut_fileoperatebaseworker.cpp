@@ -791,8 +791,8 @@ TEST_F(UT_FileOperateBaseWorker, testGetWriteDataSize)
     EXPECT_TRUE(0 == worker.getWriteDataSize());
 
     worker.countWriteType = AbstractWorker::CountWriteSizeType::kWriteBlockType;
-    stub.set_lamda(&FileOperateBaseWorker::getSectorsWritten,[]{ __DBG_STUB_INVOKE__ return 10;});
-    EXPECT_TRUE(10 * 512 == worker.getWriteDataSize());
+    worker.workData->syncedWriteSize = 10;
+    EXPECT_TRUE(10 == worker.getWriteDataSize());
 }
 
 TEST_F(UT_FileOperateBaseWorker, testGetTidWriteSize)
@@ -809,19 +809,11 @@ TEST_F(UT_FileOperateBaseWorker, testGetTidWriteSize)
     EXPECT_TRUE(0 == worker.getTidWriteSize());
 }
 
-TEST_F(UT_FileOperateBaseWorker, testGetSectorsWritten)
+TEST_F(UT_FileOperateBaseWorker, testDetermineCountProcessType)
 {
     FileOperateBaseWorker worker;
     stub_ext::StubExt stub;
 
-    EXPECT_TRUE(0 == worker.getSectorsWritten());
-
-    typedef bool (*openfile)(QFile *,QFile::OpenMode);
-    stub.set_lamda((openfile)((bool (QFile::*)(QFile::OpenMode))(&QFile::open)),[](){return true;});
-    stub.set_lamda(VADDR(QFile, close), []{ __DBG_STUB_INVOKE__ });
-    stub.set_lamda(VADDR(QFile, readAll), []{ __DBG_STUB_INVOKE__ return QByteArray("sdf dd dd dd ff oo 99 00"); });
-    EXPECT_TRUE(99 == worker.getSectorsWritten());
-
     auto url = QUrl::fromLocalFile(QDir::currentPath());
     worker.targetUrl = url;
     worker.determineCountProcessType();
@@ -834,20 +826,17 @@ TEST_F(UT_FileOperateBaseWorker, testSyncFilesToDevice)
 {
     FileOperateBaseWorker worker;
     stub_ext::StubExt stub;
+    worker.workData.reset(new WorkerData);
 
-    worker.countWriteType = AbstractWorker::CountWriteSizeType::kCustomizeType;
+    worker.isTargetFileLocal = true;
+    bool finished = false;
+    stub.set_lamda(&WriteBackTracker::finish, [&finished] { __DBG_STUB_INVOKE__ finished = true; });
+    worker.workData->writeBack.reset(new WriteBackTracker(&worker.workData->syncedWriteSize));
     worker.syncFilesToDevice();
+    EXPECT_FALSE(finished);
 
-    int index = 0;
-    stub.set_lamda(&FileOperateBaseWorker::isStopped,[&index]{
-        __DBG_STUB_INVOKE__
-        index++;
-        if (index % 2)
-            return false;
-        return true;
-    });
-    worker.sourceFilesTotalSize = 1;
-    worker.countWriteType = AbstractWorker::CountWriteSizeType::kWriteBlockType;
-    stub.set_lamda(&FileOperateBaseWorker::getWriteDataSize,[]{ __DBG_STUB_INVOKE__ return 0;});
+    worker.isTargetFileLocal = false;
+    worker.targetOrgUrl = QUrl::fromLocalFile(QDir::tempPath());
     worker.syncFilesToDevice();
+    EXPECT_TRUE(finished);
 }
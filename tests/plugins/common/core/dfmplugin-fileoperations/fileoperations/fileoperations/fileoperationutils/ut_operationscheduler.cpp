@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stubext.h"
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/operationscheduler.h"
+
+#include <gtest/gtest.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+namespace {
+class TestScheduler : public OperationScheduler
+{
+public:
+    TestScheduler() = default;
+};
+}
+
+class UT_OperationScheduler : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        // the first dir of the path is the device, "usb" is a slow device
+        stub.set_lamda(&OperationScheduler::deviceOf, [](const QUrl &url) {
+            __DBG_STUB_INVOKE__
+            return url.path().section('/', 1, 1);
+        });
+        stub.set_lamda(&OperationScheduler::limitOf, [](const QUrl &url) {
+            __DBG_STUB_INVOKE__
+            return url.path().startsWith("/usb") ? 1 : 2;
+        });
+    }
+    void TearDown() override { stub.clear(); }
+
+    stub_ext::StubExt stub;
+};
+
+TEST_F(UT_OperationScheduler, testLimitOfDevice)
+{
+    TestScheduler scheduler;
+    scheduler.enqueue(1, { QUrl::fromLocalFile("/home/a"), QUrl::fromLocalFile("/usb/") });
+    scheduler.enqueue(2, { QUrl::fromLocalFile("/home/b"), QUrl::fromLocalFile("/usb/") });
+    scheduler.enqueue(3, { QUrl::fromLocalFile("/data/c"), QUrl::fromLocalFile("/nfs/") });
+    // the job 2 waits for usb, the free slot of home is not kept for it
+    scheduler.enqueue(4, { QUrl::fromLocalFile("/home/d"), QUrl::fromLocalFile("/nfs/") });
+    // the slot of usb is kept for the job 2
+    scheduler.enqueue(5, { QUrl::fromLocalFile("/usb/e") });
+
+    EXPECT_TRUE(scheduler.waitForStart(1, 0));
+    EXPECT_FALSE(scheduler.waitForStart(2, 0));
+    // the job on other devices runs in parallel
+    EXPECT_TRUE(scheduler.waitForStart(3, 0));
+    EXPECT_TRUE(scheduler.waitForStart(4, 0));
+    EXPECT_FALSE(scheduler.waitForStart(5, 0));
+    EXPECT_EQ(1, scheduler.queuePosition(2));
+    EXPECT_EQ(2, scheduler.runningCount("home"));
+    EXPECT_EQ(1, scheduler.runningCount("usb"));
+
+    scheduler.release(1);
+    EXPECT_TRUE(scheduler.waitForStart(2, 0));
+    EXPECT_FALSE(scheduler.waitForStart(5, 0));
+    EXPECT_EQ(0, scheduler.queuePosition(2));
+    EXPECT_EQ(-1, scheduler.queuePosition(1));
+}
+
+TEST_F(UT_OperationScheduler, testReserveSlot)
+{
+    TestScheduler scheduler;
+    scheduler.enqueue(1, { QUrl::fromLocalFile("/home/a") });
+    scheduler.enqueue(2, { QUrl::fromLocalFile("/home/b") });
+    // only waiting for home, the next slot of home is kept for it
+    scheduler.enqueue(3, { QUrl::fromLocalFile("/home/c"), QUrl::fromLocalFile("/usb/") });
+    scheduler.enqueue(4, { QUrl::fromLocalFile("/home/d") });
+    EXPECT_FALSE(scheduler.waitForStart(3, 0));
+
+    scheduler.release(1);
+    EXPECT_TRUE(scheduler.waitForStart(3, 0));
+    EXPECT_FALSE(scheduler.waitForStart(4, 0));
+}
+
+TEST_F(UT_OperationScheduler, testPriority)
+{
+    TestScheduler scheduler;
+    scheduler.enqueue(1, { QUrl::fromLocalFile("/usb/a") });
+    scheduler.enqueue(2, { QUrl::fromLocalFile("/usb/b") });
+    scheduler.enqueue(3, { QUrl::fromLocalFile("/usb/c") }, OperationScheduler::Priority::kHigh);
+
+    EXPECT_EQ(1, scheduler.queuePosition(3));
+    EXPECT_EQ(2, scheduler.queuePosition(2));
+
+    scheduler.release(1);
+    EXPECT_TRUE(scheduler.waitForStart(3, 0));
+    EXPECT_FALSE(scheduler.waitForStart(2, 0));
+
+    scheduler.setPriority(2, OperationScheduler::Priority::kHigh);
+    scheduler.release(3);
+    EXPECT_TRUE(scheduler.waitForStart(2, 0));
+}
+
+TEST_F(UT_OperationScheduler, testPause)
+{
+    TestScheduler scheduler;
+    scheduler.enqueue(1, { QUrl::fromLocalFile("/usb/a") });
+    scheduler.enqueue(2, { QUrl::fromLocalFile("/usb/b") });
+    EXPECT_FALSE(scheduler.waitForStart(2, 0));
+
+    // the paused job leaves the device to the others
+    scheduler.setPaused(1, true);
+    EXPECT_TRUE(scheduler.waitForStart(2, 0));
+    EXPECT_EQ(1, scheduler.runningCount("usb"));
+
+    // resuming does not block the job
+    scheduler.setPaused(1, false);
+    EXPECT_EQ(2, scheduler.runningCount("usb"));
+
+    scheduler.release(1);
+    scheduler.release(2);
+    EXPECT_EQ(0, scheduler.runningCount("usb"));
+
+    // the job paused in queue does not block the others
+    scheduler.enqueue(3, { QUrl::fromLocalFile("/usb/c") });
+    scheduler.enqueue(4, { QUrl::fromLocalFile("/usb/d") });
+    scheduler.enqueue(5, { QUrl::fromLocalFile("/usb/e") });
+    scheduler.setPaused(4, true);
+    scheduler.release(3);
+    EXPECT_FALSE(scheduler.waitForStart(4, 0));
+    EXPECT_TRUE(scheduler.waitForStart(5, 0));
+}
+
+TEST(UT_OperationSchedulerDevice, testDeviceOfGvfs)
+{
+    // each gvfs mount is a device, though they all come from gvfsd-fuse
+    const QString &share1 = "/run/user/1000/gvfs/smb-share:server=10.0.0.1,share=a";
+    const QString &share2 = "/run/user/1000/gvfs/smb-share:server=10.0.0.2,share=a";
+    EXPECT_EQ(share1, OperationScheduler::deviceOf(QUrl::fromLocalFile(share1 + "/dir/file")));
+    EXPECT_EQ(share1, OperationScheduler::deviceOf(QUrl::fromLocalFile(share1)));
+    EXPECT_NE(OperationScheduler::deviceOf(QUrl::fromLocalFile(share1 + "/file")),
+              OperationScheduler::deviceOf(QUrl::fromLocalFile(share2 + "/file")));
+}
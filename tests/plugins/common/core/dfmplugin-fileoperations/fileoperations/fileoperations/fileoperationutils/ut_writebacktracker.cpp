@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stubext.h"
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/fileoperationutils/writebacktracker.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <gtest/gtest.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+class UT_WriteBackTracker : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+    }
+
+    QString createFile(const QString &name, qint64 size)
+    {
+        QFile file(dir.filePath(name));
+        file.open(QIODevice::WriteOnly);
+        file.write(QByteArray(static_cast<int>(size), 'x'));
+        file.close();
+        return file.fileName();
+    }
+
+    QTemporaryDir dir;
+};
+
+TEST_F(UT_WriteBackTracker, testWindows)
+{
+    const qint64 size = WriteBackTracker::kWindowSize * 2 + 5;
+    const QString &path = createFile("a", size);
+
+    QAtomicInteger<qint64> synced { 0 };
+    WriteBackTracker tracker(&synced);
+    WriteBackTracker::Stream stream;
+    EXPECT_FALSE(tracker.begin(&stream, dir.filePath("none")));
+    EXPECT_FALSE(stream.isTracking());
+
+    EXPECT_TRUE(tracker.begin(&stream, path));
+    EXPECT_TRUE(stream.isTracking());
+    tracker.written(&stream, WriteBackTracker::kWindowSize - 1);
+    tracker.written(&stream, size - WriteBackTracker::kWindowSize + 1);
+    // the windows in flight are not counted
+    EXPECT_EQ(0, synced);
+
+    tracker.end(&stream);
+    EXPECT_FALSE(stream.isTracking());
+    tracker.finish();
+    EXPECT_EQ(size, synced);
+}
+
+TEST_F(UT_WriteBackTracker, testTrackFiles)
+{
+    QAtomicInteger<qint64> synced { 0 };
+    WriteBackTracker tracker(&synced);
+    qint64 total = 0;
+    for (int i = 0; i < WriteBackTracker::kMaxFiles + 3; ++i) {
+        const QString &path = createFile(QString::number(i), 100 + i);
+        tracker.track(path, 100 + i);
+        total += 100 + i;
+    }
+    // the oldest files are waited when too many files are in flight
+    EXPECT_LT(0, synced);
+
+    tracker.finish();
+    EXPECT_EQ(total, synced);
+}
+
+TEST_F(UT_WriteBackTracker, testThreads)
+{
+    // the small files are tracked by the threads of pool while a big file is written
+    QStringList paths;
+    for (int i = 0; i < 200; ++i)
+        paths.append(createFile(QString::number(i), 1000));
+    const qint64 bigSize = WriteBackTracker::kWindowSize * 3;
+    const QString &bigPath = createFile("big", bigSize);
+
+    QAtomicInteger<qint64> synced { 0 };
+    WriteBackTracker tracker(&synced);
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    for (const QString &path : paths)
+        QtConcurrent::run(&pool, [&tracker, path] { tracker.track(path, 1000); });
+
+    WriteBackTracker::Stream stream;
+    ASSERT_TRUE(tracker.begin(&stream, bigPath));
+    for (int i = 0; i < 3; ++i)
+        tracker.written(&stream, WriteBackTracker::kWindowSize);
+    tracker.end(&stream);
+    pool.waitForDone();
+
+    tracker.finish();
+    EXPECT_EQ(paths.size() * 1000 + bigSize, synced);
+}
+
+TEST_F(UT_WriteBackTracker, testAbandon)
+{
+    QAtomicInteger<qint64> synced { 0 };
+    WriteBackTracker tracker(&synced);
+    tracker.track(createFile("a", 10), 10);
+    WriteBackTracker::Stream stream;
+    tracker.begin(&stream, createFile("b", 20));
+    tracker.written(&stream, 20);
+    tracker.end(&stream);
+    tracker.abandon();
+    EXPECT_EQ(0, synced);
+
+    tracker.finish();
+    EXPECT_EQ(0, synced);
+}
@@ -93,6 +93,13 @@ TEST_F(UT_DoMoveToTrashFilesWorker, testDoMoveToTrash)
     stub_ext::StubExt stub;
     QUrl url = QUrl::fromLocalFile("/data/home");
     worker.sourceUrls.append(url);
+    // never rename the real files into trash.
+    stub.set_lamda(&DoMoveToTrashFilesWorker::trashFilesByRename,
+                   [](DoMoveToTrashFilesWorker *, const QList<QPair<QUrl, QUrl>> &sources, QList<QPair<QUrl, QUrl>> *others) {
+                       __DBG_STUB_INVOKE__
+                       *others = sources;
+                       return true;
+                   });
     worker.stop();
     EXPECT_FALSE(worker.doMoveToTrash());
 
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "plugins/common/core/dfmplugin-fileoperations/fileoperations/trashfiles/hometrashwriter.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+DPFILEOPERATIONS_USE_NAMESPACE
+
+TEST(UT_HomeTrashWriter, trash)
+{
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString &trashPath = tempDir.path() + "/Trash";
+    const QString &sourcePath = tempDir.path() + "/source";
+    ASSERT_TRUE(QDir().mkpath(sourcePath + "/sub"));
+    QFile file(sourcePath + "/a b.txt");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    HomeTrashWriter writer(trashPath);
+    ASSERT_TRUE(writer.isValid());
+
+    int dirFd = ::open(QFile::encodeName(sourcePath).constData(), O_RDONLY | O_DIRECTORY);
+    ASSERT_TRUE(dirFd >= 0);
+
+    QString trashTime;
+    EXPECT_TRUE(writer.trash(dirFd, "a b.txt", QFile::encodeName(sourcePath + "/a b.txt"), &trashTime));
+    EXPECT_EQ(trashTime.split("-").size(), 2);
+    EXPECT_FALSE(QFile::exists(sourcePath + "/a b.txt"));
+    EXPECT_TRUE(QFile::exists(trashPath + "/files/a b.txt"));
+
+    QFile info(trashPath + "/info/a b.txt.trashinfo");
+    ASSERT_TRUE(info.open(QIODevice::ReadOnly));
+    const QByteArray &content = info.readAll();
+    EXPECT_TRUE(content.startsWith("[Trash Info]\n"));
+    EXPECT_TRUE(content.contains("Path=" + QFile::encodeName(sourcePath).toPercentEncoding("/") + "/a%20b.txt\n"));
+    EXPECT_TRUE(content.contains("DeletionDate="));
+
+    // the name is used, a new one is taken.
+    ASSERT_TRUE(QDir().mkpath(sourcePath + "/a b.txt"));
+    EXPECT_TRUE(writer.trash(dirFd, "a b.txt", QFile::encodeName(sourcePath + "/a b.txt"), nullptr));
+    EXPECT_TRUE(QFileInfo(trashPath + "/files/a b.txt.2").isDir());
+    EXPECT_TRUE(QFile::exists(trashPath + "/info/a b.txt.2.trashinfo"));
+
+    // the reserved info is removed if renaming failed.
+    EXPECT_FALSE(writer.trash(dirFd, "none", QFile::encodeName(sourcePath + "/none"), nullptr));
+    EXPECT_FALSE(QFile::exists(trashPath + "/info/none.trashinfo"));
+
+    ::close(dirFd);
+}
@@ -0,0 +1,272 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stubext.h"
+#include "plugins/common/core/dfmplugin-menu/utils/menuactionindex.h"
+
+#include <dfm-base/base/schemefactory.h>
+#include <dfm-base/file/local/syncfileinfo.h>
+#include <dfm-base/mimetype/dmimedatabase.h>
+
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+DFMBASE_USE_NAMESPACE
+DPMENU_USE_NAMESPACE
+
+namespace {
+
+// the matching of actions before the index, one action and one file at a time
+void appendParents(const QStringList &parents, QStringList &mimeTypes)
+{
+    DMimeDatabase db;
+    for (const QString &name : parents) {
+        QMimeType mt = db.mimeTypeForName(name);
+        mimeTypes.append(mt.name());
+        mimeTypes.append(mt.aliases());
+        appendParents(mt.parentMimeTypes(), mimeTypes);
+    }
+}
+
+bool isMimeTypeMatch(const QStringList &fileMimeTypes, const QStringList &supportMimeTypes)
+{
+    for (const QString &mt : supportMimeTypes) {
+        if (fileMimeTypes.contains(mt, Qt::CaseInsensitive))
+            return true;
+
+        int index = mt.indexOf("*");
+        if (index < 0)
+            continue;
+        for (const QString &fmt : fileMimeTypes) {
+            if (fmt.contains(mt.left(index), Qt::CaseInsensitive))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool isRuleMatch(const MenuActionIndex::Rule &rule, const QMimeType &mt)
+{
+    QStringList types { mt.name() };
+    types.append(mt.aliases());
+    QStringList allTypes = types;
+    appendParents(mt.parentMimeTypes(), allTypes);
+    types.removeAll({});
+    allTypes.removeAll({});
+
+    QStringList excludeTypes = rule.excludeMimeTypes;
+    excludeTypes.removeAll({});
+    if (isMimeTypeMatch(types, excludeTypes))
+        return false;
+    if (rule.anyMimeType)
+        return true;
+
+    QStringList supportTypes = rule.mimeTypes;
+    supportTypes.removeAll({});
+    return isMimeTypeMatch(allTypes, supportTypes);
+}
+
+MenuActionIndex::Rule mimeRule(const QStringList &mimeTypes, const QStringList &excludeMimeTypes = {})
+{
+    MenuActionIndex::Rule rule;
+    rule.anyMimeType = false;
+    rule.mimeTypes = mimeTypes;
+    rule.excludeMimeTypes = excludeMimeTypes;
+    return rule;
+}
+
+}
+
+class UT_MenuActionIndex : public testing::Test
+{
+protected:
+    virtual void SetUp() override
+    {
+        UrlRoute::regScheme(Global::Scheme::kFile, "/", QIcon(), false, QObject::tr("System Disk"));
+        InfoFactory::regClass<dfmbase::SyncFileInfo>(Global::Scheme::kFile);
+    }
+    virtual void TearDown() override { stub.clear(); }
+
+    QMimeType mimeType(const QString &name) { return db.mimeTypeForName(name); }
+
+    DMimeDatabase db;
+    stub_ext::StubExt stub;
+};
+
+TEST_F(UT_MenuActionIndex, MimeTypeAncestors)
+{
+    MenuActionIndex index;
+    const QStringList &xlsx = index.mimeTypeAncestors(mimeType("application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"));
+    EXPECT_TRUE(xlsx.contains("application/zip"));
+    EXPECT_EQ(xlsx.count("application/zip"), 1);
+
+    const QStringList &csrc = index.mimeTypeAncestors(mimeType("text/x-csrc"));
+    EXPECT_EQ(csrc.first(), "text/x-csrc");
+    EXPECT_TRUE(csrc.contains("text/plain"));
+}
+
+TEST_F(UT_MenuActionIndex, MatchMimeTypes)
+{
+    MenuActionIndex index;
+    const int zip = index.append(mimeRule({ "application/zip" }));
+    const int notZip = index.append(mimeRule({ "application/zip" }, { "Application/Zip" }));
+    const int image = index.append(mimeRule({ "image/*" }));
+    const int any = index.append(MenuActionIndex::Rule());
+    const int empty = index.append(mimeRule({ "" }));
+    const int notImage = index.append(mimeRule({ "text/plain" }, { "image/*" }));
+    ASSERT_EQ(index.count(), 6);
+
+    // the supported types are matched with the parent types, but the excluded ones are not
+    const QBitArray &xlsx = index.actionsOfMimeType(mimeType("application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"));
+    EXPECT_TRUE(xlsx.testBit(zip));
+    EXPECT_TRUE(xlsx.testBit(notZip));
+    EXPECT_FALSE(xlsx.testBit(image));
+    EXPECT_TRUE(xlsx.testBit(any));
+    EXPECT_FALSE(xlsx.testBit(empty));
+
+    const QBitArray &archive = index.actionsOfMimeType(mimeType("application/zip"));
+    EXPECT_TRUE(archive.testBit(zip));
+    EXPECT_FALSE(archive.testBit(notZip));
+
+    const QBitArray &png = index.actionsOfMimeType(mimeType("image/png"));
+    EXPECT_EQ(MenuActionIndex::ids(png), QList<int>({ image, any }));
+
+    const QBitArray &text = index.actionsOfMimeType(mimeType("text/x-csrc"));
+    EXPECT_EQ(MenuActionIndex::ids(text), QList<int>({ any, notImage }));
+    EXPECT_TRUE(index.actionsSupportMimeType("application/zip").testBit(notZip));
+}
+
+TEST_F(UT_MenuActionIndex, MatchSuffixesAndSchemes)
+{
+    MenuActionIndex index;
+    MenuActionIndex::Rule rule;
+    rule.anySuffix = false;
+    rule.suffixes = QStringList { "7z.*", "TAR.GZ" };
+    rule.anyScheme = false;
+    rule.schemes = QStringList { "file" };
+    const int archive = index.append(rule);
+    const int any = index.append(MenuActionIndex::Rule());
+
+    EXPECT_TRUE(index.actionsOfSuffix("7z.001").testBit(archive));
+    EXPECT_FALSE(index.actionsOfSuffix("7z.").testBit(archive));
+    EXPECT_FALSE(index.actionsOfSuffix("7z").testBit(archive));
+    EXPECT_TRUE(index.actionsOfSuffix("tar.gz").testBit(archive));
+    EXPECT_TRUE(index.actionsOfSuffix("txt").testBit(any));
+    EXPECT_EQ(MenuActionIndex::ids(index.actionsWithSuffix()), QList<int>({ archive }));
+
+    EXPECT_TRUE(index.actionsOfScheme("FILE").testBit(archive));
+    EXPECT_FALSE(index.actionsOfScheme("trash").testBit(archive));
+    EXPECT_TRUE(index.actionsOfScheme("trash").testBit(any));
+}
+
+TEST_F(UT_MenuActionIndex, MatchCombosAndPlaces)
+{
+    MenuActionIndex index;
+    MenuActionIndex::Rule rule;
+    rule.combos = 1 << 1 | 1 << 3;
+    rule.showOnDesktop = false;
+    const int first = index.append(rule);
+    rule.combos = 1 << 2;
+    rule.showOnDesktop = true;
+    rule.showInFileManager = false;
+    const int second = index.append(rule);
+
+    EXPECT_EQ(MenuActionIndex::ids(index.actionsOfCombo(1 << 3)), QList<int>({ first }));
+    EXPECT_EQ(MenuActionIndex::ids(index.actionsOfCombo(1 << 1 | 1 << 2)), QList<int>({ first, second }));
+    EXPECT_TRUE(MenuActionIndex::isEmpty(index.actionsOfCombo(1)));
+    EXPECT_EQ(MenuActionIndex::ids(index.actionsShownOn(true)), QList<int>({ second }));
+    EXPECT_EQ(MenuActionIndex::ids(index.actionsShownOn(false)), QList<int>({ first }));
+
+    index.clear();
+    EXPECT_EQ(index.count(), 0);
+    EXPECT_TRUE(MenuActionIndex::isEmpty(index.actionsOfCombo(1 << 3)));
+}
+
+TEST_F(UT_MenuActionIndex, MatchFile)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QFile file(dir.filePath("a.txt"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("text");
+    file.close();
+
+    MenuActionIndex index;
+    MenuActionIndex::Rule rule = mimeRule({ "text/plain" });
+    rule.anySuffix = false;
+    rule.suffixes = QStringList { "txt" };
+    const int text = index.append(rule);
+    const int image = index.append(mimeRule({ "image/*" }));
+
+    const QBitArray &fileActions = index.actionsOfFile(InfoFactory::create<FileInfo>(QUrl::fromLocalFile(file.fileName())));
+    EXPECT_EQ(MenuActionIndex::ids(fileActions), QList<int>({ text }));
+
+    // the suffix is not checked for directory
+    const QBitArray &dirActions = index.actionsOfFile(InfoFactory::create<FileInfo>(QUrl::fromLocalFile(dir.path())));
+    EXPECT_FALSE(dirActions.testBit(image));
+    EXPECT_TRUE(MenuActionIndex::isEmpty(index.actionsOfFile(nullptr)));
+}
+
+TEST_F(UT_MenuActionIndex, LargeSelection)
+{
+    // synthetic OEM configs with the known mime types, and a selection of files in some types
+    QStringList names;
+    for (const QMimeType &mt : db.allMimeTypes())
+        names.append(mt.name());
+    names.sort();
+    ASSERT_GT(names.size(), 100);
+
+    QRandomGenerator random(20231019);
+    auto pick = [&names, &random]() { return names.at(random.bounded(names.size())); };
+    QList<MenuActionIndex::Rule> rules;
+    for (int i = 0; i < 2000; ++i) {
+        MenuActionIndex::Rule rule;
+        const int kind = random.bounded(10);
+        if (kind > 0) {
+            rule.anyMimeType = false;
+            for (int j = random.bounded(1, 6); j > 0; --j)
+                rule.mimeTypes.append(pick());
+            // the types of a kind, such as "image/*"
+            if (kind == 1)
+                rule.mimeTypes.append(pick().section('/', 0, 0) + "/*");
+        }
+        if (kind % 3 == 0)
+            rule.excludeMimeTypes.append(pick());
+        rules.append(rule);
+    }
+
+    QList<QMimeType> selection;
+    for (int i = 0; i < 40; ++i)
+        selection.append(db.mimeTypeForName(i % 2 ? pick() : "text/plain"));
+    const int fileCount = 5000;
+
+    MenuActionIndex index;
+    for (const MenuActionIndex::Rule &rule : rules)
+        index.append(rule);
+
+    QBitArray actions(index.count(), true);
+    for (int i = 0; i < fileCount; ++i)
+        actions &= index.actionsOfMimeType(selection.at(i % selection.size()));
+
+    // the same as matching each action with each type
+    QBitArray expected(rules.size(), true);
+    for (const QMimeType &mt : selection) {
+        for (int id = 0; id < rules.size(); ++id) {
+            if (expected.testBit(id) && !isRuleMatch(rules.at(id), mt))
+                expected.clearBit(id);
+        }
+    }
+    EXPECT_EQ(actions, expected);
+
+    // the types one by one
+    for (const QMimeType &mt : selection) {
+        QBitArray single(rules.size());
+        for (int id = 0; id < rules.size(); ++id)
+            single.setBit(id, isRuleMatch(rules.at(id), mt));
+        EXPECT_EQ(index.actionsOfMimeType(mt), single) << mt.name().toStdString();
+    }
+}
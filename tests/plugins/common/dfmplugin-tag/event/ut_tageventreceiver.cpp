@@ -30,19 +30,31 @@ public:
 TEST_F(TagEventReceiverTest, handleFileCutResult)
 {
     bool isRun = false;
-    stub.set_lamda(&TagManager::removeTagsOfFiles, []() { return true; });
+    bool isRemoved = false;
+    bool canTag = true;
+    stub.set_lamda(&TagManager::removeTagsOfFiles, [&isRemoved]() { isRemoved = true; return true; });
     auto func = static_cast<bool (TagManager::*)(const QUrl &) const>(&TagManager::canTagFile);
-    stub.set_lamda(func, []() -> bool { __DBG_STUB_INVOKE__ return true; });
-    stub.set_lamda(&TagManager::addTagsForFiles, []() { return true; });
-
-    stub.set_lamda(&TagManager::getTagsByUrls, [&isRun]() {
+    stub.set_lamda(func, [&canTag]() -> bool { __DBG_STUB_INVOKE__ return canTag; });
+    stub.set_lamda(&TagManager::changeFilePaths, [&isRun]() {
         __DBG_STUB_INVOKE__
         isRun = true;
+        return true;
+    });
+    stub.set_lamda(&TagManager::getTagsByUrls, []() {
+        __DBG_STUB_INVOKE__
         return QStringList() << "red";
     });
     TagEventReceiver::instance()->handleFileCutResult(QList<QUrl>() << QUrl("/"), QList<QUrl>(), true, QString());
+    EXPECT_FALSE(isRun);
     TagEventReceiver::instance()->handleFileCutResult(QList<QUrl>() << QUrl("/"), QList<QUrl>() << QUrl("/"), true, QString());
     EXPECT_TRUE(isRun);
+    EXPECT_FALSE(isRemoved);
+
+    isRun = false;
+    canTag = false;
+    TagEventReceiver::instance()->handleFileCutResult(QList<QUrl>() << QUrl("/"), QList<QUrl>() << QUrl("/"), true, QString());
+    EXPECT_FALSE(isRun);
+    EXPECT_TRUE(isRemoved);
 }
 
 TEST_F(TagEventReceiverTest, handleHideFilesResult)
@@ -77,13 +89,10 @@ TEST_F(TagEventReceiverTest, handleFileRemoveResult)
 TEST_F(TagEventReceiverTest, handleFileRenameResult)
 {
     bool isRun = false;
-    stub.set_lamda(&TagManager::removeTagsOfFiles, []() { return true; });
-    stub.set_lamda(&TagManager::addTagsForFiles, []() { return true; });
-
-    stub.set_lamda(&TagManager::getTagsByUrls, [&isRun]() {
+    stub.set_lamda(&TagManager::changeFilePaths, [&isRun]() {
         __DBG_STUB_INVOKE__
         isRun = true;
-        return QStringList() << "red";
+        return true;
     });
     QMap<QUrl, QUrl> map;
     map.insert(QUrl("/"), QUrl("/"));
@@ -278,6 +278,23 @@ TEST_F(TagManagerTest, changeTagName)
     EXPECT_TRUE(ins->changeTagName(QString("test"), QString("red")));
 }
 
+TEST_F(TagManagerTest, changeFilePaths)
+{
+    QVariantMap sent;
+    stub.set_lamda(&TagProxyHandle::changeFilePaths, [&sent](TagProxyHandle *, const QVariantMap &value) {
+        __DBG_STUB_INVOKE__
+        sent = value;
+        return true;
+    });
+
+    EXPECT_FALSE(ins->changeFilePaths({}));
+
+    QMap<QUrl, QUrl> urls;
+    urls.insert(QUrl::fromLocalFile("/home/test/a"), QUrl::fromLocalFile("/home/test/b"));
+    EXPECT_TRUE(ins->changeFilePaths(urls));
+    EXPECT_EQ(sent.value("/home/test/a").toString(), QString("/home/test/b"));
+}
+
 TEST_F(TagManagerTest, getTagsColorName)
 {
     stub.set_lamda(&TagProxyHandle::getTagsColor, []() {
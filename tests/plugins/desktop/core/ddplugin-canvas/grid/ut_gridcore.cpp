@@ -177,6 +177,34 @@ TEST_F(TestGridCore, findVoidPos)
     EXPECT_EQ(pos.second, QPoint(0,2));
 }
 
+TEST_F(TestGridCore, nextVoidCell)
+{
+    EXPECT_EQ(core.nextVoidCell(1, 0), 0);
+    EXPECT_EQ(core.nextVoidCell(1, 1), 2);
+    EXPECT_EQ(core.nextVoidCell(1, 6), 8);
+    EXPECT_EQ(core.nextVoidCell(1, 25), -1);
+    EXPECT_EQ(core.nextVoidCell(3, 0), -1);
+
+    // the bitmap follows insert and remove.
+    core.insert(1, QPoint(0, 0), QString("0,0"));
+    EXPECT_EQ(core.nextVoidCell(1, 0), 2);
+    core.remove(1, QString("0,1"));
+    EXPECT_EQ(core.nextVoidCell(1, 0), 1);
+
+    // the bitmap is rebuilt if the surface is resized.
+    core.surfaces.insert(1, QSize(1, 2));
+    EXPECT_EQ(core.nextVoidCell(1, 0), 1);
+    core.insert(1, QPoint(0, 1), QString("new"));
+    EXPECT_EQ(core.nextVoidCell(1, 0), -1);
+
+    // more than one word.
+    core.surfaces.insert(2, QSize(10, 10));
+    for (int i = 0; i < 70; ++i)
+        core.insert(2, core.cellPos(2, i), QString::number(i));
+    EXPECT_EQ(core.nextVoidCell(2, 0), 70);
+    EXPECT_EQ(core.voidPos(2).size(), 30);
+}
+
 TEST_F(TestGridCore, position)
 {
     GridPos pos;
@@ -261,3 +289,19 @@ TEST(AppendOper, tryAppendAfter)
     EXPECT_TRUE(ao.overload.contains(QString("5")));
     EXPECT_EQ(ao.overload.size(), 1);
 }
+
+TEST(AppendOper, tryAppendAfter_outOfColumn)
+{
+    GridCore core;
+    AppendOper ao(&core);
+    ao.surfaces.insert(1, QSize(2, 2));
+
+    QStringList list;
+    list << "1" << "2" << "3";
+
+    ao.tryAppendAfter(list, 1, QPoint(0, 5));
+    EXPECT_EQ(ao.posItem[1].value(QPoint(1,0)), QString("1"));
+    EXPECT_EQ(ao.posItem[1].value(QPoint(1,1)), QString("2"));
+    EXPECT_EQ(ao.posItem[1].value(QPoint(0,0)), QString("3"));
+    EXPECT_TRUE(ao.overload.isEmpty());
+}
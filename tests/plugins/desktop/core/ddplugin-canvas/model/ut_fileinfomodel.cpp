@@ -442,6 +442,11 @@ TEST(FileInfoModelPrivate, insertData)
     });
 
     model.d->insertData(in1);
+    // inserted on next event loop.
+    EXPECT_FALSE(be);
+    EXPECT_TRUE(model.d->fileList.isEmpty());
+
+    model.d->flushPending();
     EXPECT_TRUE(be);
     EXPECT_TRUE(end);
     EXPECT_EQ(model.d->fileList.size(), 1);
@@ -450,6 +455,7 @@ TEST(FileInfoModelPrivate, insertData)
     be = false;
     end = false;
     model.d->insertData(in1);
+    model.d->flushPending();
     EXPECT_FALSE(be);
     EXPECT_FALSE(end);
     EXPECT_EQ(model.d->fileList.size(), 1);
@@ -480,6 +486,7 @@ TEST(FileInfoModelPrivate, removeData)
     });
 
     model.d->removeData(QUrl::fromLocalFile("/home/test2"));
+    model.d->flushPending();
     EXPECT_FALSE(be);
     EXPECT_FALSE(end);
     EXPECT_EQ(model.d->fileList.size(), 1);
@@ -488,11 +495,52 @@ TEST(FileInfoModelPrivate, removeData)
     be = false;
     end = false;
     model.d->removeData(in1);
+    model.d->flushPending();
     EXPECT_TRUE(be);
     EXPECT_TRUE(end);
     EXPECT_TRUE(model.d->fileList.isEmpty());
 }
 
+TEST(FileInfoModelPrivate, removeData_batch)
+{
+    FileInfoModel model;
+    QList<QUrl> urls;
+    for (int i = 0; i < 6; ++i) {
+        auto url = QUrl::fromLocalFile(QString("/home/test%0").arg(i));
+        urls.append(url);
+        model.d->fileList.append(url);
+        model.d->fileMap.insert(url, FileInfoPointer(new FileInfo(url)));
+    }
+
+    QList<QPair<int, int>> ranges;
+    QObject::connect(&model, &FileInfoModel::rowsAboutToBeRemoved, &model,
+                     [&ranges](const QModelIndex &, int first, int last){
+        ranges.append(qMakePair(first, last));
+    });
+
+    model.d->removeData(urls.at(1));
+    model.d->removeData(urls.at(2));
+    model.d->removeData(urls.at(4));
+    EXPECT_TRUE(ranges.isEmpty());
+
+    model.d->flushPending();
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges.at(0), qMakePair(4, 4));
+    EXPECT_EQ(ranges.at(1), qMakePair(1, 2));
+
+    ASSERT_EQ(model.d->fileList.size(), 3);
+    // the rows after the first removed one are indexed again
+    EXPECT_EQ(model.d->rowIndex.size(), 3);
+    EXPECT_EQ(model.d->rowIndex.value(urls.at(0)), 0);
+    EXPECT_EQ(model.d->rowIndex.value(urls.at(3)), 1);
+    EXPECT_EQ(model.d->rowIndex.value(urls.at(5)), 2);
+    EXPECT_EQ(model.d->rowOf(urls.at(0)), 0);
+    EXPECT_EQ(model.d->rowOf(urls.at(3)), 1);
+    EXPECT_EQ(model.d->rowOf(urls.at(5)), 2);
+    EXPECT_EQ(model.d->rowOf(urls.at(4)), -1);
+    EXPECT_EQ(model.index(urls.at(5)).row(), 2);
+}
+
 TEST(FileInfoModelPrivate, replaceData)
 {
     FileInfoModel model;
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "files/recentindex.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+
+using namespace dfmplugin_recent;
+
+namespace {
+const QByteArray kHead { "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<xbel version=\"1.0\">\n" };
+const QByteArray kTail { "</xbel>\n" };
+
+QByteArray bookmark(const QString &href, const QString &visited = "2023-01-01T00:00:00Z")
+{
+    return QString("  <bookmark href=\"%1\" added=\"2023-01-01T00:00:00Z\" modified=\"2023-01-01T00:00:00Z\" visited=\"%2\">\n"
+                   "    <info>\n"
+                   "      <metadata owner=\"http://freedesktop.org\">\n"
+                   "        <mime:mime-type type=\"text/plain\"/>\n"
+                   "        <bookmark:applications>\n"
+                   "          <bookmark:application name=\"dde-file-manager\" exec=\"&apos;dde-file-manager %u&apos;\" modified=\"2023-01-01T00:00:00Z\" count=\"1\"/>\n"
+                   "        </bookmark:applications>\n"
+                   "      </metadata>\n"
+                   "    </info>\n"
+                   "  </bookmark>\n")
+            .arg(href, visited)
+            .toUtf8();
+}
+}
+
+TEST(UT_RecentIndex, update)
+{
+    RecentIndex index;
+    RecentIndex::Delta delta;
+    index.update(kHead + bookmark("file:///a") + bookmark("file:///b") + kTail, &delta);
+    EXPECT_EQ(QStringList({ "file:///a", "file:///b" }), delta.added);
+    EXPECT_TRUE(delta.removed.isEmpty());
+    EXPECT_EQ(2, index.count());
+    EXPECT_EQ("2023-01-01T00:00:00Z", index.entry("file:///a").modified);
+
+    // the bookmark visited again
+    delta = RecentIndex::Delta();
+    index.update(kHead + bookmark("file:///a") + bookmark("file:///b", "2023-02-01T00:00:00Z") + kTail, &delta);
+    EXPECT_EQ(QStringList({ "file:///b" }), delta.updated);
+    EXPECT_TRUE(delta.added.isEmpty());
+    EXPECT_TRUE(delta.removed.isEmpty());
+
+    // the bookmark removed
+    delta = RecentIndex::Delta();
+    index.update(kHead + bookmark("file:///b", "2023-02-01T00:00:00Z") + kTail, &delta);
+    EXPECT_EQ(QStringList({ "file:///a" }), delta.removed);
+    EXPECT_TRUE(delta.added.isEmpty());
+    EXPECT_TRUE(delta.updated.isEmpty());
+    EXPECT_FALSE(index.contains("file:///a"));
+
+    // the same content
+    delta = RecentIndex::Delta();
+    index.update(kHead + bookmark("file:///b", "2023-02-01T00:00:00Z") + kTail, &delta);
+    EXPECT_TRUE(delta.isEmpty());
+    EXPECT_EQ(0, index.parsedSize());
+}
+
+TEST(UT_RecentIndex, unescape)
+{
+    RecentIndex index;
+    RecentIndex::Delta delta;
+    index.update(kHead + bookmark("file:///a&amp;b&#x4E2D;&#25991;") + kTail, &delta);
+    EXPECT_EQ(QStringList({ QString::fromUtf8("file:///a&b中文") }), delta.added);
+}
+
+TEST(UT_RecentIndex, updateFile)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QFile file(dir.filePath("recently-used.xbel"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(kHead + bookmark("file:///a") + kTail);
+    file.close();
+
+    RecentIndex index;
+    RecentIndex::Delta delta;
+    EXPECT_TRUE(index.update(file.fileName(), &delta));
+    EXPECT_EQ(1, delta.added.size());
+
+    // the file is not changed
+    delta = RecentIndex::Delta();
+    EXPECT_FALSE(index.update(file.fileName(), &delta));
+    EXPECT_TRUE(delta.isEmpty());
+
+    // the file is removed
+    file.remove();
+    EXPECT_TRUE(index.update(file.fileName(), &delta));
+    EXPECT_EQ(QStringList({ "file:///a" }), delta.removed);
+    EXPECT_EQ(0, index.count());
+}
+
+TEST(UT_RecentIndex, appendToLargeFile)
+{
+    const int count = 20000;
+    QByteArray bookmarks;
+    for (int i = 0; i < count; ++i)
+        bookmarks += bookmark(QString("file:///home/test/file%1").arg(i));
+
+    RecentIndex index;
+    RecentIndex::Delta delta;
+    index.update(kHead + bookmarks + kTail, &delta);
+    EXPECT_EQ(count, delta.added.size());
+    EXPECT_EQ(count, index.count());
+
+    // the bookmark appended, only the tail is parsed again
+    const QByteArray &added = bookmark("file:///home/test/new");
+    delta = RecentIndex::Delta();
+    index.update(kHead + bookmarks + added + kTail, &delta);
+    EXPECT_EQ(QStringList({ "file:///home/test/new" }), delta.added);
+    EXPECT_TRUE(delta.removed.isEmpty());
+    EXPECT_TRUE(delta.updated.isEmpty());
+    EXPECT_EQ(count + 1, index.count());
+    EXPECT_LT(index.parsedSize(), 2 * added.size());
+
+    // the last bookmark visited again
+    const int lastStart = bookmarks.size() - bookmark(QString("file:///home/test/file%1").arg(count - 1)).size();
+    const QByteArray &changed = bookmarks.left(lastStart) + bookmark(QString("file:///home/test/file%1").arg(count - 1), "2023-02-01T00:00:00Z");
+    delta = RecentIndex::Delta();
+    index.update(kHead + changed + added + kTail, &delta);
+    EXPECT_EQ(QStringList({ QString("file:///home/test/file%1").arg(count - 1) }), delta.updated);
+    EXPECT_TRUE(delta.added.isEmpty());
+    EXPECT_TRUE(delta.removed.isEmpty());
+    EXPECT_LT(index.parsedSize(), 3 * added.size());
+}
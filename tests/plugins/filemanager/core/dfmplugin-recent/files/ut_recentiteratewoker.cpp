@@ -12,8 +12,8 @@
 #include <dfm-base/interfaces/fileinfo.h>
 #include <gtest/gtest.h>
 
-#include <QPaintEvent>
-#include <QPainter>
+#include <QTemporaryDir>
+#include <QFile>
 
 DFMBASE_USE_NAMESPACE
 using namespace dfmplugin_recent;
@@ -35,46 +35,78 @@ private:
 
 TEST_F(RecentIterateWorkerTest, onRecentFileChanged)
 {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString &xbel = dir.filePath("recently-used.xbel");
+    auto writeXbel = [xbel](const QStringList &hrefs, const QString &modified = "2023-01-01T00:00:00Z") {
+        QFile file(xbel);
+        file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        file.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<xbel version=\"1.0\">\n");
+        for (const QString &href : hrefs)
+            file.write(QString("  <bookmark href=\"%1\" modified=\"%2\" visited=\"2023-01-01T00:00:00Z\">\n"
+                               "  </bookmark>\n").arg(href, modified).toUtf8());
+        file.write("</xbel>\n");
+    };
+
     stub.set_lamda(&RecentManager::init, []() {});
     stub.set_lamda(&SyncFileInfoPrivate::init, [] {});
-    int i = 1;
-    stub.set_lamda(&QXmlStreamReader::atEnd, [&i]() -> bool {
-        return i-- <= 0;
-    });
-    stub.set_lamda(&QXmlStreamReader::readNextStartElement, []() -> bool {
-        return true;
-    });
-
-    stub.set_lamda(&QString::isEmpty, []() -> bool { return false; });
-    QString str("bookmark");
-    stub.set_lamda(&QXmlStreamReader::name, [str]() -> QStringRef {
-        return QStringRef(&str);
-    });
-    stub.set_lamda(&QXmlStreamReader::isStartElement, []() -> bool { return true; });
-    stub.set_lamda(&QXmlStreamReader::hasError, []() -> bool { return false; });
     stub.set_lamda(&InfoFactory::create<FileInfo>, [] {
         return QSharedPointer<SyncFileInfo>(new SyncFileInfo(QUrl::fromLocalFile("/home")));
     });
     stub.set_lamda(VADDR(SyncFileInfo, isAttributes), [](SyncFileInfo *, const SyncFileInfo::FileIsType type) {
         return true;
     });
-    stub.set_lamda(&FileUtils::bindPathTransform, []() -> QString { return "hello/world"; });
-    stub.set_lamda(&RecentHelper::xbelPath, []() -> QString { return "123"; });
-    stub.set_lamda((bool (*)(QIODevice::OpenMode))((bool (QFile::*)(QIODevice::OpenMode)) & QFile::open), []() {
-        return true;
-    });
+    bool exists = true;
+    stub.set_lamda(VADDR(SyncFileInfo, exists), [&exists] { return exists; });
+    QString bindPath("/hello/a");
+    stub.set_lamda(&FileUtils::bindPathTransform, [&bindPath]() -> QString { return bindPath; });
+    stub.set_lamda(&RecentHelper::xbelPath, [xbel]() -> QString { return xbel; });
 
     RecentIterateWorker worker;
-    int flag = 0;
-    QObject::connect(&worker, &RecentIterateWorker::updateRecentFileInfo, [&flag](const QUrl &url, const QString originPath, qint64 readTime) {
+    int updated = 0;
+    QList<QUrl> deleted;
+    QObject::connect(&worker, &RecentIterateWorker::updateRecentFileInfo, [&updated](const QUrl &url, const QString originPath, qint64 readTime) {
         EXPECT_FALSE(url.isEmpty());
-        flag++;
+        updated++;
     });
-    QObject::connect(&worker, &RecentIterateWorker::deleteExistRecentUrls, [&flag](const QList<QUrl> &urls) {
+    QObject::connect(&worker, &RecentIterateWorker::deleteExistRecentUrls, [&deleted](const QList<QUrl> &urls) {
         EXPECT_FALSE(urls.isEmpty());
-        flag++;
+        deleted << urls;
     });
-    EXPECT_NO_FATAL_FAILURE(worker.onRecentFileChanged({ QUrl("hello/uos") }));
 
-    EXPECT_EQ(flag, 2);
+    writeXbel({ "file:///hello/a" });
+    EXPECT_NO_FATAL_FAILURE(worker.onRecentFileChanged({ QUrl("recent:///hello/uos") }));
+    EXPECT_EQ(updated, 1);
+    EXPECT_EQ(deleted, QList<QUrl>({ QUrl("recent:///hello/uos") }));
+
+    // the file is not changed, nothing is checked again
+    updated = 0;
+    deleted.clear();
+    QUrl shown = QUrl::fromLocalFile("/hello/a");
+    shown.setScheme(RecentHelper::scheme());
+    worker.onRecentFileChanged({ shown });
+    EXPECT_EQ(updated, 0);
+    EXPECT_TRUE(deleted.isEmpty());
+
+    // only the bookmark added is checked, the one removed is deleted
+    writeXbel({ "file:///hello/bb" });
+    bindPath = "/hello/bb";
+    worker.onRecentFileChanged({ shown });
+    EXPECT_EQ(updated, 1);
+    EXPECT_EQ(deleted, QList<QUrl>({ shown }));
+
+    // the bookmark rejected is checked again only when its entry changes
+    shown = QUrl::fromLocalFile("/hello/bb");
+    shown.setScheme(RecentHelper::scheme());
+    updated = 0;
+    exists = false;
+    writeXbel({ "file:///hello/bb", "file:///hello/c" });
+    worker.onRecentFileChanged({ shown });
+    EXPECT_EQ(updated, 0);
+    exists = true;
+    worker.onRecentFileChanged({ shown });
+    EXPECT_EQ(updated, 0);
+    writeXbel({ "file:///hello/bb", "file:///hello/c" }, "2023-01-02T00:00:00Z");
+    worker.onRecentFileChanged({ shown });
+    EXPECT_EQ(updated, 2);
 }
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/completionindex.h"
+
+#include <dfm-base/utils/chinese2pinyin.h>
+
+#include "stubext.h"
+
+#include <gtest/gtest.h>
+
+DPTITLEBAR_USE_NAMESPACE
+
+TEST(UT_CompletionIndex, match)
+{
+    CompletionIndex index;
+    index.append({ "Documents", "Downloads", "Desktop", "" });
+    index.append({ "docs", "Music", "Documents" });
+    EXPECT_EQ(5, index.count());
+
+    // the case is ignored, the words of same score are sorted
+    EXPECT_EQ(QStringList({ "docs", "Documents" }), index.match("doc", 10));
+    EXPECT_EQ(QStringList({ "Desktop", "docs", "Documents", "Downloads" }), index.match("D", 10));
+    EXPECT_EQ(QStringList({ "Desktop", "docs" }), index.match("d", 2));
+    EXPECT_TRUE(index.match("x", 10).isEmpty());
+    EXPECT_EQ(5, index.match("", 10).size());
+
+    // the word completed is ranked first
+    index.used("Downloads");
+    EXPECT_EQ(QStringList({ "Downloads", "Desktop" }), index.match("d", 2));
+
+    index.clear();
+    EXPECT_EQ(0, index.count());
+    EXPECT_TRUE(index.match("d", 10).isEmpty());
+}
+
+TEST(UT_CompletionIndex, history)
+{
+    CompletionIndex index;
+    index.setHistory({ "test", "text", "other", "tea" });
+    // the recent history is ranked first
+    EXPECT_EQ(QStringList({ "tea", "text", "test" }), index.match("te", 10));
+    index.used("test");
+    EXPECT_EQ("test", index.match("te", 10).first());
+}
+
+TEST(UT_CompletionIndex, pinyin)
+{
+    stub_ext::StubExt stub;
+    stub.set_lamda(&Pinyin::Chinese2Pinyin, [](const QString &words) -> QString {
+        if (words == QString::fromUtf8("文"))
+            return "wen2";
+        if (words == QString::fromUtf8("档"))
+            return "dang4";
+        return words;
+    });
+
+    EXPECT_EQ("wd.txt", CompletionIndex::pinyinInitials(QString::fromUtf8("文档.TXT")));
+    EXPECT_TRUE(CompletionIndex::pinyinInitials("Documents").isEmpty());
+
+    CompletionIndex index;
+    index.append({ QString::fromUtf8("文档"), "wd40", QString::fromUtf8("wd文") });
+    EXPECT_EQ(QStringList({ QString::fromUtf8("文档"), "wd40", QString::fromUtf8("wd文") }), index.match("wd", 10));
+    // the word matched by both keys is given once
+    EXPECT_EQ(QStringList({ QString::fromUtf8("wd文") }), index.match("wdw", 10));
+}
+
+TEST(UT_CompletionIndex, largeDirectory)
+{
+    const int count = 100000;
+    CompletionIndex index;
+    // appended in batches as the directory is traversed
+    QStringList batch;
+    for (int i = 0; i < count; ++i) {
+        batch.append(QString("file_%1").arg(i));
+        if (batch.size() == 10) {
+            index.append(batch);
+            batch.clear();
+        }
+    }
+    EXPECT_EQ(count, index.count());
+
+    // every keystroke is a binary search and a top-k of the matched range
+    const QString typed("file_9999");
+    QStringList result;
+    for (int i = 1; i <= typed.size(); ++i)
+        result = index.match(typed.left(i), 100);
+    EXPECT_EQ(QStringList({ "file_9999", "file_99990", "file_99991", "file_99992", "file_99993",
+                            "file_99994", "file_99995", "file_99996", "file_99997", "file_99998", "file_99999" }),
+              result);
+
+    // the words appended later are merged into the sorted keys
+    index.append({ "file_99999x" });
+    EXPECT_EQ(QStringList({ "file_99999", "file_99999x" }), index.match("file_99999", 100));
+}
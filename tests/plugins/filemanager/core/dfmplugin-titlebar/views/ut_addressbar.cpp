@@ -165,4 +165,20 @@ TEST(AddressBarPrivateTest, ut_onCompletionHighlighted)
     bar.d->inputIsIpAddress = false;
     bar.d->onCompletionHighlighted("test");
     EXPECT_EQ("123test", bar.text());
+
+    // only the completed tail is selected
+    bar.d->completerBaseString = "/home/";
+    bar.d->urlCompleter->setCompletionPrefix("Doc");
+    bar.d->onCompletionHighlighted("Documents");
+    EXPECT_EQ("/home/Documents", bar.text());
+    EXPECT_EQ("uments", bar.selectedText());
+
+    // the case insensitive and pinyin matches select the whole name
+    bar.d->urlCompleter->setCompletionPrefix("doc");
+    bar.d->onCompletionHighlighted("Documents");
+    EXPECT_EQ("Documents", bar.selectedText());
+    bar.d->urlCompleter->setCompletionPrefix("wd");
+    bar.d->onCompletionHighlighted("文档");
+    EXPECT_EQ("/home/文档", bar.text());
+    EXPECT_EQ("文档", bar.selectedText());
 }
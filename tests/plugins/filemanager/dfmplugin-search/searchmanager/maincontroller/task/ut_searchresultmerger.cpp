@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "searchmanager/maincontroller/task/searchresultmerger.h"
+
+#include <gtest/gtest.h>
+
+DPSEARCH_USE_NAMESPACE
+
+TEST(SearchResultMergerTest, ut_merge_dedup)
+{
+    SearchResultMerger merger(QUrl("file:///home"), "key");
+
+    EXPECT_TRUE(merger.merge({ QUrl("file:///home/key"), QUrl("file:///home/a/key") }));
+    EXPECT_FALSE(merger.merge({ QUrl("file:///home/key") }));
+    EXPECT_EQ(merger.count(), 2);
+
+    auto results = merger.takePending();
+    EXPECT_EQ(results.size(), 2);
+    EXPECT_FALSE(merger.hasPending());
+
+    EXPECT_FALSE(merger.merge({ QUrl("file:///home/a/key") }));
+    EXPECT_FALSE(merger.hasPending());
+}
+
+TEST(SearchResultMergerTest, ut_takePending_ranked)
+{
+    SearchResultMerger merger(QUrl("file:///home"), "key");
+    merger.merge({ QUrl("file:///home/content.txt"),
+                   QUrl("file:///home/monkey"),
+                   QUrl("file:///home/a/b/key"),
+                   QUrl("file:///home/keyboard"),
+                   QUrl("file:///home/my-key") });
+
+    const QList<QUrl> expected { QUrl("file:///home/a/b/key"),
+                                 QUrl("file:///home/keyboard"),
+                                 QUrl("file:///home/my-key"),
+                                 QUrl("file:///home/monkey"),
+                                 QUrl("file:///home/content.txt") };
+    EXPECT_EQ(merger.takePending(), expected);
+}
+
+TEST(SearchResultMergerTest, ut_merge_capacity)
+{
+    SearchResultMerger merger(QUrl("file:///home"), "key", 2);
+    merger.merge({ QUrl("file:///home/a"), QUrl("file:///home/b") });
+    merger.merge({ QUrl("file:///home/key"), QUrl("file:///home/c") });
+
+    auto results = merger.takePending();
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_EQ(results.first(), QUrl("file:///home/key"));
+    EXPECT_EQ(results.last(), QUrl("file:///home/a"));
+
+    EXPECT_FALSE(merger.merge({ QUrl("file:///home/key2") }));
+    EXPECT_EQ(merger.count(), 2);
+}
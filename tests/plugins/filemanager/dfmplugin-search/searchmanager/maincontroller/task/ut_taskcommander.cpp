@@ -126,11 +126,11 @@ TEST(TaskCommanderTest, ut_getResults)
     st.set_lamda(&TaskCommander::createSearcher, [] {});
 
     TaskCommander task("taskId", QUrl("file:///home"), "key");
-    task.d->resultList << QUrl("file:///home");
+    task.d->merger.merge({ QUrl("file:///home") });
     auto result = task.getResults();
 
     EXPECT_FALSE(result.isEmpty());
-    EXPECT_TRUE(task.d->resultList.isEmpty());
+    EXPECT_FALSE(task.d->merger.hasPending());
 }
 
 TEST(TaskCommanderTest, ut_start_1)
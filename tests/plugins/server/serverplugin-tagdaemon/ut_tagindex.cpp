@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "tagindex.h"
+#include "beans/filetaginfo.h"
+#include "beans/tagproperty.h"
+
+#include <gtest/gtest.h>
+
+SERVERTAGDAEMON_USE_NAMESPACE
+
+class UT_TagIndex : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        QList<QSharedPointer<TagProperty>> properties;
+        for (const auto &tag : { "red", "blue" }) {
+            QSharedPointer<TagProperty> property { new TagProperty };
+            property->setTagName(tag);
+            property->setTagColor(QString("#") + tag);
+            properties.append(property);
+        }
+
+        QList<QSharedPointer<FileTagInfo>> fileTags;
+        const QList<QPair<QString, QString>> rows { { "/home/a", "red" }, { "/home/a", "blue" },
+                                                    { "/home/dir/b", "red" }, { "/home/dir2", "blue" } };
+        for (const auto &row : rows) {
+            QSharedPointer<FileTagInfo> info { new FileTagInfo };
+            info->setFilePath(row.first);
+            info->setTagName(row.second);
+            fileTags.append(info);
+        }
+
+        index.load(properties, fileTags);
+    }
+
+    TagIndex index;
+};
+
+TEST_F(UT_TagIndex, testLookup)
+{
+    EXPECT_EQ(2, index.allTags().size());
+    EXPECT_EQ("#red", index.tagColor("red"));
+    EXPECT_FALSE(index.hasTag("green"));
+
+    EXPECT_EQ(QStringList({ "red", "blue" }), index.tagsOfFile("/home/a"));
+    EXPECT_TRUE(index.tagsOfFile("/home/none").isEmpty());
+
+    QStringList files = index.filesOfTag("red");
+    files.sort();
+    EXPECT_EQ(QStringList({ "/home/a", "/home/dir/b" }), files);
+    EXPECT_EQ(3, index.allFileTags().size());
+}
+
+TEST_F(UT_TagIndex, testFilesUnder)
+{
+    // the sibling "/home/dir2" is not under "/home/dir"
+    const QVariantMap &files = index.tagsOfFilesUnder("/home/dir");
+    EXPECT_EQ(1, files.size());
+    EXPECT_EQ(QStringList { "red" }, files.value("/home/dir/b").toStringList());
+    EXPECT_EQ(3, index.tagsOfFilesUnder("/home/").size());
+}
+
+TEST_F(UT_TagIndex, testUpdate)
+{
+    index.renameTag("red", "green");
+    EXPECT_EQ("#red", index.tagColor("green"));
+    EXPECT_EQ(QStringList({ "blue", "green" }), index.tagsOfFile("/home/a"));
+    EXPECT_TRUE(index.filesOfTag("red").isEmpty());
+
+    index.renameDir("/home/dir", "/tmp/dir");
+    EXPECT_EQ(QStringList { "green" }, index.tagsOfFile("/tmp/dir/b"));
+    EXPECT_TRUE(index.tagsOfFile("/home/dir/b").isEmpty());
+    EXPECT_EQ(QStringList { "blue" }, index.tagsOfFile("/home/dir2"));
+
+    index.removeTag("blue");
+    EXPECT_TRUE(index.tagsOfFile("/home/dir2").isEmpty());
+    EXPECT_EQ(QStringList { "green" }, index.tagsOfFile("/home/a"));
+
+    index.removeFile("/home/a");
+    EXPECT_EQ(QStringList { "/tmp/dir/b" }, index.filesOfTag("green"));
+}